@@ -1,7 +1,9 @@
 include(${CMAKE_MODULE_PATH}/IncludeDirectories_AIS.cmake)
 include(${CMAKE_MODULE_PATH}/IncludeDirectories_CFG.cmake)
 include(${CMAKE_MODULE_PATH}/IncludeDirectories_LOG.cmake)
+include(${CMAKE_MODULE_PATH}/IncludeDirectories_STORE.cmake)
+include(${CMAKE_MODULE_PATH}/IncludeDirectories_GEO.cmake)
 
 include_directories(
     ${MODULES_DIR}/communicate/include
-)
\ No newline at end of file
+)
@@ -0,0 +1,6 @@
+include(${CMAKE_MODULE_PATH}/IncludeDirectories_LOG.cmake)
+include(${CMAKE_MODULE_PATH}/IncludeDirectories_AIS.cmake)
+
+include_directories(
+    ${MODULES_DIR}/geofence/include
+)
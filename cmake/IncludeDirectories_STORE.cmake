@@ -0,0 +1,7 @@
+include(${CMAKE_MODULE_PATH}/IncludeDirectories_AIS.cmake)
+include(${CMAKE_MODULE_PATH}/IncludeDirectories_CFG.cmake)
+include(${CMAKE_MODULE_PATH}/IncludeDirectories_LOG.cmake)
+
+include_directories(
+    ${MODULES_DIR}/storage/include
+)
@@ -0,0 +1,197 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        main_replay.cpp
+Version:     1.0
+Author:      cjx
+start date:
+Description: 回放工具入口，将NMEA日志或存储分段按原始节奏回放到服务接收端口（压测用）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        按服务转发配置检查能否统计处理延迟，传入CSV列投影
+
+*****************************************************************/
+
+#include "config_manager.h"
+#include "replay_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <optional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+// 全局运行状态
+std::atomic<bool> g_running{true};
+
+/**
+ * @brief 信号处理函数
+ * @param signal 接收到的信号
+ */
+void signalHandler(int signal)
+{
+    (void)signal;
+    g_running = false;
+}
+
+void printUsage(const char *program)
+{
+    std::cout << "用法: " << program << " [选项] <输入文件或目录>..." << std::endl;
+    std::cout << "输入: NMEA文本日志（可带\\c:时间\\标签块），或二进制存储分段(.bin)" << std::endl;
+    std::cout << "选项:" << std::endl;
+    std::cout << "  --config, -c      服务配置文件，读取接收/转发端口和解析配置（默认 ais_config.yaml）" << std::endl;
+    std::cout << "  --target          服务接收地址 ip:port（默认 127.0.0.1:<subPort>）" << std::endl;
+    std::cout << "  --sink-port       服务转发端口，用于统计处理延迟（默认 <sendPort>）" << std::endl;
+    std::cout << "  --no-sink         不订阅服务输出，仅统计发送" << std::endl;
+    std::cout << "  --speed, -s       回放倍速，0表示不限速（默认 1）" << std::endl;
+    std::cout << "  --max-gap         原始数据中超过该秒数的间隔压缩为该值（默认不压缩）" << std::endl;
+    std::cout << "  --batch           单次唤醒最多连续发送的语句数（默认 256）" << std::endl;
+    std::cout << "  --report          统计输出周期，毫秒（默认 1000）" << std::endl;
+    std::cout << "  --help, -h        显示帮助信息" << std::endl;
+}
+
+/**
+ * @brief 主函数
+ * @param argc 参数个数
+ * @param argv 参数数组
+ * @return 程序退出码
+ */
+int main(int argc, char* argv[])
+{
+#if _WIN32
+    // 设置命令行使用utf-8编码
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    std::string configPath = "ais_config.yaml";
+    std::string target;
+    int sinkPort = -1;
+    ais::ReplayOptions options;
+    std::vector<std::string> inputs;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if ((arg == "--config" || arg == "-c") && hasValue) {
+                configPath = argv[++i];
+            } else if (arg == "--target" && hasValue) {
+                target = argv[++i];
+            } else if (arg == "--sink-port" && hasValue) {
+                sinkPort = std::stoi(argv[++i]);
+            } else if (arg == "--no-sink") {
+                sinkPort = 0;
+            } else if ((arg == "--speed" || arg == "-s") && hasValue) {
+                options.speed = std::stod(argv[++i]);
+            } else if (arg == "--max-gap" && hasValue) {
+                options.maxGapMs = static_cast<int64_t>(std::stod(argv[++i]) * 1000);
+            } else if (arg == "--batch" && hasValue) {
+                options.batchSize = static_cast<size_t>(std::stoul(argv[++i]));
+            } else if (arg == "--report" && hasValue) {
+                options.reportIntervalMs = std::max(std::stoi(argv[++i]), 10);
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                std::cerr << "未知参数: " << arg << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            } else {
+                inputs.push_back(arg);
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "参数格式错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (inputs.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 端口默认取服务配置，保证与被测服务一致
+    ais::ConfigManager configManager(configPath);
+    const bool configLoaded = configManager.loadConfig();
+    ais::AISParseCfg parseCfg;
+    std::string udptcpLibCfg;
+    std::optional<ais::CommunicateCfg> commCfg;
+    if (configLoaded) {
+        parseCfg = configManager.getParserConfig();
+        udptcpLibCfg = configManager.getUdpTcpCommunicateCfgPath();
+        commCfg = configManager.getCommunicateConfig();
+        if (commCfg) {
+            options.targetPort = commCfg->subPort;
+            options.sinkPort = commCfg->sendPort;
+        }
+    }
+
+    if (!target.empty()) {
+        const size_t colon = target.rfind(':');
+        if (colon == std::string::npos) {
+            options.targetIP = target;
+        } else {
+            options.targetIP = target.substr(0, colon);
+            options.targetPort = std::atoi(target.c_str() + colon + 1);
+        }
+    }
+    if (sinkPort >= 0) {
+        options.sinkPort = sinkPort;
+    }
+    // 处理延迟按服务的CSV转发记录与发送语句对应，不逐条转发CSV时无法统计
+    if (options.sinkPort > 0 && commCfg) {
+        if (commCfg->outputFormat == ais::OutputFormat::BINARY) {
+            std::cerr << "警告: 服务转发格式为BINARY，输出无法按记录拆分，不统计处理延迟" << std::endl;
+            options.sinkPort = 0;
+        } else if (commCfg->publishIntervalMs > 0) {
+            std::cerr << "警告: 服务启用了态势周期发布（publishIntervalMs），不逐条转发，不统计处理延迟" << std::endl;
+            options.sinkPort = 0;
+        } else if (commCfg->deadbandDistanceM > 0 || commCfg->anomalyAction == ais::AnomalyAction::QUARANTINE) {
+            std::cout << "提示: 服务启用了死区过滤或异常隔离，被有意丢弃的语句计入未返回/丢失" << std::endl;
+        }
+    }
+    if (options.targetPort <= 0) {
+        std::cerr << "未指定服务接收端口（--target 或配置文件 " << configPath << "）" << std::endl;
+        return 1;
+    }
+
+    ais::ReplayReader reader(inputs, parseCfg, commCfg ? commCfg->csvColumns : std::vector<std::string>());
+    if (reader.files().empty()) {
+        std::cerr << "没有可回放的输入文件" << std::endl;
+        return 1;
+    }
+
+    int ret = udptcpLibCfg.empty() ? communicate::Initialize() : communicate::Initialize(udptcpLibCfg.c_str());
+    if (ret != 0) {
+        std::cerr << "通信模块初始化失败: " << ret << std::endl;
+        return 1;
+    }
+
+    std::cout << "回放目标: " << options.targetIP << ":" << options.targetPort
+              << ", 倍速: " << (options.speed > 0 ? std::to_string(options.speed) : std::string("不限速"))
+              << ", 输入文件: " << reader.files().size() << " 个" << std::endl;
+    if (options.sinkPort > 0) {
+        std::cout << "订阅服务转发端口: " << options.sinkPort << "（统计处理延迟）" << std::endl;
+    }
+
+    ais::ReplayEngine engine(options);
+    ret = engine.run(reader, g_running);
+
+    communicate::Destroy();
+
+    if (reader.skipped() > 0) {
+        std::cout << "跳过无法识别的行/记录: " << reader.skipped() << std::endl;
+    }
+    return ret == 0 ? 0 : 1;
+}
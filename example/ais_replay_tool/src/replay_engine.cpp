@@ -0,0 +1,258 @@
+#include "replay_engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+namespace ais
+{
+
+using namespace std::chrono;
+
+namespace
+{
+
+constexpr size_t PENDING_CAPACITY = 1 << 20;    // 未返回输出的最大跟踪数
+constexpr int64_t SPIN_THRESHOLD_US = 2000;     // 距计划时刻小于该值时自旋等待
+constexpr int64_t MAX_SLEEP_US = 200000;        // 单次最长休眠，保证统计输出和退出及时
+
+void updateMax(std::atomic<uint64_t> &target, uint64_t value)
+{
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+ReplayEngine::ReplayEngine(const ReplayOptions &options)
+    : options_(options)
+{
+    options_.batchSize = std::max<size_t>(options_.batchSize, 1);
+    options_.chunkSize = std::max<size_t>(options_.chunkSize, 1);
+}
+
+int64_t ReplayEngine::steadyNowUs()
+{
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+int ReplayEngine::run(ReplayReader &reader, const std::atomic<bool> &running)
+{
+    if (options_.sinkPort > 0) {
+        int ret = communicate::SubscribeLocal("127.0.0.1", options_.sinkPort, this);
+        if (ret != 0) {
+            std::cerr << "订阅服务转发端口失败: " << options_.sinkPort << ", 错误码: " << ret << std::endl;
+            return -1;
+        }
+    }
+
+    std::vector<ReplayItem> chunk;
+    std::vector<int64_t> dueUs;
+    bool haveOrigin = false;
+    int64_t originMs = 0;       // 首条语句的原始时间
+    int64_t prevMs = 0;         // 上一条语句的原始时间
+    int64_t shiftMs = 0;        // 压缩长间隔累计减去的时间
+
+    startUs_ = lastReportUs_ = steadyNowUs();
+
+    while (running && reader.readChunk(chunk, options_.chunkSize)) {
+        // 计算本块每条语句的计划发送时刻
+        dueUs.resize(chunk.size());
+        for (size_t k = 0; k < chunk.size(); ++k) {
+            if (options_.speed <= 0.0) {
+                dueUs[k] = 0;
+                continue;
+            }
+            const int64_t timeMs = chunk[k].timeMs;
+            if (!haveOrigin) {
+                // 以首块数据读完的时刻为回放起点，不计入预读耗时
+                haveOrigin = true;
+                originMs = prevMs = timeMs;
+                startUs_ = lastReportUs_ = steadyNowUs();
+            }
+            if (options_.maxGapMs > 0 && timeMs - prevMs > options_.maxGapMs) {
+                shiftMs += timeMs - prevMs - options_.maxGapMs;
+            }
+            // 时间倒退（乱序）的语句按前一条的计划时刻立即发送
+            prevMs = std::max(prevMs, timeMs);
+            const double offsetMs = static_cast<double>(prevMs - originMs - shiftMs) / options_.speed;
+            dueUs[k] = startUs_ + static_cast<int64_t>(offsetMs * 1000.0);
+        }
+
+        size_t i = 0;
+        while (i < chunk.size() && running) {
+            int64_t now = steadyNowUs();
+            if (now - lastReportUs_ >= options_.reportIntervalMs * 1000LL) {
+                report(now, false);
+            }
+
+            const int64_t wait = dueUs[i] - now;
+            if (wait > SPIN_THRESHOLD_US) {
+                std::this_thread::sleep_for(microseconds(std::min(wait - SPIN_THRESHOLD_US / 2, MAX_SLEEP_US)));
+                continue;
+            }
+            if (wait > 0) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (dueUs[i] > 0) {
+                behindUs_.store(std::max(behindUs_.load(std::memory_order_relaxed), now - dueUs[i]),
+                                std::memory_order_relaxed);
+            }
+
+            // 连续发送所有已到期的语句
+            size_t count = 1;
+            while (i + count < chunk.size() && count < options_.batchSize && dueUs[i + count] <= now) {
+                count++;
+            }
+            sendBatch(&chunk[i], count);
+            i += count;
+        }
+    }
+
+    // 等待服务处理完在途数据
+    if (options_.sinkPort > 0) {
+        const int64_t deadline = steadyNowUs() + options_.drainTimeoutMs * 1000LL;
+        while (running && received_.load() < expected_.load() && steadyNowUs() < deadline) {
+            std::this_thread::sleep_for(milliseconds(10));
+        }
+    }
+
+    report(steadyNowUs(), true);
+    return 0;
+}
+
+void ReplayEngine::sendBatch(const ReplayItem *items, size_t count)
+{
+    const int64_t now = steadyNowUs();
+    for (size_t k = 0; k < count; ++k) {
+        const ReplayItem &item = items[k];
+        // 带结尾'\0'发送，接收端按C字符串处理
+        if (communicate::SendGeneralMessage(options_.targetIP.c_str(), options_.targetPort,
+                                            item.sentence.c_str(), item.sentence.size() + 1) != 0) {
+            sendFailed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        sent_.fetch_add(1, std::memory_order_relaxed);
+
+        // 服务有意不转发的语句不会返回，跟踪数达到上限后不再记录新的预期输出
+        if (item.expectOutput && options_.sinkPort > 0) {
+            std::lock_guard<std::mutex> lock(pendingMutex_);
+            if (pendingCount_ < PENDING_CAPACITY) {
+                pendingSendUs_[item.outputKey].push_back(now);
+                pendingCount_++;
+                expected_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+int ReplayEngine::handleMsg(std::shared_ptr<void> msg)
+{
+    const int64_t now = steadyNowUs();
+    const char *text = static_cast<const char *>(msg.get());
+    if (!text) {
+        return 0;
+    }
+
+    const char *line = text;
+    for (const char *p = text;; ++p) {
+        if (*p == '\n' || *p == '\0') {
+            if (p > line) {
+                matchOutput(line, static_cast<size_t>(p - line), now);
+            }
+            if (*p == '\0') {
+                break;
+            }
+            line = p + 1;
+        }
+    }
+    return 0;
+}
+
+void ReplayEngine::matchOutput(const char *record, size_t size, int64_t nowUs)
+{
+    const uint64_t key = ReplayReader::outputKey(record, size);
+    int64_t sendUs = 0;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        auto it = pendingSendUs_.find(key);
+        if (it == pendingSendUs_.end()) {
+            unmatched_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        sendUs = it->second.front();
+        it->second.pop_front();
+        if (it->second.empty()) {
+            pendingSendUs_.erase(it);
+        }
+        pendingCount_--;
+    }
+
+    received_.fetch_add(1, std::memory_order_relaxed);
+    if (nowUs >= sendUs) {
+        const uint64_t lag = static_cast<uint64_t>(nowUs - sendUs);
+        lagSumUs_.fetch_add(lag, std::memory_order_relaxed);
+        lagCount_.fetch_add(1, std::memory_order_relaxed);
+        updateMax(lagMaxUs_, lag);
+    }
+}
+
+ReplayStats ReplayEngine::getStats() const
+{
+    ReplayStats stats;
+    stats.sent = sent_.load();
+    stats.sendFailed = sendFailed_.load();
+    stats.expected = expected_.load();
+    stats.received = received_.load();
+    stats.unmatched = unmatched_.load();
+    stats.lagSamples = lagCount_.load();
+    stats.lagAvgMs = stats.lagSamples ? lagSumUs_.load() / 1000.0 / stats.lagSamples : 0.0;
+    stats.lagMaxMs = lagMaxUs_.load() / 1000.0;
+    stats.behindMs = behindUs_.load() / 1000.0;
+    stats.elapsedSec = startUs_ ? (steadyNowUs() - startUs_) / 1e6 : 0.0;
+    return stats;
+}
+
+void ReplayEngine::report(int64_t nowUs, bool final)
+{
+    const ReplayStats stats = getStats();
+    const double intervalSec = std::max((nowUs - lastReportUs_) / 1e6, 1e-6);
+    const double rate = final ? stats.sent / std::max(stats.elapsedSec, 1e-6)
+                              : (stats.sent - lastSent_) / intervalSec;
+
+    char line[512];
+    std::snprintf(line, sizeof(line), "%s 发送 %llu 条, 速率 %.0f 条/秒, 发送失败 %llu, 最大落后 %.1f ms",
+                  final ? "[回放完成]" : "[回放中]",
+                  static_cast<unsigned long long>(stats.sent), rate,
+                  static_cast<unsigned long long>(stats.sendFailed), stats.behindMs);
+    std::cout << line;
+
+    if (options_.sinkPort > 0) {
+        const uint64_t missing = stats.expected > stats.received ? stats.expected - stats.received : 0;
+        std::snprintf(line, sizeof(line), ", 服务输出 %llu/%llu (%s %llu, 输出速率 %.0f 条/秒), 处理延迟 平均 %.2f ms / 最大 %.2f ms",
+                      static_cast<unsigned long long>(stats.received),
+                      static_cast<unsigned long long>(stats.expected),
+                      final ? "丢失" : "未返回", static_cast<unsigned long long>(missing),
+                      final ? stats.received / std::max(stats.elapsedSec, 1e-6)
+                            : (stats.received - lastReceived_) / intervalSec,
+                      stats.lagAvgMs, stats.lagMaxMs);
+        std::cout << line;
+        if (stats.unmatched > 0) {
+            std::snprintf(line, sizeof(line), ", 其他输出 %llu", static_cast<unsigned long long>(stats.unmatched));
+            std::cout << line;
+        }
+    }
+    std::cout << std::endl;
+
+    lastReportUs_ = nowUs;
+    lastSent_ = stats.sent;
+    lastReceived_ = stats.received;
+}
+
+} // namespace ais
@@ -0,0 +1,139 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        replay_engine.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 按原始时间间隔（可缩放）向服务接收端口回放AIS数据，统计速率、丢失与处理延迟
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        服务输出按行计数，兼容合批发送的数据报
+3             2026-10-18     cjx        服务输出按记录内容与发送的语句对应，不再按到达顺序配对
+
+*****************************************************************/
+
+#ifndef AIS_REPLAY_ENGINE_H
+#define AIS_REPLAY_ENGINE_H
+
+#include "udp-tcp-communicate/communicate_api.h"
+
+#include "replay_reader.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ais
+{
+
+/**
+ * @brief 回放参数
+ */
+struct ReplayOptions
+{
+    std::string targetIP = "127.0.0.1"; // 服务接收地址
+    int targetPort = 0;                 // 服务接收端口（CommunicateCfg::subPort）
+    int sinkPort = 0;                   // 服务转发端口（CommunicateCfg::sendPort），0表示不统计处理延迟
+                                        // （服务须为CSV逐条转发，二进制输出无法按记录拆分）
+    double speed = 1.0;                 // 回放倍速，0表示不限速
+    int64_t maxGapMs = 0;               // 原始数据中超过该值的时间间隔压缩为该值，0表示不压缩
+    size_t batchSize = 256;             // 单次唤醒最多连续发送的语句数
+    size_t chunkSize = 65536;           // 预读块大小（语句数）
+    int reportIntervalMs = 1000;        // 统计输出周期
+    int drainTimeoutMs = 2000;          // 发送结束后等待服务输出的时间
+};
+
+/**
+ * @brief 回放统计
+ */
+struct ReplayStats
+{
+    uint64_t sent = 0;          // 成功发送的语句数
+    uint64_t sendFailed = 0;    // 发送失败（本端丢弃）的语句数
+    uint64_t expected = 0;      // 预期产生服务输出的语句数
+    uint64_t received = 0;      // 收到的与发送语句对应的服务输出数
+    uint64_t unmatched = 0;     // 收到的其他输出数（告警/围栏/异常事件、表头等）
+    uint64_t lagSamples = 0;    // 处理延迟样本数
+    double lagAvgMs = 0.0;      // 平均处理延迟
+    double lagMaxMs = 0.0;      // 最大处理延迟
+    double behindMs = 0.0;      // 发送落后于计划时间的最大值（发送端跟不上时增大）
+    double elapsedSec = 0.0;    // 回放耗时
+};
+
+/**
+ * @brief 回放引擎
+ *
+ * 以首条语句时间为起点，语句的计划发送时刻 = 开始时刻 + (原始时间 - 起点) / speed。
+ * 发送循环每次唤醒把已到期的语句（至多batchSize条）连续发出，
+ * 距下一条较远时休眠、临近时让出CPU自旋，避免sleep粒度造成的节奏抖动；
+ * 发送落后时不补偿休眠，直接追赶。
+ *
+ * 处理延迟：订阅服务的转发端口，按输出记录的内容键（见ReplayReader::outputKey）找到对应的
+ * 发送语句，两者时间差即为处理延迟；内容相同的语句按发送顺序依次对应。服务额外发出的事件记录
+ * 不对应任何语句，计为unmatched；服务有意不转发的语句（死区抑制、异常隔离）计入未返回，不影响延迟。
+ */
+class ReplayEngine : public communicate::SubscribebBase
+{
+public:
+    explicit ReplayEngine(const ReplayOptions &options);
+
+    /**
+     * @brief 执行回放（阻塞直到数据发送完毕或running置为false）
+     * @param reader 数据源
+     * @param running 运行标志
+     * @return 成功返回0，通信初始化失败返回错误码
+     */
+    int run(ReplayReader &reader, const std::atomic<bool> &running);
+
+    /**
+     * @brief 服务转发输出回调（通信库接收线程）
+     *
+     * 服务端合批发送时一个数据报含多条以'\n'分隔的CSV记录，逐条按内容对应发送语句
+     */
+    int handleMsg(std::shared_ptr<void> msg) override;
+
+    /**
+     * @brief 获取累计统计
+     */
+    ReplayStats getStats() const;
+
+private:
+    static int64_t steadyNowUs();
+
+    void sendBatch(const ReplayItem *items, size_t count);
+    void matchOutput(const char *record, size_t size, int64_t nowUs);
+    void report(int64_t nowUs, bool final);
+
+    ReplayOptions options_;
+    int64_t startUs_ = 0;
+
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> sendFailed_{0};
+    std::atomic<uint64_t> expected_{0};
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> unmatched_{0};
+    std::atomic<uint64_t> lagSumUs_{0};
+    std::atomic<uint64_t> lagCount_{0};
+    std::atomic<uint64_t> lagMaxUs_{0};
+    std::atomic<int64_t> behindUs_{0};
+
+    // 未返回的预期输出：内容键 -> 发送时刻（发送线程写入，接收线程取出）
+    std::mutex pendingMutex_;
+    std::unordered_map<uint64_t, std::deque<int64_t>> pendingSendUs_;
+    size_t pendingCount_ = 0;
+
+    // 上次统计输出时的计数，用于计算区间速率
+    int64_t lastReportUs_ = 0;
+    uint64_t lastSent_ = 0;
+    uint64_t lastReceived_ = 0;
+};
+
+} // namespace ais
+
+#endif // AIS_REPLAY_ENGINE_H
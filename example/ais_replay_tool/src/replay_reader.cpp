@@ -0,0 +1,204 @@
+#include "replay_reader.h"
+
+#include "utils/binary_codec.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <string_view>
+
+namespace ais
+{
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/**
+ * @brief 解析标签块中的时间字段（c:<unix秒或毫秒>）
+ * @param block 标签块内容（不含首尾反斜杠和校验）
+ * @param timeMs [out] 时间（毫秒）
+ * @return 是否包含时间字段
+ */
+bool parseTagTime(const std::string &block, int64_t &timeMs)
+{
+    size_t pos = 0;
+    while (pos < block.size()) {
+        size_t end = block.find(',', pos);
+        if (end == std::string::npos) {
+            end = block.size();
+        }
+        if (end - pos > 2 && block[pos] == 'c' && block[pos + 1] == ':') {
+            char *stop = nullptr;
+            const long long value = std::strtoll(block.c_str() + pos + 2, &stop, 10);
+            if (stop != block.c_str() + pos + 2) {
+                timeMs = value > 100000000000LL ? value : value * 1000;
+                return true;
+            }
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+ReplayReader::ReplayReader(const std::vector<std::string> &paths, const AISParseCfg &parseCfg,
+                           const std::vector<std::string> &csvColumns)
+    : parser_(parseCfg)
+{
+    csvWriter_.setProjection(csvColumns);
+    for (const auto &path : paths) {
+        std::error_code ec;
+        if (!fs::is_directory(path, ec)) {
+            files_.push_back(path);
+            continue;
+        }
+
+        std::vector<std::string> entries;
+        for (fs::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+            const std::string ext = it->path().extension().string();
+            // 跳过分段的sidecar索引文件
+            if (it->is_regular_file(ec) && ext != ".idx" && ext != ".qidx" && ext != ".tmp") {
+                entries.push_back(it->path().string());
+            }
+        }
+        std::sort(entries.begin(), entries.end());
+        files_.insert(files_.end(), entries.begin(), entries.end());
+    }
+}
+
+bool ReplayReader::openNext()
+{
+    while (fileIndex_ < files_.size()) {
+        const std::string &path = files_[fileIndex_++];
+        in_.close();
+        in_.clear();
+        segment_.close();
+
+        // 二进制分段以文件头魔数识别，否则按文本读取
+        binary_ = segment_.open(path);
+        if (binary_) {
+            return true;
+        }
+        in_.open(path, std::ios::binary);
+        if (in_.is_open()) {
+            return true;
+        }
+    }
+    in_.close();
+    segment_.close();
+    binary_ = false;
+    return false;
+}
+
+bool ReplayReader::readChunk(std::vector<ReplayItem> &out, size_t maxItems)
+{
+    out.clear();
+    if (!in_.is_open() && !binary_ && !openNext()) {
+        return false;
+    }
+
+    ReplayItem item;
+    while (out.size() < maxItems) {
+        const bool ok = binary_ ? readBinaryRecord(out) : readTextLine(item);
+        if (!ok) {
+            if (!openNext()) {
+                break;
+            }
+            continue;
+        }
+        if (!binary_) {
+            out.push_back(std::move(item));
+        }
+    }
+    return !out.empty();
+}
+
+bool ReplayReader::readTextLine(ReplayItem &item)
+{
+    while (std::getline(in_, line_)) {
+        if (!line_.empty() && line_.back() == '\r') {
+            line_.pop_back();
+        }
+
+        size_t start = 0;
+        if (!line_.empty() && line_[0] == '\\') {
+            const size_t close = line_.find('\\', 1);
+            if (close != std::string::npos) {
+                std::string block = line_.substr(1, close - 1);
+                const size_t star = block.find('*');
+                if (star != std::string::npos) {
+                    block.resize(star);
+                }
+                parseTagTime(block, lastTimeMs_);
+                start = close + 1;
+            }
+        }
+
+        start = line_.find_first_of("!$", start);
+        if (start == std::string::npos) {
+            if (!line_.empty()) {
+                skipped_++;
+            }
+            continue;
+        }
+
+        item.timeMs = lastTimeMs_;
+        item.sentence.assign(line_, start, std::string::npos);
+        preparse(item);
+        return true;
+    }
+    return false;
+}
+
+bool ReplayReader::readBinaryRecord(std::vector<ReplayItem> &out)
+{
+    // 记录头损坏时无法定位下一帧，放弃该分段剩余部分
+    int64_t timeMs;
+    const uint8_t *record;
+    size_t size;
+    if (!segment_.next(timeMs, record, size)) {
+        return false;
+    }
+    lastTimeMs_ = timeMs;
+
+    auto msg = BinaryCodec::deserialize(record, size);
+    std::vector<std::string> sentences;
+    if (msg) {
+        sentences = encoder_.encode(*msg);
+    }
+    if (sentences.empty()) {
+        skipped_++;
+        return true;
+    }
+
+    // 重新编码的语句同样预解析，预期输出以服务解析NMEA的结果为准
+    for (auto &sentence : sentences) {
+        ReplayItem item;
+        item.timeMs = timeMs;
+        item.sentence = std::move(sentence);
+        preparse(item);
+        out.push_back(std::move(item));
+    }
+    return true;
+}
+
+void ReplayReader::preparse(ReplayItem &item)
+{
+    auto msg = parser_.parse(item.sentence);
+    item.expectOutput = msg != nullptr;
+    item.outputKey = 0;
+    if (msg) {
+        const std::string &record = csvWriter_.write(*msg);
+        item.outputKey = outputKey(record.data(), record.size());
+    }
+}
+
+uint64_t ReplayReader::outputKey(const char *record, size_t size)
+{
+    return std::hash<std::string_view>()(std::string_view(record, size));
+}
+
+} // namespace ais
@@ -0,0 +1,112 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        replay_reader.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 回放数据源读取（NMEA日志 / 二进制存储分段）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        预计算服务输出记录的内容键；二进制分段改用存储模块的BinarySegmentReader读取
+
+*****************************************************************/
+
+#ifndef AIS_REPLAY_READER_H
+#define AIS_REPLAY_READER_H
+
+#include "ais_encoder.h"
+#include "ais_parser.h"
+#include "segment_storage.h"
+#include "utils/csv_writer.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 一条待回放的NMEA语句
+ */
+struct ReplayItem
+{
+    int64_t timeMs = 0;         // 原始接收时间（无时间信息时沿用上一条）
+    std::string sentence;       // 去除标签块后的NMEA语句
+    bool expectOutput = false;  // 服务处理后是否会产生一条转发输出（用于统计处理延迟）
+    uint64_t outputKey = 0;     // 预期转发记录（CSV行）的内容键，见ReplayReader::outputKey
+};
+
+/**
+ * @brief 回放数据读取器
+ *
+ * 按文件名顺序依次读取输入文件，按块预读以免读文件的开销影响发送节奏：
+ * - 文本文件：每行一条NMEA语句，可带IEC 61162-450标签块（\c:<unix时间>,...*hh\），
+ *   c字段按秒或毫秒（大于1e11时）解释；行首的其他前缀会被忽略
+ * - .bin文件：SegmentStorage写出的二进制分段（由BinarySegmentReader读取），记录重新编码为NMEA语句，
+ *   时间取分段中的接收时间
+ *
+ * 每条语句用与服务一致的解析配置预解析，能解析出消息的语句按服务的CSV序列化（含列投影）
+ * 计算预期转发记录的内容键，回放引擎据此把服务输出与发送的语句对应起来
+ */
+class ReplayReader
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param paths 输入文件或目录（目录下的文件按名称排序）
+     * @param parseCfg 预解析配置（应与服务端一致）
+     */
+    /**
+     * @param csvColumns 服务的转发CSV列投影（CommunicateCfg::csvColumns）
+     */
+    explicit ReplayReader(const std::vector<std::string> &paths,
+                          const AISParseCfg &parseCfg = AISParseCfg(),
+                          const std::vector<std::string> &csvColumns = std::vector<std::string>());
+
+    /**
+     * @brief 读取下一块数据
+     * @param out [out] 读出的语句（会先清空）
+     * @param maxItems 最多读取的语句数
+     * @return 读到数据返回true，全部读完返回false
+     */
+    bool readChunk(std::vector<ReplayItem> &out, size_t maxItems);
+
+    const std::vector<std::string> &files() const { return files_; }
+
+    // 被跳过的行/记录数（无法识别的行、无法编码的记录）
+    uint64_t skipped() const { return skipped_; }
+
+    /**
+     * @brief 转发记录的内容键（一条CSV记录，不含换行和结尾'\0'）
+     */
+    static uint64_t outputKey(const char *record, size_t size);
+
+private:
+    bool openNext();
+    bool readTextLine(ReplayItem &item);
+    bool readBinaryRecord(std::vector<ReplayItem> &out);
+    void preparse(ReplayItem &item);
+
+    std::vector<std::string> files_;
+    size_t fileIndex_ = 0;
+    std::ifstream in_;
+    BinarySegmentReader segment_;
+    bool binary_ = false;
+
+    std::string line_;
+    int64_t lastTimeMs_ = 0;
+    uint64_t skipped_ = 0;
+
+    AISParser parser_;          // 预解析，判断语句是否会产生输出
+    CsvWriter csvWriter_;       // 按服务的列投影生成预期转发记录
+    AISEncoder encoder_;        // 二进制记录重新编码为NMEA
+};
+
+} // namespace ais
+
+#endif // AIS_REPLAY_READER_H
@@ -334,6 +334,11 @@ int main(int argc, char* argv[])
         std::cout << "标准版AIS通信服务已初始化" << std::endl;
     }
     
+    // 启用本地存储（后台线程写入）
+    if (g_aisService->enableStorage(saveCfg) != 0) {
+        std::cerr << "本地存储启动失败，继续运行但不保存数据" << std::endl;
+    }
+
     // 初始化AIS通信服务
     int initResult = g_aisService->initialize(commCfg, udptcpLibCfg);
     if (initResult != 0) {
@@ -423,6 +428,9 @@ int main(int argc, char* argv[])
     if (g_aisService) {
         g_aisService->clearShipInfo();
         std::cout << "船舶信息已清空" << std::endl;
+
+        // 停止接收并写出剩余的存储数据
+        g_aisService->destroy();
     }
     
     std::cout << "服务已停止" << std::endl;
@@ -10,6 +10,7 @@ Version history
 
 [序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
 1             2025-9-24      cjx        create
+2             2026-10-18     cjx        多部分重组器改为成员并加锁，支持多线程并发解析
 
 *****************************************************************/
 
@@ -17,6 +18,7 @@ Version history
 #define AIS_PARSER_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -26,10 +28,14 @@ Version history
 
 namespace ais {
 
+class MultipartReassembler;
+
 /**
  * @brief AIS主解析器类
  * 
  * 提供完整的AIS消息解析功能，仅负责解析不涉及存储和日志
+ * 
+ * @note parse()可被多个线程并发调用，多部分消息的重组状态由本实例持有并加锁保护
  */
 class AISParser
 {
@@ -39,6 +45,10 @@ public:
      * @param cfg 配置
      */
     explicit AISParser(const AISParseCfg &cfg = AISParseCfg());
+    ~AISParser();
+
+    AISParser(const AISParser &) = delete;
+    AISParser &operator=(const AISParser &) = delete;
 
     /**
      * @brief 解析单个NMEA语句
@@ -69,6 +79,9 @@ public:
 private:
     AISParseCfg config_; // 解析器配置
 
+    mutable std::mutex reassemblerMutex_;                     // 保护多部分重组状态
+    std::unique_ptr<MultipartReassembler> reassembler_;       // 多部分消息重组器
+
     /**
      * @brief 解析二进制负载
      * @param binary 二进制负载
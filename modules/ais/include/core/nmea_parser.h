@@ -10,18 +10,32 @@ Version history
 
 [序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
 1            2025-09-25       cjx         create
+2            2026-10-18       cjx         增加不分配内存的语句头快速解析peekHeader
 
 *****************************************************************/
 
 #ifndef AIS_NMEA_PARSER_H
 #define AIS_NMEA_PARSER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace ais
 {
 
+/**
+ * @brief NMEA语句头快速解析结果（用于分发路由，不做完整解析）
+ */
+struct NMEAHeader
+{
+    int fragmentCount = 1;      // 分片总数
+    int fragmentNumber = 1;     // 当前分片号，从1开始
+    int sequenceId = -1;        // 多部分消息序号（0-9），缺省为-1
+    char channel = '\0';        // 信道（A/B），缺省为'\0'
+    uint32_t mmsi = 0;          // 仅首个分片可取得，否则为0
+};
+
 /**
  * @brief NMEA解析工具类
  * 
@@ -72,6 +86,14 @@ public:
      */
     static std::string getMessageId(const std::string &nmea);
 
+    /**
+     * @brief 快速解析语句头字段和负载中的MMSI，不校验、不分配内存
+     * @param nmea NMEA语句（以'\0'结尾）
+     * @param header [out] 解析结果
+     * @return 字段完整返回true
+     */
+    static bool peekHeader(const char *nmea, NMEAHeader &header);
+
 private:
     /**
      * @brief 分割字符串
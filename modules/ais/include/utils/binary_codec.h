@@ -0,0 +1,112 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        binary_codec.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 解码后消息的定长二进制记录格式（小端）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_BINARY_CODEC_H
+#define AIS_BINARY_CODEC_H
+
+#include "messages/message.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ais
+{
+
+/**
+ * @brief 二进制记录族
+ *
+ * 同一族内记录长度固定，记录头中的消息类型字段区分族内具体类型
+ */
+enum class BinaryRecordFamily : uint8_t
+{
+    UNSUPPORTED = 0,        // 不支持二进制编码的消息类型
+    CLASS_A_POSITION = 1,   // 类型1/2/3
+    CLASS_B_POSITION = 2,   // 类型18
+    CLASS_B_EXTENDED = 3,   // 类型19（位置+静态信息）
+    STATIC_VOYAGE = 4,      // 类型5
+    STATIC_DATA = 5,        // 类型24
+    BASE_STATION = 6,       // 类型4/11
+    AID_TO_NAVIGATION = 7   // 类型21
+};
+
+/**
+ * @brief 定长二进制记录编解码器
+ *
+ * 记录头（8字节）：魔数(1) + 版本(1) + 记录族(1) + 消息类型(1) + MMSI(4)
+ * 记录体按族定长，多字节整数均为小端；经纬度以1/10000分(1/600000度)的
+ * 有符号整数保存，与AIS原始报文精度一致，可无损还原解析结果
+ */
+class BinaryCodec
+{
+public:
+    static constexpr uint8_t MAGIC = 0xA5;          // 记录魔数
+    static constexpr uint8_t VERSION = 1;           // 格式版本号
+    static constexpr size_t HEADER_SIZE = 8;        // 记录头长度
+    static constexpr size_t MAX_RECORD_SIZE = 96;   // 最大记录长度
+    static constexpr double COORD_SCALE = 600000.0; // 经纬度缩放系数
+
+    /**
+     * @brief 获取消息类型对应的记录族
+     * @param type 消息类型
+     * @return 记录族，不支持时返回UNSUPPORTED
+     */
+    static BinaryRecordFamily familyOf(AISMessageType type);
+
+    /**
+     * @brief 获取记录族的定长记录长度（含记录头）
+     * @param family 记录族
+     * @return 记录长度，不支持时返回0
+     */
+    static size_t recordSize(BinaryRecordFamily family);
+
+    /**
+     * @brief 将消息编码到外部缓冲区
+     * @param msg AIS消息
+     * @param out 输出缓冲区
+     * @param capacity 缓冲区容量
+     * @return 写入字节数，消息类型不支持或容量不足时返回0
+     */
+    static size_t serialize(const AISMessage &msg, uint8_t *out, size_t capacity);
+
+    /**
+     * @brief 将消息编码后追加到字符串缓冲区
+     * @param msg AIS消息
+     * @param out 输出缓冲区
+     * @return 是否编码成功
+     */
+    static bool serialize(const AISMessage &msg, std::string &out);
+
+    /**
+     * @brief 从缓冲区解码一条记录
+     * @param data 输入数据
+     * @param size 输入数据长度
+     * @param consumed [out] 可选，返回本条记录占用的字节数
+     * @return 解码后的消息，数据无效或不完整时返回nullptr
+     */
+    static std::unique_ptr<AISMessage> deserialize(const uint8_t *data, size_t size,
+                                                   size_t *consumed = nullptr);
+
+    /**
+     * @brief 经纬度与定点整数互转
+     */
+    static int32_t encodeCoord(double degrees);
+    static double decodeCoord(int32_t value);
+};
+
+} // namespace ais
+
+#endif // AIS_BINARY_CODEC_H
@@ -0,0 +1,141 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        bounded_queue.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 有界无锁多生产者多消费者队列
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_BOUNDED_QUEUE_H
+#define AIS_BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace ais
+{
+
+/**
+ * @brief 有界无锁MPMC队列（Vyukov环形队列）
+ *
+ * 每个槽位带序号，生产者/消费者仅通过CAS竞争读写位置，不使用互斥锁；
+ * 队列满时tryPush立即返回false，由调用方决定丢弃或重试，保证入队方永不阻塞
+ *
+ * @tparam T 元素类型，需可默认构造和移动
+ */
+template <class T>
+class BoundedQueue
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 容量，向上取整为2的幂（最小2）
+     */
+    explicit BoundedQueue(size_t capacity)
+    {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        cells_.reset(new Cell[cap]);
+        for (size_t i = 0; i < cap; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /**
+     * @brief 入队，队列满时返回false
+     */
+    template <class U>
+    bool tryPush(U &&value)
+    {
+        Cell *cell;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::forward<U>(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 出队，队列空时返回false
+     */
+    bool tryPop(T &value)
+    {
+        Cell *cell;
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->data);
+        cell->data = T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 近似元素个数（并发下仅供统计）
+     */
+    size_t sizeApprox() const
+    {
+        size_t head = dequeuePos_.load(std::memory_order_relaxed);
+        size_t tail = enqueuePos_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(CACHE_LINE) std::atomic<size_t> enqueuePos_{0};
+    alignas(CACHE_LINE) std::atomic<size_t> dequeuePos_{0};
+};
+
+} // namespace ais
+
+#endif // AIS_BOUNDED_QUEUE_H
@@ -0,0 +1,147 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        csv_writer.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 按消息类型固定列结构的CSV序列化器
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        公开引号转义接口appendQuoted
+
+*****************************************************************/
+
+#ifndef AIS_CSV_WRITER_H
+#define AIS_CSV_WRITER_H
+
+#include "messages/message.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ais
+{
+
+class CsvWriter;
+
+/**
+ * @brief CSV列描述
+ *
+ * 每种消息类型对应一组固定顺序的列，列名与toJson()中的字段名保持一致
+ */
+struct CsvColumn
+{
+    const char *name;                                       // 列名
+    void (*write)(CsvWriter &writer, const AISMessage &msg); // 列值写出函数
+};
+
+/**
+ * @brief AIS消息CSV序列化器
+ *
+ * 使用std::to_chars写入可复用的内部缓冲区，避免ostringstream的格式化开销；
+ * 每种消息类型有稳定的列结构(schema)，可在文件或数据流开头输出一次表头；
+ * 支持按列名投影，投影后所有类型共用同一列布局，缺失字段输出为空
+ *
+ * @note 非线程安全，每个线程使用独立实例
+ */
+class CsvWriter
+{
+public:
+    static constexpr int SCHEMA_VERSION = 1;    // 列结构版本号，列定义变更时递增
+
+    /**
+     * @brief 构造函数
+     * @param delimiter 字段分隔符
+     */
+    explicit CsvWriter(char delimiter = ',');
+
+    /**
+     * @brief 获取指定消息类型的完整列结构
+     * @param type 消息类型
+     * @return 列描述集合
+     */
+    static const std::vector<CsvColumn> &schema(AISMessageType type);
+
+    /**
+     * @brief 获取指定消息类型的列名
+     * @param type 消息类型
+     * @return 列名集合
+     */
+    static std::vector<std::string> columnNames(AISMessageType type);
+
+    /**
+     * @brief 设置列投影，只输出指定列(按给定顺序)
+     * @param columns 列名集合，为空表示取消投影
+     */
+    void setProjection(const std::vector<std::string> &columns);
+
+    /**
+     * @brief 是否启用了列投影
+     */
+    bool hasProjection() const { return !projection_.empty(); }
+
+    /**
+     * @brief 获取表头行（不含换行符）
+     * @param type 消息类型；启用投影时所有类型表头相同
+     * @return 表头字符串
+     */
+    std::string header(AISMessageType type) const;
+
+    /**
+     * @brief 获取全部消息类型的表头说明，每行格式为 "#<类型>,<列名>,..."
+     * @note 适合在文件或数据流开头输出一次，首行为 "#schema,<版本号>"
+     * @return 表头说明字符串（每行以换行符结尾）
+     */
+    std::string schemaPreamble() const;
+
+    /**
+     * @brief 将消息序列化到内部缓冲区（覆盖上一次结果）
+     * @param msg AIS消息
+     * @return 内部缓冲区引用，下一次调用前有效
+     */
+    const std::string &write(const AISMessage &msg);
+
+    /**
+     * @brief 将消息序列化后追加到外部缓冲区（不追加换行符）
+     * @param msg AIS消息
+     * @param out 输出缓冲区
+     */
+    void append(const AISMessage &msg, std::string &out);
+
+    /************* 列值写出接口（供列描述使用） *************/
+    void appendValue(int value);
+    void appendValue(uint32_t value);
+    void appendValue(uint64_t value);
+    void appendValue(bool value);
+    void appendValue(double value, int precision);
+    void appendValue(const std::string &value);
+    void appendValue(AISMessageType value);
+
+    /**
+     * @brief 追加加引号的字符串字段，内部引号按CSV规则转义为两个引号
+     * @param out 输出缓冲区
+     * @param value 字段值
+     */
+    static void appendQuoted(std::string &out, std::string_view value);
+
+private:
+    static constexpr size_t TYPE_SLOTS = 28;    // 消息类型0-27
+
+    char delimiter_;                                        // 字段分隔符
+    std::string buffer_;                                    // 复用的输出缓冲区
+    std::string *out_ = nullptr;                            // 当前写入目标
+    std::vector<std::string> projection_;                   // 投影列名
+    std::array<std::vector<int>, TYPE_SLOTS> projectedIdx_; // 各类型投影列在schema中的下标(-1表示缺失)
+
+    static size_t slotOf(AISMessageType type);
+};
+
+} // namespace ais
+
+#endif // AIS_CSV_WRITER_H
@@ -0,0 +1,97 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        dead_reckoning.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 船位推算（按最后位置、航速、航向和转向率外推任意时刻的位置）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        地理常量改用utils/geo_math.h
+
+*****************************************************************/
+
+#ifndef AIS_DEAD_RECKONING_H
+#define AIS_DEAD_RECKONING_H
+
+#include "utils/geo_math.h"
+#include "utils/vessel_state.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ais
+{
+
+/**
+ * @brief 推算位置
+ */
+struct PredictedPosition
+{
+    uint32_t mmsi = 0;
+    double latitude = 91.0;             // 纬度 (度)，91表示不可用
+    double longitude = 181.0;           // 经度 (度)，181表示不可用
+    double courseOverGround = 360.0;    // 推算时刻的航向（计入转向率），360表示不可用
+    double speedOverGround = 0.0;       // 对地速度 (节)
+    int64_t elapsedMs = 0;              // 外推时长（毫秒，已按上限截断）
+    bool extrapolated = false;          // 是否做了外推（无航速航向或静止时为最后位置）
+};
+
+/**
+ * @brief 船位推算
+ *
+ * 沿大圆航线按对地速度外推；有转向率时按ROT_STEP_SEC分段推进并逐段修正航向（等速转向）。
+ * 外推时长超过上限时按上限截断，避免长时间无报告的船舶被推到远处。
+ */
+class DeadReckoning
+{
+public:
+    static constexpr double EARTH_RADIUS_M = geo::EARTH_RADIUS_M;  // 地球平均半径
+    static constexpr double KNOT_MS = geo::KNOT_MS;                // 节换算为米/秒
+    static constexpr double ROT_STEP_SEC = 10.0;            // 转向时的分段时长
+    static constexpr double MIN_SPEED_KN = 0.1;             // 低于该航速视为静止
+
+    /**
+     * @brief 推算单船在指定时刻的位置
+     * @param state 船舶状态
+     * @param atMs 目标时刻（毫秒，与状态中的接收时间同一时钟）
+     * @param maxHorizonMs 最长外推时长（毫秒），非正数表示不限制
+     * @param out [out] 推算结果
+     * @return 船舶有有效位置时返回true
+     */
+    static bool predict(const VesselState &state, int64_t atMs, int64_t maxHorizonMs, PredictedPosition &out);
+
+    /**
+     * @brief 批量推算（连续数组上逐船计算，不加锁，适合对整表快照一次求值）
+     * @param states 船舶状态数组
+     * @param count 船舶数
+     * @param atMs 目标时刻（毫秒）
+     * @param maxHorizonMs 最长外推时长（毫秒），非正数表示不限制
+     * @param out [out] 结果数组，需至少count个元素；无有效位置的船舶latitude为91
+     * @return 有有效位置的船舶数
+     */
+    static size_t predictBatch(const VesselState *states, size_t count, int64_t atMs, int64_t maxHorizonMs,
+                               PredictedPosition *out);
+
+    /**
+     * @brief 沿大圆从起点按方位角前进指定距离
+     * @param latitude [in/out] 纬度（度）
+     * @param longitude [in/out] 经度（度），结果归一到[-180, 180)
+     * @param bearingDeg 方位角（度）
+     * @param distanceM 距离（米）
+     */
+    static void destination(double &latitude, double &longitude, double bearingDeg, double distanceM);
+
+    /**
+     * @brief 转向率（度/分，AIS解码值）换算为度/秒
+     * @return 不可用时返回0；±127表示超过5度/30秒，按该下限取值
+     */
+    static double rotDegPerSec(int rateOfTurn);
+};
+
+} // namespace ais
+
+#endif // AIS_DEAD_RECKONING_H
@@ -0,0 +1,71 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        event_record.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 转发事件记录（告警、围栏、异常、态势）的二进制记录头与小端写出
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_EVENT_RECORD_H
+#define AIS_EVENT_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ais
+{
+
+/**
+ * @brief 事件记录格式
+ *
+ * 记录头8字节：魔数0xA6 + 版本 + 类型 + 子类型 + MMSI(u32)，之后为各类型的定长字段（小端）。
+ * 类型：'A'会遇告警，'G'电子围栏，'X'运动学异常，'F'/'K'/'D'/'R'态势发布。
+ * 与BinaryCodec的消息记录（魔数0xA5）共用同一转发通道，接收端按魔数区分。
+ */
+class EventRecord
+{
+public:
+    static constexpr uint8_t MAGIC = 0xA6;      // 记录魔数
+    static constexpr uint8_t VERSION = 1;       // 格式版本号
+    static constexpr size_t HEADER_SIZE = 8;    // 记录头长度
+
+    /**
+     * @brief 清空输出缓冲区并写入记录头
+     * @param out 输出缓冲区
+     * @param kind 记录类型
+     * @param subtype 子类型（事件类型、告警状态等）
+     * @param mmsi MMSI
+     */
+    static void begin(std::string &out, char kind, uint8_t subtype, uint32_t mmsi)
+    {
+        out.clear();
+        out.push_back(static_cast<char>(MAGIC));
+        out.push_back(static_cast<char>(VERSION));
+        out.push_back(kind);
+        out.push_back(static_cast<char>(subtype));
+        putLE<uint32_t>(out, mmsi);
+    }
+
+    /**
+     * @brief 按小端字节序追加整数
+     */
+    template <class T>
+    static void putLE(std::string &out, T value)
+    {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            out.push_back(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+        }
+    }
+};
+
+} // namespace ais
+
+#endif // AIS_EVENT_RECORD_H
@@ -0,0 +1,83 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        geo_math.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 地理计算公共常量与距离、方位角函数（球面模型，地球平均半径）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_GEO_MATH_H
+#define AIS_GEO_MATH_H
+
+#include <algorithm>
+#include <cmath>
+
+namespace ais
+{
+namespace geo
+{
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG_TO_RAD = PI / 180.0;
+constexpr double RAD_TO_DEG = 180.0 / PI;
+constexpr double EARTH_RADIUS_M = 6371008.8;                        // 地球平均半径
+constexpr double METERS_PER_DEGREE = EARTH_RADIUS_M * DEG_TO_RAD;   // 每度纬度的弧长
+constexpr double NM_TO_M = 1852.0;                                  // 海里换算为米
+constexpr double KNOT_MS = NM_TO_M / 3600.0;                        // 节换算为米/秒
+
+/**
+ * @brief 经纬度在有效范围内（AIS的91/181等不可用值返回false）
+ */
+inline bool validPosition(double latitude, double longitude)
+{
+    return latitude >= -90.0 && latitude <= 90.0 && longitude >= -180.0 && longitude <= 180.0;
+}
+
+/**
+ * @brief 两点间大圆距离（米，haversine公式）
+ */
+inline double distanceMeters(double lat1, double lon1, double lat2, double lon2)
+{
+    const double phi1 = lat1 * DEG_TO_RAD;
+    const double phi2 = lat2 * DEG_TO_RAD;
+    const double sinDPhi = std::sin((phi2 - phi1) * 0.5);
+    const double sinDLambda = std::sin((lon2 - lon1) * DEG_TO_RAD * 0.5);
+    const double a = sinDPhi * sinDPhi + std::cos(phi1) * std::cos(phi2) * sinDLambda * sinDLambda;
+    return 2.0 * EARTH_RADIUS_M * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+/**
+ * @brief 近距离两点间距离（米，等距柱状投影近似，不处理180度经线回绕，适合百米至公里量级的比较）
+ */
+inline double localDistanceMeters(double lat1, double lon1, double lat2, double lon2)
+{
+    const double dLat = (lat2 - lat1) * METERS_PER_DEGREE;
+    const double dLon = (lon2 - lon1) * METERS_PER_DEGREE * std::cos((lat1 + lat2) * 0.5 * DEG_TO_RAD);
+    return std::sqrt(dLat * dLat + dLon * dLon);
+}
+
+/**
+ * @brief 从(lat1, lon1)到(lat2, lon2)的初始方位角（度，0-360）
+ */
+inline double bearingDeg(double lat1, double lon1, double lat2, double lon2)
+{
+    const double phi1 = lat1 * DEG_TO_RAD;
+    const double phi2 = lat2 * DEG_TO_RAD;
+    const double dLambda = (lon2 - lon1) * DEG_TO_RAD;
+    const double y = std::sin(dLambda) * std::cos(phi2);
+    const double x = std::cos(phi1) * std::sin(phi2) - std::sin(phi1) * std::cos(phi2) * std::cos(dLambda);
+    const double deg = std::atan2(y, x) * RAD_TO_DEG;
+    return deg < 0.0 ? deg + 360.0 : deg;
+}
+
+} // namespace geo
+} // namespace ais
+
+#endif // AIS_GEO_MATH_H
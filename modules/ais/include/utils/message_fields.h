@@ -0,0 +1,60 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        message_fields.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 跨消息类型的公共字段提取
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        位置字段增加报告时刻的UTC秒
+
+*****************************************************************/
+
+#ifndef AIS_MESSAGE_FIELDS_H
+#define AIS_MESSAGE_FIELDS_H
+
+#include "messages/message.h"
+
+namespace ais
+{
+
+/**
+ * @brief 位置类消息的运动学字段
+ *
+ * 各位置报告结构体相互独立（无公共基类），通过该结构统一读取
+ */
+struct PositionFields
+{
+    double longitude = 181.0;       // 经度 (度)，181表示不可用
+    double latitude = 91.0;         // 纬度 (度)，91表示不可用
+    double speedOverGround = 0.0;   // 对地速度 (节)
+    double courseOverGround = 0.0;  // 对地航向 (度)
+    int trueHeading = 511;          // 真航向，511表示不可用
+    int rateOfTurn = -128;          // 转向率，-128表示不可用
+    int navigationStatus = 15;      // 导航状态，15表示未定义
+    bool positionAccuracy = false;  // 位置精度
+    bool hasKinematics = false;     // 是否包含航速航向（基站、助航设备等仅有位置）
+    int utcSecond = 60;             // 报告时刻的UTC秒 (0-59)，60及以上表示不可用
+};
+
+/**
+ * @brief 判断消息类型是否为船舶动态位置报告（1/2/3/18/19/27）
+ * @param type 消息类型
+ */
+bool isVesselPositionType(AISMessageType type);
+
+/**
+ * @brief 提取消息中的位置字段
+ * @param msg AIS消息
+ * @param out [out] 位置字段
+ * @return 消息包含有效经纬度时返回true
+ */
+bool extractPosition(const AISMessage &msg, PositionFields &out);
+
+} // namespace ais
+
+#endif // AIS_MESSAGE_FIELDS_H
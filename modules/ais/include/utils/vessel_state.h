@@ -0,0 +1,109 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        vessel_state.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 单船综合状态（动态/静态字段合并，定长无堆分配）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_VESSEL_STATE_H
+#define AIS_VESSEL_STATE_H
+
+#include "messages/message.h"
+
+#include <cstdint>
+#include <string>
+
+namespace ais
+{
+
+/**
+ * @brief 单船综合状态
+ *
+ * 动态字段来自1/2/3/18/19/27，静态字段来自5/19/24，每组字段单独记录最后更新时间，
+ * 位置报告和静态报告互不覆盖。文本字段为定长数组，update()原地合并不申请内存。
+ */
+struct VesselState
+{
+    static constexpr size_t NAME_SIZE = 21;         // 船名/目的地最多20字符
+    static constexpr size_t CALLSIGN_SIZE = 8;      // 呼号最多7字符
+
+    uint32_t mmsi = 0;
+
+    // 动态字段（1/2/3/18/19/27）
+    double longitude = 181.0;           // 经度 (度)，181表示不可用
+    double latitude = 91.0;             // 纬度 (度)，91表示不可用
+    double speedOverGround = 0.0;       // 对地速度 (节)
+    double courseOverGround = 0.0;      // 对地航向 (度)
+    int16_t trueHeading = 511;          // 真航向，511表示不可用
+    int16_t rateOfTurn = -128;          // 转向率，-128表示不可用
+    uint8_t navigationStatus = 15;      // 导航状态，15表示未定义
+    bool positionAccuracy = false;
+    bool classB = false;                // 最近一次位置来自B类设备(18/19)
+    AISMessageType positionType = AISMessageType::UNKNOWN; // 最近一次位置报告的消息类型
+
+    // 静态字段（5/19/24）
+    uint32_t imoNumber = 0;
+    char callSign[CALLSIGN_SIZE] = {};
+    char vesselName[NAME_SIZE] = {};
+    uint8_t shipType = 0;
+    uint16_t dimensionToBow = 0;
+    uint16_t dimensionToStern = 0;
+    uint8_t dimensionToPort = 0;
+    uint8_t dimensionToStarboard = 0;
+
+    // 航次字段（5）
+    double draught = 0.0;
+    char destination[NAME_SIZE] = {};
+    uint8_t etaMonth = 0;
+    uint8_t etaDay = 0;
+    uint8_t etaHour = 24;
+    uint8_t etaMinute = 60;
+
+    // 各组字段最后更新时间（毫秒，0表示从未收到）
+    int64_t positionTimeMs = 0;         // 位置与运动学
+    int64_t navStatusTimeMs = 0;        // 导航状态（仅A类/长距离报告携带）
+    int64_t identityTimeMs = 0;         // 船名/呼号/IMO
+    int64_t shipDataTimeMs = 0;         // 船舶类型/尺寸
+    int64_t voyageTimeMs = 0;           // 吃水/目的地/ETA
+    int64_t lastUpdateMs = 0;           // 任意字段
+    uint32_t messageCount = 0;          // 合并的消息数
+
+    /**
+     * @brief 将一条消息合并到状态中
+     * @param msg AIS消息（MMSI需与本状态一致，空状态时采用消息的MMSI）
+     * @param timeMs 接收时间（毫秒）
+     * @return 消息包含本结构关心的字段时返回true
+     */
+    bool update(const AISMessage &msg, int64_t timeMs);
+
+    /**
+     * @brief 判断消息类型是否携带船舶状态字段（1/2/3/5/18/19/24/27）
+     */
+    static bool accepts(AISMessageType type);
+
+    bool hasPosition() const { return positionTimeMs != 0; }
+    bool hasStatic() const { return identityTimeMs != 0 || shipDataTimeMs != 0; }
+
+    int length() const { return dimensionToBow + dimensionToStern; }
+    int width() const { return dimensionToPort + dimensionToStarboard; }
+
+    /**
+     * @brief 输出CSV行
+     *
+     * 列：mmsi,latitude,longitude,sog,cog,heading,navStatus,vesselName,callSign,imo,
+     *     shipType,length,width,draught,destination,positionTimeMs,staticTimeMs
+     */
+    std::string toCsv() const;
+};
+
+} // namespace ais
+
+#endif // AIS_VESSEL_STATE_H
@@ -6,7 +6,13 @@
 
 namespace ais {
 
-AISParser::AISParser(const AISParseCfg& cfg) : config_(cfg) {}
+AISParser::AISParser(const AISParseCfg& cfg)
+    : config_(cfg)
+    , reassembler_(new MultipartReassembler(cfg.maxMultipartAge))
+{
+}
+
+AISParser::~AISParser() = default;
 
 std::unique_ptr<AISMessage> AISParser::parse(const std::string &nmea) const
 {
@@ -31,15 +37,17 @@ std::unique_ptr<AISMessage> AISParser::parse(const std::string &nmea) const
         // 生成唯一消息ID（使用负载前几个字符作为标识）
         std::string messageId = payload.substr(0, std::min(10, (int)payload.length()));
         
-        static MultipartReassembler reassembler(config_.maxMultipartAge);
-        reassembler.addFragment(messageId, payload, fragmentNumber, fragmentCount);
-
-        if (reassembler.isComplete(messageId, fragmentCount))
+        std::string completePayload;
         {
-            std::string completePayload = reassembler.reassemble(messageId, fragmentCount);
-            return parseBinary(NMEAParser::decode6bitASCII(completePayload));
+            std::lock_guard<std::mutex> lock(reassemblerMutex_);
+            reassembler_->addFragment(messageId, payload, fragmentNumber, fragmentCount);
+            if (!reassembler_->isComplete(messageId, fragmentCount))
+            {
+                return nullptr; // 等待更多片段
+            }
+            completePayload = reassembler_->reassemble(messageId, fragmentCount);
         }
-        return nullptr; // 等待更多片段
+        return parseBinary(NMEAParser::decode6bitASCII(completePayload));
     }
 
     // 单部分消息直接解析
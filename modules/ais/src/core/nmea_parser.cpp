@@ -82,6 +82,55 @@ std::string NMEAParser::decode6bitASCII(const std::string &payload)
     return binaryData;
 }
 
+bool NMEAParser::peekHeader(const char *nmea, NMEAHeader &header)
+{
+    header = NMEAHeader();
+    if (!nmea)
+    {
+        return false;
+    }
+
+    // 定位字段起点：1分片总数 2分片号 3序号 4信道 5负载
+    const char *fields[6] = {nullptr};
+    int index = 0;
+    for (const char *p = nmea; *p && index < 5; ++p)
+    {
+        if (*p == ',')
+        {
+            fields[++index] = p + 1;
+        }
+    }
+    if (index < 5)
+    {
+        return false;
+    }
+
+    auto digit = [](const char *field, int fallback) {
+        return (field[0] >= '0' && field[0] <= '9') ? field[0] - '0' : fallback;
+    };
+    header.fragmentCount = digit(fields[1], 1);
+    header.fragmentNumber = digit(fields[2], 1);
+    header.sequenceId = digit(fields[3], -1);
+    header.channel = fields[4][0] == ',' ? '\0' : fields[4][0];
+
+    // MMSI为消息第8~37位，即负载前7个字符（42位）中去掉前8位和后4位
+    if (header.fragmentNumber == 1)
+    {
+        uint64_t bits = 0;
+        for (int i = 0; i < 7; ++i)
+        {
+            int c = static_cast<unsigned char>(fields[5][i]) - 48;
+            if (c < 0 || c > 71 || (c > 39 && c < 48))
+            {
+                return true;
+            }
+            bits = (bits << 6) | static_cast<uint64_t>(c > 40 ? c - 8 : c);
+        }
+        header.mmsi = static_cast<uint32_t>((bits >> 4) & 0x3FFFFFFF);
+    }
+    return true;
+}
+
 int NMEAParser::getFragmentCount(const std::string &nmea)
 {
     auto parts = split(nmea, ',');
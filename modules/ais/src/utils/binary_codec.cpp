@@ -0,0 +1,564 @@
+#include "utils/binary_codec.h"
+
+#include "messages/type_definitions.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace ais
+{
+
+namespace
+{
+
+// 各记录族定长（含8字节记录头）
+constexpr size_t CLASS_A_POSITION_SIZE = 29;
+constexpr size_t CLASS_B_POSITION_SIZE = 28;
+constexpr size_t CLASS_B_EXTENDED_SIZE = 52;
+constexpr size_t STATIC_VOYAGE_SIZE = 73;
+constexpr size_t STATIC_DATA_SIZE = 54;
+constexpr size_t BASE_STATION_SIZE = 28;
+constexpr size_t AID_TO_NAVIGATION_SIZE = 61;
+
+/**
+ * @brief 小端顺序写入器
+ */
+class ByteWriter
+{
+public:
+    explicit ByteWriter(uint8_t *out) : p_(out) {}
+
+    void u8(uint32_t v) { *p_++ = static_cast<uint8_t>(v); }
+    void u16(uint32_t v) { u8(v); u8(v >> 8); }
+    void u24(uint32_t v) { u16(v); u8(v >> 16); }
+    void u32(uint32_t v) { u16(v); u16(v >> 16); }
+    void i16(int32_t v) { u16(static_cast<uint32_t>(v)); }
+    void i32(int32_t v) { u32(static_cast<uint32_t>(v)); }
+
+    // 定长字符串，不足补0，超长截断
+    void str(const std::string &s, size_t width)
+    {
+        size_t n = s.size() < width ? s.size() : width;
+        std::memcpy(p_, s.data(), n);
+        std::memset(p_ + n, 0, width - n);
+        p_ += width;
+    }
+
+private:
+    uint8_t *p_;
+};
+
+/**
+ * @brief 小端顺序读取器
+ */
+class ByteReader
+{
+public:
+    explicit ByteReader(const uint8_t *in) : p_(in) {}
+
+    uint32_t u8() { return *p_++; }
+    uint32_t u16() { uint32_t lo = u8(); return lo | (u8() << 8); }
+    uint32_t u24() { uint32_t lo = u16(); return lo | (u8() << 16); }
+    uint32_t u32() { uint32_t lo = u16(); return lo | (u16() << 16); }
+    int32_t i16() { return static_cast<int16_t>(u16()); }
+    int32_t i32() { return static_cast<int32_t>(u32()); }
+
+    std::string str(size_t width)
+    {
+        size_t n = 0;
+        while (n < width && p_[n] != 0) ++n;
+        std::string s(reinterpret_cast<const char *>(p_), n);
+        p_ += width;
+        return s;
+    }
+
+private:
+    const uint8_t *p_;
+};
+
+// 0.1单位的非负量（速度、航向、吃水）
+uint32_t encodeTenths(double v)
+{
+    return v <= 0 ? 0 : static_cast<uint32_t>(std::lround(v * 10.0));
+}
+
+inline uint32_t bit(bool b, int pos)
+{
+    return (b ? 1u : 0u) << pos;
+}
+
+inline bool hasBit(uint32_t flags, int pos)
+{
+    return ((flags >> pos) & 1u) != 0;
+}
+
+/************* 类型1/2/3 *************/
+
+template <class T>
+void writeClassA(ByteWriter &w, const T &m)
+{
+    w.u8((m.repeatIndicator & 0x3) | ((m.navigationStatus & 0xF) << 2)
+         | bit(m.positionAccuracy, 6) | bit(m.raimFlag, 7));
+    w.u8((m.timestampUTC & 0x3F) | ((m.specialManeuver & 0x3) << 6));
+    w.i16(m.rateOfTurn);
+    w.u16(encodeTenths(m.speedOverGround));
+    w.i32(BinaryCodec::encodeCoord(m.longitude));
+    w.i32(BinaryCodec::encodeCoord(m.latitude));
+    w.u16(encodeTenths(m.courseOverGround));
+    w.u16(m.trueHeading);
+    w.u24(m.communicationState);
+}
+
+template <class T>
+std::unique_ptr<AISMessage> readClassA(ByteReader &r)
+{
+    auto m = std::make_unique<T>();
+    uint32_t flags = r.u8();
+    m->repeatIndicator = flags & 0x3;
+    m->navigationStatus = (flags >> 2) & 0xF;
+    m->positionAccuracy = hasBit(flags, 6);
+    m->raimFlag = hasBit(flags, 7);
+    uint32_t timing = r.u8();
+    m->timestampUTC = timing & 0x3F;
+    m->specialManeuver = (timing >> 6) & 0x3;
+    m->rateOfTurn = r.i16();
+    m->speedOverGround = r.u16() / 10.0;
+    m->longitude = BinaryCodec::decodeCoord(r.i32());
+    m->latitude = BinaryCodec::decodeCoord(r.i32());
+    m->courseOverGround = r.u16() / 10.0;
+    m->trueHeading = r.u16();
+    m->communicationState = r.u24();
+    return m;
+}
+
+/************* 类型18 *************/
+
+void writeClassB(ByteWriter &w, const StandardClassBReport &m)
+{
+    w.u8((m.repeatIndicator & 0x3) | bit(m.positionAccuracy, 2) | bit(m.raimFlag, 3)
+         | bit(m.displayFlag, 4) | bit(m.dscFlag, 5) | bit(m.bandFlag, 6) | bit(m.message22Flag, 7));
+    w.u8(bit(m.assignedModeFlag, 0) | bit(m.csUnit != 0, 1));
+    w.u8(m.timestampUTC);
+    w.u16(encodeTenths(m.speedOverGround));
+    w.i32(BinaryCodec::encodeCoord(m.longitude));
+    w.i32(BinaryCodec::encodeCoord(m.latitude));
+    w.u16(encodeTenths(m.courseOverGround));
+    w.u16(m.trueHeading);
+    w.u24(m.communicationState);
+}
+
+std::unique_ptr<AISMessage> readClassB(ByteReader &r)
+{
+    auto m = std::make_unique<StandardClassBReport>();
+    uint32_t flags = r.u8();
+    m->repeatIndicator = flags & 0x3;
+    m->positionAccuracy = hasBit(flags, 2);
+    m->raimFlag = hasBit(flags, 3);
+    m->displayFlag = hasBit(flags, 4);
+    m->dscFlag = hasBit(flags, 5);
+    m->bandFlag = hasBit(flags, 6);
+    m->message22Flag = hasBit(flags, 7);
+    uint32_t flags2 = r.u8();
+    m->assignedModeFlag = hasBit(flags2, 0);
+    m->csUnit = hasBit(flags2, 1) ? 1 : 0;
+    m->timestampUTC = r.u8();
+    m->speedOverGround = r.u16() / 10.0;
+    m->longitude = BinaryCodec::decodeCoord(r.i32());
+    m->latitude = BinaryCodec::decodeCoord(r.i32());
+    m->courseOverGround = r.u16() / 10.0;
+    m->trueHeading = r.u16();
+    m->communicationState = r.u24();
+    return m;
+}
+
+/************* 类型19 *************/
+
+void writeClassBExtended(ByteWriter &w, const ExtendedClassBReport &m)
+{
+    w.u8((m.repeatIndicator & 0x3) | bit(m.positionAccuracy, 2) | bit(m.raimFlag, 3)
+         | bit(m.dte, 4) | bit(m.assignedModeFlag, 5));
+    w.u8(m.timestampUTC);
+    w.u16(encodeTenths(m.speedOverGround));
+    w.i32(BinaryCodec::encodeCoord(m.longitude));
+    w.i32(BinaryCodec::encodeCoord(m.latitude));
+    w.u16(encodeTenths(m.courseOverGround));
+    w.u16(m.trueHeading);
+    w.str(m.vesselName, 20);
+    w.u8(m.shipType);
+    w.u16(m.dimensionToBow);
+    w.u16(m.dimensionToStern);
+    w.u8(m.dimensionToPort);
+    w.u8(m.dimensionToStarboard);
+    w.u8(m.epfdType);
+}
+
+std::unique_ptr<AISMessage> readClassBExtended(ByteReader &r)
+{
+    auto m = std::make_unique<ExtendedClassBReport>();
+    uint32_t flags = r.u8();
+    m->repeatIndicator = flags & 0x3;
+    m->positionAccuracy = hasBit(flags, 2);
+    m->raimFlag = hasBit(flags, 3);
+    m->dte = hasBit(flags, 4);
+    m->assignedModeFlag = hasBit(flags, 5);
+    m->timestampUTC = r.u8();
+    m->speedOverGround = r.u16() / 10.0;
+    m->longitude = BinaryCodec::decodeCoord(r.i32());
+    m->latitude = BinaryCodec::decodeCoord(r.i32());
+    m->courseOverGround = r.u16() / 10.0;
+    m->trueHeading = r.u16();
+    m->vesselName = r.str(20);
+    m->shipType = r.u8();
+    m->dimensionToBow = r.u16();
+    m->dimensionToStern = r.u16();
+    m->dimensionToPort = r.u8();
+    m->dimensionToStarboard = r.u8();
+    m->epfdType = r.u8();
+    return m;
+}
+
+/************* 类型5 *************/
+
+void writeStaticVoyage(ByteWriter &w, const StaticVoyageData &m)
+{
+    w.u8((m.repeatIndicator & 0x3) | ((m.aisVersion & 0x3) << 2) | bit(m.dte, 4));
+    w.u32(m.imoNumber);
+    w.str(m.callSign, 7);
+    w.str(m.vesselName, 20);
+    w.u8(m.shipType);
+    w.u16(m.dimensionToBow);
+    w.u16(m.dimensionToStern);
+    w.u8(m.dimensionToPort);
+    w.u8(m.dimensionToStarboard);
+    w.u8(m.epfdType);
+    w.u8(m.month);
+    w.u8(m.day);
+    w.u8(m.hour);
+    w.u8(m.minute);
+    w.u8(encodeTenths(m.draught));
+    w.str(m.destination, 20);
+}
+
+std::unique_ptr<AISMessage> readStaticVoyage(ByteReader &r)
+{
+    auto m = std::make_unique<StaticVoyageData>();
+    uint32_t flags = r.u8();
+    m->repeatIndicator = flags & 0x3;
+    m->aisVersion = (flags >> 2) & 0x3;
+    m->dte = hasBit(flags, 4);
+    m->imoNumber = static_cast<int>(r.u32());
+    m->callSign = r.str(7);
+    m->vesselName = r.str(20);
+    m->shipType = r.u8();
+    m->dimensionToBow = r.u16();
+    m->dimensionToStern = r.u16();
+    m->dimensionToPort = r.u8();
+    m->dimensionToStarboard = r.u8();
+    m->epfdType = r.u8();
+    m->month = r.u8();
+    m->day = r.u8();
+    m->hour = r.u8();
+    m->minute = r.u8();
+    m->draught = r.u8() / 10.0;
+    m->destination = r.str(20);
+    return m;
+}
+
+/************* 类型24 *************/
+
+void writeStaticData(ByteWriter &w, const StaticDataReport &m)
+{
+    w.u8((m.repeatIndicator & 0x3) | ((m.partNumber & 0x3) << 2));
+    w.str(m.vesselName, 20);
+    w.u8(m.shipType);
+    w.str(m.vendorId, 7);
+    w.str(m.callSign, 7);
+    w.u16(m.dimensionToBow);
+    w.u16(m.dimensionToStern);
+    w.u8(m.dimensionToPort);
+    w.u8(m.dimensionToStarboard);
+    w.u32(m.mothershipMmsi);
+}
+
+std::unique_ptr<AISMessage> readStaticData(ByteReader &r)
+{
+    auto m = std::make_unique<StaticDataReport>();
+    uint32_t flags = r.u8();
+    m->repeatIndicator = flags & 0x3;
+    m->partNumber = (flags >> 2) & 0x3;
+    m->vesselName = r.str(20);
+    m->shipType = r.u8();
+    m->vendorId = r.str(7);
+    m->callSign = r.str(7);
+    m->dimensionToBow = r.u16();
+    m->dimensionToStern = r.u16();
+    m->dimensionToPort = r.u8();
+    m->dimensionToStarboard = r.u8();
+    m->mothershipMmsi = r.u32();
+    return m;
+}
+
+/************* 类型4/11 *************/
+
+template <class T>
+void writeBaseStation(ByteWriter &w, const T &m)
+{
+    w.u8((m.repeatIndicator & 0x3) | bit(m.positionAccuracy, 2) | bit(m.raimFlag, 3));
+    w.u16(m.year);
+    w.u8(m.month);
+    w.u8(m.day);
+    w.u8(m.hour);
+    w.u8(m.minute);
+    w.u8(m.second);
+    w.i32(BinaryCodec::encodeCoord(m.longitude));
+    w.i32(BinaryCodec::encodeCoord(m.latitude));
+    w.u8(m.epfdType);
+    w.u24(m.communicationState);
+}
+
+template <class T>
+std::unique_ptr<AISMessage> readBaseStation(ByteReader &r)
+{
+    auto m = std::make_unique<T>();
+    uint32_t flags = r.u8();
+    m->repeatIndicator = flags & 0x3;
+    m->positionAccuracy = hasBit(flags, 2);
+    m->raimFlag = hasBit(flags, 3);
+    m->year = r.u16();
+    m->month = r.u8();
+    m->day = r.u8();
+    m->hour = r.u8();
+    m->minute = r.u8();
+    m->second = r.u8();
+    m->longitude = BinaryCodec::decodeCoord(r.i32());
+    m->latitude = BinaryCodec::decodeCoord(r.i32());
+    m->epfdType = r.u8();
+    m->communicationState = r.u24();
+    return m;
+}
+
+/************* 类型21 *************/
+
+void writeAidToNavigation(ByteWriter &w, const AidToNavigationReport &m)
+{
+    w.u8((m.repeatIndicator & 0x3) | bit(m.positionAccuracy, 2) | bit(m.offPositionIndicator, 3)
+         | bit(m.raimFlag, 4) | bit(m.virtualAidFlag, 5) | bit(m.assignedModeFlag, 6));
+    w.u8(m.aidType);
+    w.str(m.name, 20);
+    w.str(m.nameExtension, 14);
+    w.i32(BinaryCodec::encodeCoord(m.longitude));
+    w.i32(BinaryCodec::encodeCoord(m.latitude));
+    w.u16(m.dimensionToBow);
+    w.u16(m.dimensionToStern);
+    w.u8(m.dimensionToPort);
+    w.u8(m.dimensionToStarboard);
+    w.u8(m.epfdType);
+    w.u8(m.timestampUTC);
+    w.u8(m.regional);
+}
+
+std::unique_ptr<AISMessage> readAidToNavigation(ByteReader &r)
+{
+    auto m = std::make_unique<AidToNavigationReport>();
+    uint32_t flags = r.u8();
+    m->repeatIndicator = flags & 0x3;
+    m->positionAccuracy = hasBit(flags, 2);
+    m->offPositionIndicator = hasBit(flags, 3);
+    m->raimFlag = hasBit(flags, 4);
+    m->virtualAidFlag = hasBit(flags, 5);
+    m->assignedModeFlag = hasBit(flags, 6);
+    m->aidType = r.u8();
+    m->name = r.str(20);
+    m->nameExtension = r.str(14);
+    m->longitude = BinaryCodec::decodeCoord(r.i32());
+    m->latitude = BinaryCodec::decodeCoord(r.i32());
+    m->dimensionToBow = r.u16();
+    m->dimensionToStern = r.u16();
+    m->dimensionToPort = r.u8();
+    m->dimensionToStarboard = r.u8();
+    m->epfdType = r.u8();
+    m->timestampUTC = r.u8();
+    m->regional = r.u8();
+    return m;
+}
+
+} // namespace
+
+BinaryRecordFamily BinaryCodec::familyOf(AISMessageType type)
+{
+    switch (type)
+    {
+    case AISMessageType::POSITION_REPORT_CLASS_A:
+    case AISMessageType::POSITION_REPORT_CLASS_A_ASSIGNED:
+    case AISMessageType::POSITION_REPORT_CLASS_A_RESPONSE:
+        return BinaryRecordFamily::CLASS_A_POSITION;
+    case AISMessageType::STANDARD_CLASS_B_CS_POSITION:
+        return BinaryRecordFamily::CLASS_B_POSITION;
+    case AISMessageType::EXTENDED_CLASS_B_CS_POSITION:
+        return BinaryRecordFamily::CLASS_B_EXTENDED;
+    case AISMessageType::STATIC_VOYAGE_DATA:
+        return BinaryRecordFamily::STATIC_VOYAGE;
+    case AISMessageType::STATIC_DATA_REPORT:
+        return BinaryRecordFamily::STATIC_DATA;
+    case AISMessageType::BASE_STATION_REPORT:
+    case AISMessageType::UTC_DATE_RESPONSE:
+        return BinaryRecordFamily::BASE_STATION;
+    case AISMessageType::AID_TO_NAVIGATION_REPORT:
+        return BinaryRecordFamily::AID_TO_NAVIGATION;
+    default:
+        return BinaryRecordFamily::UNSUPPORTED;
+    }
+}
+
+size_t BinaryCodec::recordSize(BinaryRecordFamily family)
+{
+    switch (family)
+    {
+    case BinaryRecordFamily::CLASS_A_POSITION: return CLASS_A_POSITION_SIZE;
+    case BinaryRecordFamily::CLASS_B_POSITION: return CLASS_B_POSITION_SIZE;
+    case BinaryRecordFamily::CLASS_B_EXTENDED: return CLASS_B_EXTENDED_SIZE;
+    case BinaryRecordFamily::STATIC_VOYAGE: return STATIC_VOYAGE_SIZE;
+    case BinaryRecordFamily::STATIC_DATA: return STATIC_DATA_SIZE;
+    case BinaryRecordFamily::BASE_STATION: return BASE_STATION_SIZE;
+    case BinaryRecordFamily::AID_TO_NAVIGATION: return AID_TO_NAVIGATION_SIZE;
+    default: return 0;
+    }
+}
+
+int32_t BinaryCodec::encodeCoord(double degrees)
+{
+    return static_cast<int32_t>(std::lround(degrees * COORD_SCALE));
+}
+
+double BinaryCodec::decodeCoord(int32_t value)
+{
+    return value / COORD_SCALE;
+}
+
+size_t BinaryCodec::serialize(const AISMessage &msg, uint8_t *out, size_t capacity)
+{
+    const BinaryRecordFamily family = familyOf(msg.type);
+    const size_t size = recordSize(family);
+    if (size == 0 || capacity < size) {
+        return 0;
+    }
+
+    ByteWriter w(out);
+    w.u8(MAGIC);
+    w.u8(VERSION);
+    w.u8(static_cast<uint8_t>(family));
+    w.u8(static_cast<uint8_t>(msg.type));
+    w.u32(msg.mmsi);
+
+    switch (msg.type)
+    {
+    case AISMessageType::POSITION_REPORT_CLASS_A:
+        writeClassA(w, static_cast<const PositionReport &>(msg));
+        break;
+    case AISMessageType::POSITION_REPORT_CLASS_A_ASSIGNED:
+        writeClassA(w, static_cast<const PositionReportAssigned &>(msg));
+        break;
+    case AISMessageType::POSITION_REPORT_CLASS_A_RESPONSE:
+        writeClassA(w, static_cast<const PositionReportResponse &>(msg));
+        break;
+    case AISMessageType::STANDARD_CLASS_B_CS_POSITION:
+        writeClassB(w, static_cast<const StandardClassBReport &>(msg));
+        break;
+    case AISMessageType::EXTENDED_CLASS_B_CS_POSITION:
+        writeClassBExtended(w, static_cast<const ExtendedClassBReport &>(msg));
+        break;
+    case AISMessageType::STATIC_VOYAGE_DATA:
+        writeStaticVoyage(w, static_cast<const StaticVoyageData &>(msg));
+        break;
+    case AISMessageType::STATIC_DATA_REPORT:
+        writeStaticData(w, static_cast<const StaticDataReport &>(msg));
+        break;
+    case AISMessageType::BASE_STATION_REPORT:
+        writeBaseStation(w, static_cast<const BaseStationReport &>(msg));
+        break;
+    case AISMessageType::UTC_DATE_RESPONSE:
+        writeBaseStation(w, static_cast<const UTCDateResponse &>(msg));
+        break;
+    case AISMessageType::AID_TO_NAVIGATION_REPORT:
+        writeAidToNavigation(w, static_cast<const AidToNavigationReport &>(msg));
+        break;
+    default:
+        return 0;
+    }
+
+    return size;
+}
+
+bool BinaryCodec::serialize(const AISMessage &msg, std::string &out)
+{
+    uint8_t record[MAX_RECORD_SIZE];
+    size_t size = serialize(msg, record, sizeof(record));
+    if (size == 0) {
+        return false;
+    }
+    out.append(reinterpret_cast<const char *>(record), size);
+    return true;
+}
+
+std::unique_ptr<AISMessage> BinaryCodec::deserialize(const uint8_t *data, size_t size, size_t *consumed)
+{
+    if (!data || size < HEADER_SIZE || data[0] != MAGIC || data[1] != VERSION) {
+        return nullptr;
+    }
+
+    ByteReader r(data + 2);
+    const auto family = static_cast<BinaryRecordFamily>(r.u8());
+    const auto type = static_cast<AISMessageType>(r.u8());
+    const uint32_t mmsi = r.u32();
+
+    const size_t recSize = recordSize(family);
+    if (recSize == 0 || size < recSize || familyOf(type) != family) {
+        return nullptr;
+    }
+
+    std::unique_ptr<AISMessage> msg;
+    switch (type)
+    {
+    case AISMessageType::POSITION_REPORT_CLASS_A:
+        msg = readClassA<PositionReport>(r);
+        break;
+    case AISMessageType::POSITION_REPORT_CLASS_A_ASSIGNED:
+        msg = readClassA<PositionReportAssigned>(r);
+        break;
+    case AISMessageType::POSITION_REPORT_CLASS_A_RESPONSE:
+        msg = readClassA<PositionReportResponse>(r);
+        break;
+    case AISMessageType::STANDARD_CLASS_B_CS_POSITION:
+        msg = readClassB(r);
+        break;
+    case AISMessageType::EXTENDED_CLASS_B_CS_POSITION:
+        msg = readClassBExtended(r);
+        break;
+    case AISMessageType::STATIC_VOYAGE_DATA:
+        msg = readStaticVoyage(r);
+        break;
+    case AISMessageType::STATIC_DATA_REPORT:
+        msg = readStaticData(r);
+        break;
+    case AISMessageType::BASE_STATION_REPORT:
+        msg = readBaseStation<BaseStationReport>(r);
+        break;
+    case AISMessageType::UTC_DATE_RESPONSE:
+        msg = readBaseStation<UTCDateResponse>(r);
+        break;
+    case AISMessageType::AID_TO_NAVIGATION_REPORT:
+        msg = readAidToNavigation(r);
+        break;
+    default:
+        return nullptr;
+    }
+
+    msg->type = type;
+    msg->mmsi = mmsi;
+    if (consumed) {
+        *consumed = recSize;
+    }
+    return msg;
+}
+
+} // namespace ais
@@ -0,0 +1,698 @@
+#include "utils/csv_writer.h"
+
+#include "messages/type_definitions.h"
+
+#include <charconv>
+#include <type_traits>
+
+namespace ais
+{
+
+namespace
+{
+
+// 从成员指针类型中提取所属类
+template <class T>
+struct MemberOf;
+
+template <class C, class V>
+struct MemberOf<V C::*>
+{
+    using Class = C;
+};
+
+/**
+ * @brief 通用列写出函数
+ * @tparam Member 成员指针
+ * @tparam Precision 浮点精度，-1表示非浮点字段
+ */
+template <auto Member, int Precision = -1>
+void writeMember(CsvWriter &writer, const AISMessage &msg)
+{
+    using Msg = typename MemberOf<decltype(Member)>::Class;
+    const auto &field = static_cast<const Msg &>(msg).*Member;
+    using Field = std::decay_t<decltype(field)>;
+
+    if constexpr (Precision >= 0) {
+        writer.appendValue(static_cast<double>(field), Precision);
+    } else if constexpr (std::is_same_v<Field, std::vector<uint8_t>>) {
+        // 二进制负载只输出长度，与toCsv()保持一致
+        writer.appendValue(static_cast<uint64_t>(field.size()));
+    } else {
+        writer.appendValue(field);
+    }
+}
+
+template <auto Member, int Precision = -1>
+CsvColumn col(const char *name)
+{
+    return {name, &writeMember<Member, Precision>};
+}
+
+// 公共列：类型、重复指示、MMSI
+void addHead(std::vector<CsvColumn> &cols)
+{
+    cols.push_back(col<&AISMessage::type>("type"));
+    cols.push_back(col<&AISMessage::repeatIndicator>("repeatIndicator"));
+    cols.push_back(col<&AISMessage::mmsi>("mmsi"));
+}
+
+// 公共列：接收时间戳、原始语句
+void addTail(std::vector<CsvColumn> &cols)
+{
+    cols.push_back(col<&AISMessage::timestamp>("timestamp"));
+    cols.push_back(col<&AISMessage::rawNMEA>("rawNMEA"));
+}
+
+// 类型1/2/3字段完全一致，但为相互独立的结构体
+template <class T>
+std::vector<CsvColumn> positionReportColumns()
+{
+    std::vector<CsvColumn> cols;
+    addHead(cols);
+    cols.push_back(col<&T::navigationStatus>("navigationStatus"));
+    cols.push_back(col<&T::rateOfTurn>("rateOfTurn"));
+    cols.push_back(col<&T::speedOverGround, 1>("speedOverGround"));
+    cols.push_back(col<&T::positionAccuracy>("positionAccuracy"));
+    cols.push_back(col<&T::longitude, 6>("longitude"));
+    cols.push_back(col<&T::latitude, 6>("latitude"));
+    cols.push_back(col<&T::courseOverGround, 1>("courseOverGround"));
+    cols.push_back(col<&T::trueHeading>("trueHeading"));
+    cols.push_back(col<&T::timestampUTC>("timestampUTC"));
+    cols.push_back(col<&T::specialManeuver>("specialManeuver"));
+    cols.push_back(col<&T::raimFlag>("raimFlag"));
+    cols.push_back(col<&T::communicationState>("communicationState"));
+    addTail(cols);
+    return cols;
+}
+
+// 类型4/11字段基本一致
+template <class T>
+std::vector<CsvColumn> utcPositionColumns()
+{
+    std::vector<CsvColumn> cols;
+    addHead(cols);
+    cols.push_back(col<&T::year>("year"));
+    cols.push_back(col<&T::month>("month"));
+    cols.push_back(col<&T::day>("day"));
+    cols.push_back(col<&T::hour>("hour"));
+    cols.push_back(col<&T::minute>("minute"));
+    cols.push_back(col<&T::second>("second"));
+    cols.push_back(col<&T::positionAccuracy>("positionAccuracy"));
+    cols.push_back(col<&T::longitude, 6>("longitude"));
+    cols.push_back(col<&T::latitude, 6>("latitude"));
+    cols.push_back(col<&T::epfdType>("epfdType"));
+    if constexpr (std::is_same_v<T, UTCDateResponse>) {
+        cols.push_back(col<&UTCDateResponse::spare>("spare"));
+    }
+    cols.push_back(col<&T::raimFlag>("raimFlag"));
+    cols.push_back(col<&T::communicationState>("communicationState"));
+    addTail(cols);
+    return cols;
+}
+
+// 类型25/26的公共部分
+template <class T>
+void addSlotBinaryColumns(std::vector<CsvColumn> &cols)
+{
+    cols.push_back(col<&T::addressed>("addressed"));
+    cols.push_back(col<&T::structured>("structured"));
+    cols.push_back(col<&T::destinationMmsi>("destinationMmsi"));
+    cols.push_back(col<&T::designatedAreaCode>("designatedAreaCode"));
+    cols.push_back(col<&T::functionalId>("functionalId"));
+    cols.push_back(col<&T::binaryData>("binaryDataLength"));
+}
+
+// 构建全部消息类型的列结构，下标即消息类型编号
+std::vector<std::vector<CsvColumn>> buildSchemas()
+{
+    std::vector<std::vector<CsvColumn>> schemas(28);
+
+    // 类型0：未知类型，仅输出公共列
+    addHead(schemas[0]);
+    addTail(schemas[0]);
+
+    schemas[1] = positionReportColumns<PositionReport>();
+    schemas[2] = positionReportColumns<PositionReportAssigned>();
+    schemas[3] = positionReportColumns<PositionReportResponse>();
+    schemas[4] = utcPositionColumns<BaseStationReport>();
+
+    {   // 类型5：静态和航程相关数据
+        auto &cols = schemas[5];
+        using T = StaticVoyageData;
+        addHead(cols);
+        cols.push_back(col<&T::aisVersion>("aisVersion"));
+        cols.push_back(col<&T::imoNumber>("imoNumber"));
+        cols.push_back(col<&T::callSign>("callSign"));
+        cols.push_back(col<&T::vesselName>("vesselName"));
+        cols.push_back(col<&T::shipType>("shipType"));
+        cols.push_back(col<&T::dimensionToBow>("dimensionToBow"));
+        cols.push_back(col<&T::dimensionToStern>("dimensionToStern"));
+        cols.push_back(col<&T::dimensionToPort>("dimensionToPort"));
+        cols.push_back(col<&T::dimensionToStarboard>("dimensionToStarboard"));
+        cols.push_back(col<&T::epfdType>("epfdType"));
+        cols.push_back(col<&T::month>("etaMonth"));
+        cols.push_back(col<&T::day>("etaDay"));
+        cols.push_back(col<&T::hour>("etaHour"));
+        cols.push_back(col<&T::minute>("etaMinute"));
+        cols.push_back(col<&T::draught, 1>("draught"));
+        cols.push_back(col<&T::destination>("destination"));
+        cols.push_back(col<&T::dte>("dte"));
+        addTail(cols);
+    }
+
+    {   // 类型6：二进制编址消息
+        auto &cols = schemas[6];
+        using T = BinaryAddressedMessage;
+        addHead(cols);
+        cols.push_back(col<&T::sequenceNumber>("sequenceNumber"));
+        cols.push_back(col<&T::destinationMmsi>("destinationMmsi"));
+        cols.push_back(col<&T::retransmitFlag>("retransmitFlag"));
+        cols.push_back(col<&T::designatedAreaCode>("designatedAreaCode"));
+        cols.push_back(col<&T::functionalId>("functionalId"));
+        cols.push_back(col<&T::binaryData>("binaryDataLength"));
+        addTail(cols);
+    }
+
+    {   // 类型7：二进制确认
+        auto &cols = schemas[7];
+        using T = BinaryAcknowledge;
+        addHead(cols);
+        cols.push_back(col<&T::sequenceNumber>("sequenceNumber"));
+        cols.push_back(col<&T::destinationMmsi1>("destinationMmsi1"));
+        cols.push_back(col<&T::destinationMmsi2>("destinationMmsi2"));
+        cols.push_back(col<&T::destinationMmsi3>("destinationMmsi3"));
+        cols.push_back(col<&T::destinationMmsi4>("destinationMmsi4"));
+        addTail(cols);
+    }
+
+    {   // 类型8：二进制广播消息
+        auto &cols = schemas[8];
+        using T = BinaryBroadcastMessage;
+        addHead(cols);
+        cols.push_back(col<&T::spare>("spare"));
+        cols.push_back(col<&T::designatedAreaCode>("designatedAreaCode"));
+        cols.push_back(col<&T::functionalId>("functionalId"));
+        cols.push_back(col<&T::binaryData>("binaryDataLength"));
+        addTail(cols);
+    }
+
+    {   // 类型9：标准搜救飞机位置报告
+        auto &cols = schemas[9];
+        using T = StandardSARAircraftReport;
+        addHead(cols);
+        cols.push_back(col<&T::altitude>("altitude"));
+        cols.push_back(col<&T::speedOverGround, 1>("speedOverGround"));
+        cols.push_back(col<&T::positionAccuracy>("positionAccuracy"));
+        cols.push_back(col<&T::longitude, 6>("longitude"));
+        cols.push_back(col<&T::latitude, 6>("latitude"));
+        cols.push_back(col<&T::courseOverGround, 1>("courseOverGround"));
+        cols.push_back(col<&T::timestampUTC>("timestampUTC"));
+        cols.push_back(col<&T::spare>("spare"));
+        cols.push_back(col<&T::assignedModeFlag>("assignedModeFlag"));
+        cols.push_back(col<&T::raimFlag>("raimFlag"));
+        cols.push_back(col<&T::communicationState>("communicationState"));
+        addTail(cols);
+    }
+
+    {   // 类型10：UTC和日期询问
+        auto &cols = schemas[10];
+        using T = UTCDateInquiry;
+        addHead(cols);
+        cols.push_back(col<&T::spare1>("spare1"));
+        cols.push_back(col<&T::destinationMmsi>("destinationMmsi"));
+        cols.push_back(col<&T::spare2>("spare2"));
+        addTail(cols);
+    }
+
+    schemas[11] = utcPositionColumns<UTCDateResponse>();
+
+    {   // 类型12：安全相关编址消息
+        auto &cols = schemas[12];
+        using T = AddressedSafetyMessage;
+        addHead(cols);
+        cols.push_back(col<&T::sequenceNumber>("sequenceNumber"));
+        cols.push_back(col<&T::destinationMmsi>("destinationMmsi"));
+        cols.push_back(col<&T::retransmitFlag>("retransmitFlag"));
+        cols.push_back(col<&T::spare>("spare"));
+        cols.push_back(col<&T::safetyText>("safetyText"));
+        addTail(cols);
+    }
+
+    {   // 类型13：安全相关确认
+        auto &cols = schemas[13];
+        using T = SafetyAcknowledge;
+        addHead(cols);
+        cols.push_back(col<&T::sequenceNumber>("sequenceNumber"));
+        cols.push_back(col<&T::destinationMmsi1>("destinationMmsi1"));
+        cols.push_back(col<&T::destinationMmsi2>("destinationMmsi2"));
+        cols.push_back(col<&T::destinationMmsi3>("destinationMmsi3"));
+        cols.push_back(col<&T::destinationMmsi4>("destinationMmsi4"));
+        cols.push_back(col<&T::spare>("spare"));
+        addTail(cols);
+    }
+
+    {   // 类型14：安全相关广播消息
+        auto &cols = schemas[14];
+        using T = SafetyRelatedBroadcast;
+        addHead(cols);
+        cols.push_back(col<&T::spare>("spare"));
+        cols.push_back(col<&T::safetyText>("safetyText"));
+        addTail(cols);
+    }
+
+    {   // 类型15：询问
+        auto &cols = schemas[15];
+        using T = Interrogation;
+        addHead(cols);
+        cols.push_back(col<&T::spare1>("spare1"));
+        cols.push_back(col<&T::destinationMmsi1>("destinationMmsi1"));
+        cols.push_back(col<&T::messageType1_1>("messageType1_1"));
+        cols.push_back(col<&T::slotOffset1_1>("slotOffset1_1"));
+        cols.push_back(col<&T::spare2>("spare2"));
+        cols.push_back(col<&T::messageType1_2>("messageType1_2"));
+        cols.push_back(col<&T::slotOffset1_2>("slotOffset1_2"));
+        cols.push_back(col<&T::spare3>("spare3"));
+        cols.push_back(col<&T::destinationMmsi2>("destinationMmsi2"));
+        cols.push_back(col<&T::messageType2>("messageType2"));
+        cols.push_back(col<&T::slotOffset2>("slotOffset2"));
+        cols.push_back(col<&T::spare4>("spare4"));
+        addTail(cols);
+    }
+
+    {   // 类型16：分配模式命令
+        auto &cols = schemas[16];
+        using T = AssignmentModeCommand;
+        addHead(cols);
+        cols.push_back(col<&T::spare1>("spare1"));
+        cols.push_back(col<&T::destinationMmsiA>("destinationMmsiA"));
+        cols.push_back(col<&T::offsetA>("offsetA"));
+        cols.push_back(col<&T::incrementA>("incrementA"));
+        cols.push_back(col<&T::spare2>("spare2"));
+        cols.push_back(col<&T::destinationMmsiB>("destinationMmsiB"));
+        cols.push_back(col<&T::offsetB>("offsetB"));
+        cols.push_back(col<&T::incrementB>("incrementB"));
+        cols.push_back(col<&T::spare3>("spare3"));
+        addTail(cols);
+    }
+
+    {   // 类型17：DGNSS二进制广播消息
+        auto &cols = schemas[17];
+        using T = DGNSSBinaryBroadcast;
+        addHead(cols);
+        cols.push_back(col<&T::spare1>("spare1"));
+        cols.push_back(col<&T::longitude, 6>("longitude"));
+        cols.push_back(col<&T::latitude, 6>("latitude"));
+        cols.push_back(col<&T::spare2>("spare2"));
+        cols.push_back(col<&T::dgnssData>("dgnssDataLength"));
+        addTail(cols);
+    }
+
+    {   // 类型18：标准B类设备位置报告
+        auto &cols = schemas[18];
+        using T = StandardClassBReport;
+        addHead(cols);
+        cols.push_back(col<&T::spare1>("spare1"));
+        cols.push_back(col<&T::speedOverGround, 1>("speedOverGround"));
+        cols.push_back(col<&T::positionAccuracy>("positionAccuracy"));
+        cols.push_back(col<&T::longitude, 6>("longitude"));
+        cols.push_back(col<&T::latitude, 6>("latitude"));
+        cols.push_back(col<&T::courseOverGround, 1>("courseOverGround"));
+        cols.push_back(col<&T::trueHeading>("trueHeading"));
+        cols.push_back(col<&T::timestampUTC>("timestampUTC"));
+        cols.push_back(col<&T::spare2>("spare2"));
+        cols.push_back(col<&T::csUnit>("csUnit"));
+        cols.push_back(col<&T::displayFlag>("displayFlag"));
+        cols.push_back(col<&T::dscFlag>("dscFlag"));
+        cols.push_back(col<&T::bandFlag>("bandFlag"));
+        cols.push_back(col<&T::message22Flag>("message22Flag"));
+        cols.push_back(col<&T::assignedModeFlag>("assignedModeFlag"));
+        cols.push_back(col<&T::raimFlag>("raimFlag"));
+        cols.push_back(col<&T::communicationState>("communicationState"));
+        cols.push_back(col<&T::spare3>("spare3"));
+        addTail(cols);
+    }
+
+    {   // 类型19：扩展B类设备位置报告
+        auto &cols = schemas[19];
+        using T = ExtendedClassBReport;
+        addHead(cols);
+        cols.push_back(col<&T::spare1>("spare1"));
+        cols.push_back(col<&T::speedOverGround, 1>("speedOverGround"));
+        cols.push_back(col<&T::positionAccuracy>("positionAccuracy"));
+        cols.push_back(col<&T::longitude, 6>("longitude"));
+        cols.push_back(col<&T::latitude, 6>("latitude"));
+        cols.push_back(col<&T::courseOverGround, 1>("courseOverGround"));
+        cols.push_back(col<&T::trueHeading>("trueHeading"));
+        cols.push_back(col<&T::timestampUTC>("timestampUTC"));
+        cols.push_back(col<&T::spare2>("spare2"));
+        cols.push_back(col<&T::vesselName>("vesselName"));
+        cols.push_back(col<&T::shipType>("shipType"));
+        cols.push_back(col<&T::dimensionToBow>("dimensionToBow"));
+        cols.push_back(col<&T::dimensionToStern>("dimensionToStern"));
+        cols.push_back(col<&T::dimensionToPort>("dimensionToPort"));
+        cols.push_back(col<&T::dimensionToStarboard>("dimensionToStarboard"));
+        cols.push_back(col<&T::epfdType>("epfdType"));
+        cols.push_back(col<&T::spare3>("spare3"));
+        cols.push_back(col<&T::raimFlag>("raimFlag"));
+        cols.push_back(col<&T::dte>("dte"));
+        cols.push_back(col<&T::assignedModeFlag>("assignedModeFlag"));
+        cols.push_back(col<&T::spare4>("spare4"));
+        addTail(cols);
+    }
+
+    {   // 类型20：数据链路管理消息
+        auto &cols = schemas[20];
+        using T = DataLinkManagement;
+        addHead(cols);
+        cols.push_back(col<&T::spare1>("spare1"));
+        cols.push_back(col<&T::offsetNumber1>("offsetNumber1"));
+        cols.push_back(col<&T::reservedSlots1>("reservedSlots1"));
+        cols.push_back(col<&T::timeout1>("timeout1"));
+        cols.push_back(col<&T::increment1>("increment1"));
+        cols.push_back(col<&T::offsetNumber2>("offsetNumber2"));
+        cols.push_back(col<&T::reservedSlots2>("reservedSlots2"));
+        cols.push_back(col<&T::timeout2>("timeout2"));
+        cols.push_back(col<&T::increment2>("increment2"));
+        cols.push_back(col<&T::offsetNumber3>("offsetNumber3"));
+        cols.push_back(col<&T::reservedSlots3>("reservedSlots3"));
+        cols.push_back(col<&T::timeout3>("timeout3"));
+        cols.push_back(col<&T::increment3>("increment3"));
+        cols.push_back(col<&T::offsetNumber4>("offsetNumber4"));
+        cols.push_back(col<&T::reservedSlots4>("reservedSlots4"));
+        cols.push_back(col<&T::timeout4>("timeout4"));
+        cols.push_back(col<&T::increment4>("increment4"));
+        cols.push_back(col<&T::spare2>("spare2"));
+        addTail(cols);
+    }
+
+    {   // 类型21：助航设备报告
+        auto &cols = schemas[21];
+        using T = AidToNavigationReport;
+        addHead(cols);
+        cols.push_back(col<&T::aidType>("aidType"));
+        cols.push_back(col<&T::name>("name"));
+        cols.push_back(col<&T::positionAccuracy>("positionAccuracy"));
+        cols.push_back(col<&T::longitude, 6>("longitude"));
+        cols.push_back(col<&T::latitude, 6>("latitude"));
+        cols.push_back(col<&T::dimensionToBow>("dimensionToBow"));
+        cols.push_back(col<&T::dimensionToStern>("dimensionToStern"));
+        cols.push_back(col<&T::dimensionToPort>("dimensionToPort"));
+        cols.push_back(col<&T::dimensionToStarboard>("dimensionToStarboard"));
+        cols.push_back(col<&T::epfdType>("epfdType"));
+        cols.push_back(col<&T::timestampUTC>("timestampUTC"));
+        cols.push_back(col<&T::offPositionIndicator>("offPositionIndicator"));
+        cols.push_back(col<&T::regional>("regional"));
+        cols.push_back(col<&T::raimFlag>("raimFlag"));
+        cols.push_back(col<&T::virtualAidFlag>("virtualAidFlag"));
+        cols.push_back(col<&T::assignedModeFlag>("assignedModeFlag"));
+        cols.push_back(col<&T::nameExtension>("nameExtension"));
+        cols.push_back(col<&T::spare>("spare"));
+        addTail(cols);
+    }
+
+    {   // 类型22：信道管理
+        auto &cols = schemas[22];
+        using T = ChannelManagement;
+        addHead(cols);
+        cols.push_back(col<&T::spare1>("spare1"));
+        cols.push_back(col<&T::channelA>("channelA"));
+        cols.push_back(col<&T::channelB>("channelB"));
+        cols.push_back(col<&T::txRxMode>("txRxMode"));
+        cols.push_back(col<&T::power>("power"));
+        cols.push_back(col<&T::longitude1, 6>("longitude1"));
+        cols.push_back(col<&T::latitude1, 6>("latitude1"));
+        cols.push_back(col<&T::longitude2, 6>("longitude2"));
+        cols.push_back(col<&T::latitude2, 6>("latitude2"));
+        cols.push_back(col<&T::addressedOrBroadcast>("addressedOrBroadcast"));
+        cols.push_back(col<&T::bandwidthA>("bandwidthA"));
+        cols.push_back(col<&T::bandwidthB>("bandwidthB"));
+        cols.push_back(col<&T::zoneSize>("zoneSize"));
+        cols.push_back(col<&T::spare2>("spare2"));
+        addTail(cols);
+    }
+
+    {   // 类型23：组分配命令
+        auto &cols = schemas[23];
+        using T = GroupAssignmentCommand;
+        addHead(cols);
+        cols.push_back(col<&T::spare1>("spare1"));
+        cols.push_back(col<&T::longitude1, 6>("longitude1"));
+        cols.push_back(col<&T::latitude1, 6>("latitude1"));
+        cols.push_back(col<&T::longitude2, 6>("longitude2"));
+        cols.push_back(col<&T::latitude2, 6>("latitude2"));
+        cols.push_back(col<&T::stationType>("stationType"));
+        cols.push_back(col<&T::shipType>("shipType"));
+        cols.push_back(col<&T::txRxMode>("txRxMode"));
+        cols.push_back(col<&T::reportingInterval>("reportingInterval"));
+        cols.push_back(col<&T::quietTime>("quietTime"));
+        cols.push_back(col<&T::spare2>("spare2"));
+        addTail(cols);
+    }
+
+    {   // 类型24：静态数据报告（A/B两部分共用同一列结构，未使用部分输出默认值）
+        auto &cols = schemas[24];
+        using T = StaticDataReport;
+        addHead(cols);
+        cols.push_back(col<&T::partNumber>("partNumber"));
+        cols.push_back(col<&T::vesselName>("vesselName"));
+        cols.push_back(col<&T::shipType>("shipType"));
+        cols.push_back(col<&T::vendorId>("vendorId"));
+        cols.push_back(col<&T::callSign>("callSign"));
+        cols.push_back(col<&T::dimensionToBow>("dimensionToBow"));
+        cols.push_back(col<&T::dimensionToStern>("dimensionToStern"));
+        cols.push_back(col<&T::dimensionToPort>("dimensionToPort"));
+        cols.push_back(col<&T::dimensionToStarboard>("dimensionToStarboard"));
+        cols.push_back(col<&T::mothershipMmsi>("mothershipMmsi"));
+        cols.push_back(col<&T::spare>("spare"));
+        addTail(cols);
+    }
+
+    {   // 类型25：单时隙二进制消息
+        auto &cols = schemas[25];
+        using T = SingleSlotBinaryMessage;
+        addHead(cols);
+        addSlotBinaryColumns<T>(cols);
+        cols.push_back(col<&T::spare>("spare"));
+        addTail(cols);
+    }
+
+    {   // 类型26：多时隙二进制消息
+        auto &cols = schemas[26];
+        using T = MultipleSlotBinaryMessage;
+        addHead(cols);
+        addSlotBinaryColumns<T>(cols);
+        cols.push_back(col<&T::commStateFlag>("commStateFlag"));
+        cols.push_back(col<&T::spare>("spare"));
+        addTail(cols);
+    }
+
+    {   // 类型27：长距离位置报告
+        auto &cols = schemas[27];
+        using T = LongRangePositionReport;
+        addHead(cols);
+        cols.push_back(col<&T::positionAccuracy>("positionAccuracy"));
+        cols.push_back(col<&T::raimFlag>("raimFlag"));
+        cols.push_back(col<&T::navigationStatus>("navigationStatus"));
+        cols.push_back(col<&T::longitude, 6>("longitude"));
+        cols.push_back(col<&T::latitude, 6>("latitude"));
+        cols.push_back(col<&T::speedOverGround, 1>("speedOverGround"));
+        cols.push_back(col<&T::courseOverGround, 1>("courseOverGround"));
+        cols.push_back(col<&T::gnssPositionStatus>("gnssPositionStatus"));
+        cols.push_back(col<&T::assignedModeFlag>("assignedModeFlag"));
+        cols.push_back(col<&T::spare>("spare"));
+        addTail(cols);
+    }
+
+    return schemas;
+}
+
+const std::vector<std::vector<CsvColumn>> &allSchemas()
+{
+    static const std::vector<std::vector<CsvColumn>> schemas = buildSchemas();
+    return schemas;
+}
+
+} // namespace
+
+CsvWriter::CsvWriter(char delimiter) : delimiter_(delimiter)
+{
+    buffer_.reserve(256);
+}
+
+size_t CsvWriter::slotOf(AISMessageType type)
+{
+    size_t slot = static_cast<size_t>(type);
+    return slot < TYPE_SLOTS ? slot : 0;
+}
+
+const std::vector<CsvColumn> &CsvWriter::schema(AISMessageType type)
+{
+    return allSchemas()[slotOf(type)];
+}
+
+std::vector<std::string> CsvWriter::columnNames(AISMessageType type)
+{
+    std::vector<std::string> names;
+    for (const auto &column : schema(type)) {
+        names.emplace_back(column.name);
+    }
+    return names;
+}
+
+void CsvWriter::setProjection(const std::vector<std::string> &columns)
+{
+    projection_ = columns;
+    for (size_t slot = 0; slot < TYPE_SLOTS; ++slot) {
+        auto &indices = projectedIdx_[slot];
+        indices.clear();
+        if (projection_.empty()) {
+            continue;
+        }
+
+        const auto &cols = allSchemas()[slot];
+        for (const auto &name : projection_) {
+            int found = -1;
+            for (size_t i = 0; i < cols.size(); ++i) {
+                if (name == cols[i].name) {
+                    found = static_cast<int>(i);
+                    break;
+                }
+            }
+            indices.push_back(found);
+        }
+    }
+}
+
+std::string CsvWriter::header(AISMessageType type) const
+{
+    std::string line;
+    if (hasProjection()) {
+        for (size_t i = 0; i < projection_.size(); ++i) {
+            if (i > 0) line += delimiter_;
+            line += projection_[i];
+        }
+        return line;
+    }
+
+    const auto &cols = schema(type);
+    for (size_t i = 0; i < cols.size(); ++i) {
+        if (i > 0) line += delimiter_;
+        line += cols[i].name;
+    }
+    return line;
+}
+
+std::string CsvWriter::schemaPreamble() const
+{
+    std::string text = "#schema";
+    text += delimiter_;
+    text += std::to_string(SCHEMA_VERSION);
+    text += '\n';
+
+    if (hasProjection()) {
+        text += '#';
+        text += header(AISMessageType::UNKNOWN);
+        text += '\n';
+        return text;
+    }
+
+    for (size_t slot = 1; slot < TYPE_SLOTS; ++slot) {
+        text += '#';
+        text += std::to_string(slot);
+        text += delimiter_;
+        text += header(static_cast<AISMessageType>(slot));
+        text += '\n';
+    }
+    return text;
+}
+
+const std::string &CsvWriter::write(const AISMessage &msg)
+{
+    buffer_.clear();
+    append(msg, buffer_);
+    return buffer_;
+}
+
+void CsvWriter::append(const AISMessage &msg, std::string &out)
+{
+    out_ = &out;
+    const size_t slot = slotOf(msg.type);
+    const auto &cols = allSchemas()[slot];
+
+    if (!hasProjection()) {
+        for (size_t i = 0; i < cols.size(); ++i) {
+            if (i > 0) out.push_back(delimiter_);
+            cols[i].write(*this, msg);
+        }
+    } else {
+        const auto &indices = projectedIdx_[slot];
+        for (size_t i = 0; i < indices.size(); ++i) {
+            if (i > 0) out.push_back(delimiter_);
+            if (indices[i] >= 0) {
+                cols[indices[i]].write(*this, msg);
+            }
+        }
+    }
+    out_ = nullptr;
+}
+
+/************* 列值写出接口 *************/
+
+void CsvWriter::appendValue(int value)
+{
+    char tmp[16];
+    auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    out_->append(tmp, result.ptr);
+}
+
+void CsvWriter::appendValue(uint32_t value)
+{
+    char tmp[16];
+    auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    out_->append(tmp, result.ptr);
+}
+
+void CsvWriter::appendValue(uint64_t value)
+{
+    char tmp[24];
+    auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    out_->append(tmp, result.ptr);
+}
+
+void CsvWriter::appendValue(bool value)
+{
+    out_->push_back(value ? '1' : '0');
+}
+
+void CsvWriter::appendValue(double value, int precision)
+{
+    char tmp[64];
+    auto result = std::to_chars(tmp, tmp + sizeof(tmp), value, std::chars_format::fixed, precision);
+    if (result.ec == std::errc()) {
+        out_->append(tmp, result.ptr);
+    }
+}
+
+void CsvWriter::appendValue(const std::string &value)
+{
+    // 字符串字段统一加引号
+    appendQuoted(*out_, value);
+}
+
+void CsvWriter::appendValue(AISMessageType value)
+{
+    appendValue(static_cast<int>(value));
+}
+
+void CsvWriter::appendQuoted(std::string &out, std::string_view value)
+{
+    out.push_back('"');
+    for (char c : value) {
+        if (c == '"') out.push_back('"');
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+} // namespace ais
@@ -0,0 +1,125 @@
+#include "utils/dead_reckoning.h"
+
+#include "utils/geo_math.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ais
+{
+
+namespace
+{
+
+using geo::DEG_TO_RAD;
+using geo::RAD_TO_DEG;
+
+bool validPosition(const VesselState &state)
+{
+    return state.hasPosition() &&
+           state.latitude >= -90.0 && state.latitude <= 90.0 &&
+           state.longitude >= -180.0 && state.longitude <= 180.0;
+}
+
+/**
+ * @brief 航速、航向均可用且非静止
+ */
+bool moving(const VesselState &state)
+{
+    return state.speedOverGround >= DeadReckoning::MIN_SPEED_KN && state.speedOverGround < 102.2 &&
+           state.courseOverGround >= 0.0 && state.courseOverGround < 360.0;
+}
+
+double normalizeCourse(double course)
+{
+    course = std::fmod(course, 360.0);
+    return course < 0.0 ? course + 360.0 : course;
+}
+
+} // namespace
+
+void DeadReckoning::destination(double &latitude, double &longitude, double bearingDeg, double distanceM)
+{
+    const double delta = distanceM / EARTH_RADIUS_M;
+    const double theta = bearingDeg * DEG_TO_RAD;
+    const double phi1 = latitude * DEG_TO_RAD;
+    const double lambda1 = longitude * DEG_TO_RAD;
+
+    const double sinPhi1 = std::sin(phi1);
+    const double cosPhi1 = std::cos(phi1);
+    const double sinDelta = std::sin(delta);
+    const double cosDelta = std::cos(delta);
+
+    const double sinPhi2 = std::clamp(sinPhi1 * cosDelta + cosPhi1 * sinDelta * std::cos(theta), -1.0, 1.0);
+    const double phi2 = std::asin(sinPhi2);
+    const double lambda2 = lambda1 + std::atan2(std::sin(theta) * sinDelta * cosPhi1, cosDelta - sinPhi1 * sinPhi2);
+
+    latitude = phi2 * RAD_TO_DEG;
+    longitude = std::fmod(lambda2 * RAD_TO_DEG + 540.0, 360.0) - 180.0;
+}
+
+double DeadReckoning::rotDegPerSec(int rateOfTurn)
+{
+    if (rateOfTurn == -128) {
+        return 0.0;
+    }
+    if (rateOfTurn == 127 || rateOfTurn == -127) {
+        return (rateOfTurn > 0 ? 10.0 : -10.0) / 60.0;
+    }
+    return rateOfTurn / 60.0;
+}
+
+bool DeadReckoning::predict(const VesselState &state, int64_t atMs, int64_t maxHorizonMs, PredictedPosition &out)
+{
+    out = PredictedPosition();
+    out.mmsi = state.mmsi;
+    if (!validPosition(state)) {
+        return false;
+    }
+
+    out.latitude = state.latitude;
+    out.longitude = state.longitude;
+    out.speedOverGround = state.speedOverGround;
+    out.courseOverGround = state.courseOverGround;
+
+    int64_t elapsedMs = atMs - state.positionTimeMs;
+    if (maxHorizonMs > 0) {
+        elapsedMs = std::min(elapsedMs, maxHorizonMs);
+    }
+    if (elapsedMs <= 0 || !moving(state)) {
+        return true;
+    }
+    out.elapsedMs = elapsedMs;
+    out.extrapolated = true;
+
+    const double seconds = elapsedMs / 1000.0;
+    const double speedMs = state.speedOverGround * KNOT_MS;
+    const double rot = rotDegPerSec(state.rateOfTurn);
+
+    if (rot == 0.0) {
+        destination(out.latitude, out.longitude, state.courseOverGround, speedMs * seconds);
+        return true;
+    }
+
+    // 等速转向：分段推进，每段取段中点航向
+    double course = state.courseOverGround;
+    for (double done = 0.0; done < seconds; done += ROT_STEP_SEC) {
+        const double step = std::min(ROT_STEP_SEC, seconds - done);
+        destination(out.latitude, out.longitude, course + rot * step * 0.5, speedMs * step);
+        course += rot * step;
+    }
+    out.courseOverGround = normalizeCourse(course);
+    return true;
+}
+
+size_t DeadReckoning::predictBatch(const VesselState *states, size_t count, int64_t atMs, int64_t maxHorizonMs,
+                                   PredictedPosition *out)
+{
+    size_t valid = 0;
+    for (size_t i = 0; i < count; ++i) {
+        valid += predict(states[i], atMs, maxHorizonMs, out[i]) ? 1 : 0;
+    }
+    return valid;
+}
+
+} // namespace ais
@@ -0,0 +1,125 @@
+#include "utils/message_fields.h"
+
+#include "messages/type_definitions.h"
+
+namespace ais
+{
+
+namespace
+{
+
+template <class T>
+void fillClassA(const T &m, PositionFields &out)
+{
+    out.longitude = m.longitude;
+    out.latitude = m.latitude;
+    out.speedOverGround = m.speedOverGround;
+    out.courseOverGround = m.courseOverGround;
+    out.trueHeading = m.trueHeading;
+    out.rateOfTurn = m.rateOfTurn;
+    out.navigationStatus = m.navigationStatus;
+    out.positionAccuracy = m.positionAccuracy;
+    out.hasKinematics = true;
+    out.utcSecond = m.timestampUTC;
+}
+
+template <class T>
+void fillClassB(const T &m, PositionFields &out)
+{
+    out.longitude = m.longitude;
+    out.latitude = m.latitude;
+    out.speedOverGround = m.speedOverGround;
+    out.courseOverGround = m.courseOverGround;
+    out.trueHeading = m.trueHeading;
+    out.positionAccuracy = m.positionAccuracy;
+    out.hasKinematics = true;
+    out.utcSecond = m.timestampUTC;
+}
+
+template <class T>
+void fillFixed(const T &m, PositionFields &out)
+{
+    out.longitude = m.longitude;
+    out.latitude = m.latitude;
+    out.positionAccuracy = m.positionAccuracy;
+}
+
+} // namespace
+
+bool isVesselPositionType(AISMessageType type)
+{
+    switch (type)
+    {
+    case AISMessageType::POSITION_REPORT_CLASS_A:
+    case AISMessageType::POSITION_REPORT_CLASS_A_ASSIGNED:
+    case AISMessageType::POSITION_REPORT_CLASS_A_RESPONSE:
+    case AISMessageType::STANDARD_CLASS_B_CS_POSITION:
+    case AISMessageType::EXTENDED_CLASS_B_CS_POSITION:
+    case AISMessageType::POSITION_REPORT_LONG_RANGE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool extractPosition(const AISMessage &msg, PositionFields &out)
+{
+    out = PositionFields();
+
+    switch (msg.type)
+    {
+    case AISMessageType::POSITION_REPORT_CLASS_A:
+        fillClassA(static_cast<const PositionReport &>(msg), out);
+        break;
+    case AISMessageType::POSITION_REPORT_CLASS_A_ASSIGNED:
+        fillClassA(static_cast<const PositionReportAssigned &>(msg), out);
+        break;
+    case AISMessageType::POSITION_REPORT_CLASS_A_RESPONSE:
+        fillClassA(static_cast<const PositionReportResponse &>(msg), out);
+        break;
+    case AISMessageType::STANDARD_CLASS_B_CS_POSITION:
+        fillClassB(static_cast<const StandardClassBReport &>(msg), out);
+        break;
+    case AISMessageType::EXTENDED_CLASS_B_CS_POSITION:
+        fillClassB(static_cast<const ExtendedClassBReport &>(msg), out);
+        break;
+    case AISMessageType::POSITION_REPORT_LONG_RANGE:
+    {
+        const auto &m = static_cast<const LongRangePositionReport &>(msg);
+        out.longitude = m.longitude;
+        out.latitude = m.latitude;
+        out.speedOverGround = m.speedOverGround;
+        out.courseOverGround = m.courseOverGround;
+        out.navigationStatus = m.navigationStatus;
+        out.positionAccuracy = m.positionAccuracy;
+        out.hasKinematics = true;
+        break;
+    }
+    case AISMessageType::BASE_STATION_REPORT:
+        fillFixed(static_cast<const BaseStationReport &>(msg), out);
+        break;
+    case AISMessageType::STANDARD_SAR_AIRCRAFT_REPORT:
+    {
+        const auto &m = static_cast<const StandardSARAircraftReport &>(msg);
+        fillFixed(m, out);
+        out.speedOverGround = m.speedOverGround;
+        out.courseOverGround = m.courseOverGround;
+        out.hasKinematics = true;
+        out.utcSecond = m.timestampUTC;
+        break;
+    }
+    case AISMessageType::UTC_DATE_RESPONSE:
+        fillFixed(static_cast<const UTCDateResponse &>(msg), out);
+        break;
+    case AISMessageType::AID_TO_NAVIGATION_REPORT:
+        fillFixed(static_cast<const AidToNavigationReport &>(msg), out);
+        break;
+    default:
+        return false;
+    }
+
+    return out.latitude >= -90.0 && out.latitude <= 90.0 &&
+           out.longitude >= -180.0 && out.longitude <= 180.0;
+}
+
+} // namespace ais
@@ -0,0 +1,179 @@
+#include "utils/vessel_state.h"
+
+#include "messages/type_definitions.h"
+#include "utils/csv_writer.h"
+#include "utils/message_fields.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace ais
+{
+
+namespace
+{
+
+/**
+ * @brief 复制文本到定长数组，去除AIS填充的'@'和尾部空格；空文本不覆盖已有值
+ */
+template <size_t N>
+void copyText(char (&dst)[N], const std::string &src)
+{
+    size_t len = std::min(src.find('@'), src.size());
+    while (len > 0 && src[len - 1] == ' ') {
+        len--;
+    }
+    if (len == 0) {
+        return;
+    }
+    len = std::min(len, N - 1);
+    std::memcpy(dst, src.data(), len);
+    dst[len] = '\0';
+}
+
+template <class T>
+void copyDimensions(VesselState &state, const T &m)
+{
+    state.dimensionToBow = static_cast<uint16_t>(m.dimensionToBow);
+    state.dimensionToStern = static_cast<uint16_t>(m.dimensionToStern);
+    state.dimensionToPort = static_cast<uint8_t>(m.dimensionToPort);
+    state.dimensionToStarboard = static_cast<uint8_t>(m.dimensionToStarboard);
+}
+
+} // namespace
+
+bool VesselState::accepts(AISMessageType type)
+{
+    return isVesselPositionType(type) ||
+           type == AISMessageType::STATIC_VOYAGE_DATA ||
+           type == AISMessageType::STATIC_DATA_REPORT;
+}
+
+bool VesselState::update(const AISMessage &msg, int64_t timeMs)
+{
+    if (mmsi == 0) {
+        mmsi = msg.mmsi;
+    }
+
+    bool used = false;
+
+    if (isVesselPositionType(msg.type)) {
+        PositionFields pos;
+        if (extractPosition(msg, pos)) {
+            longitude = pos.longitude;
+            latitude = pos.latitude;
+            speedOverGround = pos.speedOverGround;
+            courseOverGround = pos.courseOverGround;
+            trueHeading = static_cast<int16_t>(pos.trueHeading);
+            rateOfTurn = static_cast<int16_t>(pos.rateOfTurn);
+            positionAccuracy = pos.positionAccuracy;
+            positionType = msg.type;
+            classB = msg.type == AISMessageType::STANDARD_CLASS_B_CS_POSITION ||
+                     msg.type == AISMessageType::EXTENDED_CLASS_B_CS_POSITION;
+            positionTimeMs = timeMs;
+
+            // B类报告不携带导航状态，保留之前的值
+            if (!classB) {
+                navigationStatus = static_cast<uint8_t>(pos.navigationStatus);
+                navStatusTimeMs = timeMs;
+            }
+            used = true;
+        }
+    }
+
+    switch (msg.type)
+    {
+    case AISMessageType::STATIC_VOYAGE_DATA:
+    {
+        const auto &m = static_cast<const StaticVoyageData &>(msg);
+        imoNumber = static_cast<uint32_t>(m.imoNumber);
+        copyText(callSign, m.callSign);
+        copyText(vesselName, m.vesselName);
+        identityTimeMs = timeMs;
+
+        shipType = static_cast<uint8_t>(m.shipType);
+        copyDimensions(*this, m);
+        shipDataTimeMs = timeMs;
+
+        draught = m.draught;
+        copyText(destination, m.destination);
+        etaMonth = static_cast<uint8_t>(m.month);
+        etaDay = static_cast<uint8_t>(m.day);
+        etaHour = static_cast<uint8_t>(m.hour);
+        etaMinute = static_cast<uint8_t>(m.minute);
+        voyageTimeMs = timeMs;
+        used = true;
+        break;
+    }
+    case AISMessageType::EXTENDED_CLASS_B_CS_POSITION:
+    {
+        const auto &m = static_cast<const ExtendedClassBReport &>(msg);
+        copyText(vesselName, m.vesselName);
+        identityTimeMs = timeMs;
+        shipType = static_cast<uint8_t>(m.shipType);
+        copyDimensions(*this, m);
+        shipDataTimeMs = timeMs;
+        used = true;
+        break;
+    }
+    case AISMessageType::STATIC_DATA_REPORT:
+    {
+        // 24号消息分A（船名）、B（类型/呼号/尺寸）两部分分别发送
+        const auto &m = static_cast<const StaticDataReport &>(msg);
+        if (m.partNumber == 0) {
+            copyText(vesselName, m.vesselName);
+        } else {
+            copyText(callSign, m.callSign);
+            shipType = static_cast<uint8_t>(m.shipType);
+            copyDimensions(*this, m);
+            shipDataTimeMs = timeMs;
+        }
+        identityTimeMs = timeMs;
+        used = true;
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (used) {
+        lastUpdateMs = std::max(lastUpdateMs, timeMs);
+        messageCount++;
+    }
+    return used;
+}
+
+std::string VesselState::toCsv() const
+{
+    // 文本字段可能含引号，按CSV规则转义
+    std::string name;
+    std::string call;
+    std::string dest;
+    CsvWriter::appendQuoted(name, vesselName);
+    CsvWriter::appendQuoted(call, callSign);
+    CsvWriter::appendQuoted(dest, destination);
+
+    std::ostringstream oss;
+    oss << mmsi << ","
+        << std::fixed << std::setprecision(6) << latitude << ","
+        << std::fixed << std::setprecision(6) << longitude << ","
+        << std::fixed << std::setprecision(1) << speedOverGround << ","
+        << std::fixed << std::setprecision(1) << courseOverGround << ","
+        << trueHeading << ","
+        << static_cast<int>(navigationStatus) << ","
+        << name << ","
+        << call << ","
+        << imoNumber << ","
+        << static_cast<int>(shipType) << ","
+        << length() << ","
+        << width() << ","
+        << std::fixed << std::setprecision(1) << draught << ","
+        << dest << ","
+        << positionTimeMs << ","
+        << std::max(identityTimeMs, shipDataTimeMs);
+    return oss.str();
+}
+
+} // namespace ais
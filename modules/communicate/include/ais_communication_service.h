@@ -4,13 +4,32 @@
 #include "udp-tcp-communicate/communicate_api.h"
 
 #include "ais_parser.h"
+#include "ais_storage.h"
+#include "collision_risk.h"
 #include "config.h"
-#include "lru.h"
+#include "deadband_filter.h"
+#include "flat_lru.h"
+#include "geofence_engine.h"
+#include "kinematic_validator.h"
+#include "live_spatial_index.h"
+#include "pipeline_stats.h"
+#include "sharded_lru.h"
+#include "situation_publisher.h"
+#include "utils/binary_codec.h"
+#include "utils/bounded_queue.h"
+#include "utils/csv_writer.h"
+#include "utils/dead_reckoning.h"
+#include "utils/vessel_state.h"
+#include "vessel_snapshot.h"
 
+#include <array>
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <unordered_map>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ais {
 
@@ -19,10 +38,47 @@ namespace ais {
  * 
  * 负责订阅AIS数据，使用外部提供的AISParser解析数据，
  * 生成船舶综合态势信息并周期性发送到指定目标地址
+ * 
+ * 配置workerThreads > 0时按流水线处理：接收回调只把原始数据放入无锁队列，
+ * 工作线程池解析并更新船舶状态，转发数据交给独立的发送线程，接收回调不被慢操作阻塞；
+ * workerThreads为0时在接收回调线程中同步完成全部处理
+ * 
+ * 配置publishIntervalMs > 0时不再逐条转发，由维护线程按周期发送船舶态势：只发送上一帧以来有变化的船舶
+ * 及其变化的字段，每keyframeInterval帧发送一次全量关键帧（格式见SituationPublisher），输出速率与输入突发无关
+ * 
+ * 配置deadbandDistanceM > 0时逐条转发前按船舶做死区过滤：位置、航速、航向、导航状态相对上次转发均在阈值内的
+ * 位置报告不转发，超过deadbandMaxSilenceSec未转发时补发一次；过滤器每个工作线程一份，多个工作线程时强制按MMSI分片
+ * 
+ * 配置sendBatchBytes > 0时发送线程把多条转发记录合成一个数据报，达到大小上限或最早一条等待超过
+ * sendBatchDelayMs时发出（同步模式下也会启动发送线程）；CSV记录以'\n'分隔，二进制记录首尾相接
+ * 
+ * 同时配置shardByMmsi时，接收回调只解析语句头取得MMSI，按MMSI哈希分发到各工作线程自己的队列，
+ * 每个工作线程独占船舶缓存中的若干分片，同一船舶始终由同一线程按到达顺序处理，写路径上没有跨线程竞争；
+ * 查询接口仍逐分片汇总
+ * 
+ * 配置spatialCellDeg > 0时随位置报告增量维护实时船位网格索引（见LiveSpatialIndex），
+ * getVesselsInBox/getVesselsInRadius/getNearestVessels只访问查询区域相交的单元格，不扫描整表
+ * 
+ * 同时配置cpaRangeNm > 0时由维护线程按cpaIntervalMs周期计算会遇风险（见CollisionRiskEngine），
+ * 只计算上一周期以来有位置更新的船舶与其网格邻船组成的船对；告警产生/解除事件随转发数据发出，
+ * 配置alertPort时另发一份到本地该端口，并回调onCollisionAlert
+ * 
+ * 配置geofenceFile时每条位置报告在处理线程中做电子围栏判断（见GeofenceEngine），进入/离开/停留事件
+ * 与告警事件同样发出并回调onGeofenceEvent；维护线程每geofenceReloadSec检查区域文件，修改后热加载
+ * 
+ * 配置anomalyAction时每条位置报告在解析后、进入船舶状态前做运动学校验（见KinematicValidator），
+ * 异常事件与告警事件同样发出并回调onAnomaly；QUARANTINE时异常报告不更新船舶状态，也不转发和存储；
+ * 多个工作线程时强制按MMSI分片，保证同一船舶的报告按到达顺序校验。报告时刻由接收时间和报告中的UTC秒还原，
+ * 只适用于接收时延小于1分钟的数据源（卫星AIS、延迟转发或回放旧数据时不应启用）
  */
 class AISCommunicationService : public communicate::SubscribebBase
 {
 public:
+    static constexpr int EXPIRE_TICK_MS = 1000;         // 船舶超时检查周期
+    static constexpr size_t EXPIRE_BATCH = 1024;        // 每个分片单次最多淘汰的船舶数
+    static constexpr int IDLE_SPIN = 64;                // 流水线线程空闲时先让出CPU的次数
+    static constexpr int IDLE_SLEEP_US = 200;           // 之后每次休眠时长
+
     /**
      * @brief 构造函数
      * @param aisParser 外部提供的AIS解析器指针
@@ -39,6 +95,13 @@ public:
      */
     int initialize(const CommunicateCfg& commCfg, const std::string& configPath = "");
 
+    /**
+     * @brief 启用本地存储（需在initialize之前调用）
+     * @param saveCfg 存储配置
+     * @return 成功或未启用存储返回0，失败返回错误码
+     */
+    int enableStorage(const AISSaveCfg& saveCfg);
+
     /**
      * @brief 销毁重置服务信息
      */
@@ -60,30 +123,288 @@ public:
      */
     size_t getShipCount() const;
 
+    /**
+     * @brief 查询单船综合状态
+     * @param mmsi 船舶MMSI
+     * @param state [out] 状态副本
+     * @return 船舶存在时返回true
+     */
+    bool getVesselState(uint32_t mmsi, VesselState &state) const;
+
+    /**
+     * @brief 获取所有船舶综合状态（按最近更新从新到旧）
+     */
+    std::vector<VesselState> getVesselStates() const;
+
+    /**
+     * @brief 获取船舶状态表的只读快照
+     * @return 快照指针，调用方可长期持有，不阻塞接收线程
+     *
+     * @note 启用周期刷新(snapshotIntervalMs > 0)时返回最近一次发布的快照，无锁；
+     *       未启用时在调用时重新生成
+     */
+    std::shared_ptr<const VesselSnapshot> getVesselSnapshot() const;
+
+    /**
+     * @brief 推算单船在指定时刻的位置（按最后位置、航速、航向和转向率沿大圆外推）
+     * @param mmsi 船舶MMSI
+     * @param atMs 目标时刻（system_clock毫秒，与接收时间同一时钟）
+     * @param out [out] 推算结果，外推时长不超过predictHorizonSec
+     * @return 船舶存在且有有效位置时返回true
+     */
+    bool predictPosition(uint32_t mmsi, int64_t atMs, PredictedPosition &out) const;
+
+    /**
+     * @brief 推算所有有位置的船舶在指定时刻的位置（按MMSI升序）
+     * @param atMs 目标时刻（system_clock毫秒）
+     *
+     * @note 在船舶状态快照上批量计算，不访问缓存分片锁
+     */
+    std::vector<PredictedPosition> predictPositions(int64_t atMs) const;
+
+    /**
+     * @brief 查询矩形范围内的船舶（spatialCellDeg > 0 时可用，否则返回空）
+     * @param west/east 经度范围，west > east 表示跨越180度经线
+     */
+    std::vector<SpatialHit> getVesselsInBox(double south, double west, double north, double east) const;
+
+    /**
+     * @brief 查询以指定点为中心、半径radiusM米内的船舶
+     */
+    std::vector<SpatialHit> getVesselsInRadius(double latitude, double longitude, double radiusM) const;
+
+    /**
+     * @brief 查询距指定点最近的k艘船舶（按距离升序）
+     */
+    std::vector<SpatialHit> getNearestVessels(double latitude, double longitude, size_t k) const;
+
+    /**
+     * @brief 获取因超时丢失的船舶累计数量
+     */
+    uint64_t getLostVesselCount() const { return lostVessels_.load(); }
+
     /**
      * @brief 清空船舶信息
      */
     void clearShipInfo();
 
+    /**
+     * @brief 获取转发CSV的列结构说明（可在数据流开头下发一次）
+     * @return 表头说明字符串
+     */
+    std::string getCsvSchema() const;
+
+    /**
+     * @brief 获取接收处理流水线各级统计
+     */
+    PipelineStats getPipelineStats() const;
+
+    /**
+     * @brief 获取本地存储统计（未启用存储时各项为0）
+     */
+    StorageStats getStorageStats() const;
+
+    /**
+     * @brief 获取本地存储实例（MEMORY类型可转换为MemoryRingStorage做回看查询）
+     * @return 未启用存储时返回nullptr
+     */
+    std::shared_ptr<AISStorage> getStorage() const { return storage_; }
+
+    /**
+     * @brief 获取最近的运动学异常记录（从旧到新，未启用校验时为空）
+     */
+    std::vector<Anomaly> getRecentAnomalies() const;
+
 protected:
+    /**
+     * @brief 处理线程的转发上下文（CSV序列化器、二进制缓冲区和死区过滤器不能跨线程共享，每个处理线程一份）
+     */
+    struct ForwardContext
+    {
+        CsvWriter csvWriter;
+        std::string binaryBuffer;
+        std::unique_ptr<DeadbandFilter> deadband;   // 未启用死区过滤时为空
+    };
+
     /**
      * @brief 处理AIS消息并更新船舶信息
      * @param aisMsg AIS消息
+     * @param receiveMs 接收时间（毫秒）
+     * @param ctx 当前处理线程的转发上下文
      * 
-     * @note 当前存入到shipInfoMap_中，按csv格式存储(额外处理，可自定义实现)
+     * @note 合并到shipInfoCache_中的船舶综合状态后转发(额外处理，可自定义实现)；
+     *       启用流水线时由多个工作线程并发调用，按MMSI分片时同一船舶只由同一线程调用
      */
-    virtual void processAISMessage(const AISMessage& aisMsg);
+    virtual void processAISMessage(const AISMessage& aisMsg, int64_t receiveMs, ForwardContext& ctx);
+
+    /**
+     * @brief 转发一条数据：启用发送线程时放入发送队列，否则直接发送
+     */
+    void forward(const char* payload, size_t size, uint32_t mmsi);
+
+    /**
+     * @brief 船舶从缓存中淘汰时调用（超时即船舶丢失，或超过缓存容量）
+     * @param state 被淘汰船舶的最后状态
+     * @param reason 淘汰原因
+     *
+     * @note 在缓存分片锁内调用，实现中不得再访问shipInfoCache_；默认实现记录日志
+     */
+    virtual void onVesselEvicted(const VesselState& state, EvictReason reason);
+
+    /**
+     * @brief 碰撞风险告警产生或解除时调用（事件已发出之后）
+     * @param alert 告警事件
+     *
+     * @note 在维护线程中调用；默认实现记录日志
+     */
+    virtual void onCollisionAlert(const CollisionAlert& alert);
+
+    /**
+     * @brief 电子围栏事件产生时调用（事件已发出之后）
+     * @param event 围栏事件
+     *
+     * @note 位置报告触发的事件在处理线程中、缓存分片锁外调用；船舶淘汰产生的离开事件在淘汰回调中、
+     *       分片锁内调用，此时不得再访问shipInfoCache_。默认实现记录日志
+     */
+    virtual void onGeofenceEvent(const GeofenceEvent& event);
+
+    /**
+     * @brief 位置报告校验出运动学异常时调用（事件已发出之后）
+     * @param anomaly 异常记录
+     *
+     * @note 在处理线程中调用；默认实现记录日志
+     */
+    virtual void onAnomaly(const Anomaly& anomaly);
     
-    // LRU缓存管理船舶信息，key为MMSI，value为CSV格式的船舶信息
-    // 使用LRU缓存管理船舶信息，自动控制大小和时效性
-    CLRU<uint32_t, std::string, std::mutex> shipInfoCache_;
+    // LRU缓存管理船舶信息，key为MMSI，value为合并后的船舶综合状态（原地更新）
+    // 按MMSI哈希分片加锁，接收、状态查询等线程访问不同分片时互不阻塞；分片内为扁平存储，预热后更新不分配内存
+    CShardedLRU<uint32_t, VesselState, std::mutex, std::hash<uint32_t>,
+                CFlatLRU<uint32_t, VesselState, std::mutex>> shipInfoCache_;
 
 private:
     std::shared_ptr<AISParser> aisParser_;          // 外部提供的AIS解析器
-    
+    std::shared_ptr<AISStorage> storage_;           // 本地存储（后台线程写入，可为空）
+
+    /**
+     * @brief 接收队列中的原始数据（持有通信库交付的缓冲区，不拷贝）
+     */
+    struct RawMessage
+    {
+        std::shared_ptr<void> data;
+        int64_t receiveUs = 0;      // 接收时刻（steady_clock微秒，用于延迟统计）
+        int64_t receiveMs = 0;      // 接收时间（system_clock毫秒）
+    };
+
+    /**
+     * @brief 发送队列中的待发数据
+     */
+    struct OutboundMessage
+    {
+        std::string payload;
+        int64_t enqueueUs = 0;
+    };
+
+    /**
+     * @brief 解析一条原始数据并处理
+     * @return 解析成功返回0，无法解析或多部分消息未收齐返回1，异常返回-1
+     */
+    int processRaw(const char* aisData, int64_t receiveMs, ForwardContext& ctx);
+
+    /**
+     * @brief 按MMSI选择工作线程：首个分片解析MMSI，多部分消息的后续分片沿用首个分片的选择
+     */
+    size_t routeWorker(const char* aisData);
+
+    void startPipeline(size_t workers, size_t queueSize, bool sharded);
+    void startSender(size_t queueSize);
+    void stopPipeline();
+    void runWorker(size_t index);
+    void runSender();
+
+    /**
+     * @brief 后台维护线程：按EXPIRE_TICK_MS周期分步淘汰超时船舶，按snapshotIntervalMs周期刷新快照，
+     *        按publishIntervalMs周期发布态势
+     */
+    void runMaintenance();
+    void stopMaintenance();
+
+    /**
+     * @brief 逐分片复制船舶状态生成新快照并发布（读者持有的旧快照不受影响）
+     */
+    void refreshSnapshot() const;
+
+    /**
+     * @brief 发出碰撞风险告警事件：随转发数据发送，配置alertPort时另发到本地端口
+     */
+    void publishAlert(const CollisionAlert& alert);
+
+    /**
+     * @brief 发出电子围栏事件（可在多个处理线程中并发调用）
+     */
+    void publishGeofenceEvent(const GeofenceEvent& event);
+
+    /**
+     * @brief 发出运动学异常事件（可在多个处理线程中并发调用）
+     */
+    void publishAnomaly(const Anomaly& anomaly);
+
+    /**
+     * @brief 事件记录随转发数据发送，配置alertPort时另发到本地端口
+     */
+    void sendEvent(const std::string& record, uint32_t mmsi);
+
     // 运行状态
     std::atomic<bool> isInitialized_{false};
 
+    // 后台维护（msgSaveTime > 0 或 snapshotIntervalMs > 0 时启用）
+    std::thread maintThread_;
+    std::mutex maintMutex_;
+    std::condition_variable maintCv_;
+    bool maintStop_ = false;
+    std::atomic<uint64_t> lostVessels_{0};
+
+    // 船舶状态快照：读者通过std::atomic_load取得指针，刷新方原子替换；
+    // 上一份快照无读者持有时作为下次刷新的缓冲复用（双缓冲），否则另行分配
+    mutable std::shared_ptr<const VesselSnapshot> snapshot_;
+    mutable std::shared_ptr<VesselSnapshot> spareSnapshot_;
+    mutable std::mutex snapshotMutex_;              // 仅串行化刷新方
+    mutable uint64_t snapshotVersion_ = 0;
+
+    // 实时船位网格索引（spatialCellDeg > 0 时启用），随位置更新增量维护，船舶淘汰时删除
+    std::unique_ptr<LiveSpatialIndex> spatialIndex_;
+
+    // 碰撞风险计算（cpaRangeNm > 0 且启用网格索引时），告警格式化缓冲区仅维护线程访问
+    std::unique_ptr<CollisionRiskEngine> collision_;
+    std::string alertBuffer_;
+
+    // 电子围栏（geofenceFile非空时启用）
+    std::unique_ptr<GeofenceEngine> geofence_;
+
+    // 运动学校验（anomalyAction非NONE时启用）
+    std::unique_ptr<KinematicValidator> validator_;
+
+    // 态势周期发布（publishIntervalMs > 0 时启用，仅维护线程访问）
+    std::unique_ptr<SituationPublisher> publisher_;
+
+    // 各处理线程的转发上下文：同步模式只用[0]，流水线模式每个工作线程一份
+    std::vector<std::unique_ptr<ForwardContext>> contexts_;
+
+    // 流水线：接收 -> rawQueues_ -> 工作线程池 -> sendQueue_ -> 发送线程
+    // 不分片时所有工作线程共用rawQueues_[0]，按MMSI分片时每个工作线程一个队列
+    std::vector<std::unique_ptr<BoundedQueue<RawMessage>>> rawQueues_;
+    bool sharded_ = false;
+    // 多部分消息路由表，下标为信道(A/B)*10+序号(0-9)，值为首个分片选择的工作线程
+    std::array<std::atomic<uint32_t>, 20> fragmentRoutes_{};
+    std::unique_ptr<BoundedQueue<OutboundMessage>> sendQueue_;
+    std::vector<std::thread> workers_;
+    std::thread sender_;
+    std::atomic<bool> workersRunning_{false};
+    std::atomic<bool> senderRunning_{false};
+    StageCounter receiveStage_;
+    StageCounter parseStage_;
+    StageCounter sendStage_;
+    std::atomic<uint64_t> datagrams_{0};
+
     // 配置记录
     CommunicateCfg commCfg_;
 };
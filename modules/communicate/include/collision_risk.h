@@ -0,0 +1,188 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        collision_risk.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 船舶会遇碰撞风险（CPA/TCPA）增量计算与告警
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        增加按Track更新的接口，便于在缓存锁外调用
+
+*****************************************************************/
+
+#ifndef AIS_COLLISION_RISK_H
+#define AIS_COLLISION_RISK_H
+
+#include "live_spatial_index.h"
+#include "utils/vessel_state.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 碰撞风险告警事件
+ */
+struct CollisionAlert
+{
+    uint32_t mmsiA = 0;         // 船对中较小的MMSI
+    uint32_t mmsiB = 0;         // 船对中较大的MMSI
+    bool active = false;        // true为产生告警，false为解除告警
+    double cpaM = 0.0;          // 最近会遇距离（米）
+    double tcpaSec = 0.0;       // 到达最近会遇点的时间（秒），负数表示已驶过
+    double rangeM = 0.0;        // 当前距离（米）
+    double relativeSpeedMs = 0.0;   // 相对速度（米/秒）
+    int64_t timeMs = 0;         // 计算时刻（毫秒）
+};
+
+/**
+ * @brief 碰撞风险引擎
+ *
+ * 处理线程每次位置更新只把船舶运动参数追加到待处理列表（O(1)）；维护线程按周期evaluate()：
+ * 只对上一周期以来有更新的船舶，通过实时船位网格索引取rangeM内的邻船组成候选船对计算CPA/TCPA，
+ * 未更新船舶之间的船对不重复计算；已告警的船对每周期重新计算一次，风险解除（含船舶消失）时发出解除事件。
+ *
+ * CPA/TCPA按两船外推到计算时刻的位置、对地速度和航向做匀速直线相对运动求解（局部平面近似）；
+ * 产生告警条件：CPA <= cpaM 且 0 <= TCPA <= tcpaSec 且相对速度不低于MIN_RELATIVE_SPEED_MS（排除同泊位静止船舶）；
+ * 解除告警时阈值放宽CLEAR_FACTOR倍，避免在阈值附近反复告警。
+ *
+ * 事件格式（format）：
+ * - CSV：A,mmsiA,mmsiB,RAISE|CLEAR,cpaM,tcpaSec,rangeM,timeMs
+ * - 二进制（小端）：记录头8字节 魔数0xA6 + 版本 + 类型'A' + 状态(1产生/0解除) + mmsiA(u32)，
+ *        之后为 mmsiB(u32) + CPA(u32，米) + TCPA(i32，秒) + 当前距离(u32，米) + 时间(i64)
+ */
+class CollisionRiskEngine
+{
+public:
+    static constexpr double MIN_RELATIVE_SPEED_MS = 0.25;   // 相对速度下限（米/秒，约0.5节）
+    static constexpr double CLEAR_FACTOR = 1.2;             // 解除告警的阈值放宽倍数
+
+    /**
+     * @brief 参与计算的船舶运动参数
+     */
+    struct Track
+    {
+        uint32_t mmsi = 0;
+        double latitude = 91.0;
+        double longitude = 181.0;
+        double speedOverGround = 0.0;       // 节，不可用时按静止处理
+        double courseOverGround = 360.0;    // 度，360表示不可用
+        int64_t timeMs = 0;                 // 位置时间（毫秒）
+    };
+
+    /**
+     * @brief 告警事件回调（在evaluate()所在线程调用）
+     */
+    typedef std::function<void(const CollisionAlert &alert)> alert_func;
+
+    /**
+     * @brief 构造函数
+     * @param index 实时船位网格索引（用于查找候选船对，生命周期需长于本对象）
+     * @param rangeM 候选船对搜索半径（米）
+     * @param cpaM CPA告警阈值（米）
+     * @param tcpaSec TCPA告警阈值（秒）
+     * @param maxHorizonMs 位置外推的最长时长（毫秒），非正数表示不限制
+     * @param alert 告警事件回调
+     */
+    CollisionRiskEngine(const LiveSpatialIndex *index, double rangeM, double cpaM, double tcpaSec,
+                        int64_t maxHorizonMs, alert_func alert);
+
+    /**
+     * @brief 记录一次位置更新（线程安全，只追加到待处理列表），位置不可用时按船舶消失处理
+     */
+    void update(const VesselState &state);
+    void update(const Track &track);
+
+    /**
+     * @brief 从船舶状态取出计算所需的字段
+     */
+    static Track toTrack(const VesselState &state);
+
+    /**
+     * @brief 船舶消失（线程安全，与位置更新按调用顺序生效），下一周期解除其全部告警
+     */
+    void remove(uint32_t mmsi);
+
+    /**
+     * @brief 清空全部船舶（线程安全），下一周期解除全部告警
+     */
+    void clear();
+
+    /**
+     * @brief 执行一个计算周期（非线程安全，由维护线程独占调用）
+     * @param nowMs 计算时刻（毫秒，与位置时间同一时钟）
+     * @return 本周期计算的船对数
+     */
+    size_t evaluate(int64_t nowMs);
+
+    size_t getActiveAlertCount() const { return alerts_.size(); }
+    uint64_t getEvaluatedPairs() const { return evaluatedPairs_; }
+
+    /**
+     * @brief 计算两船在指定时刻的CPA/TCPA
+     * @param maxHorizonMs 位置外推的最长时长（毫秒），非正数表示不限制
+     * @param out [out] 计算结果（mmsiA/mmsiB/timeMs按船对填写，active不修改）
+     * @return 两船都有有效位置时返回true
+     */
+    static bool computeCpa(const Track &a, const Track &b, int64_t atMs, int64_t maxHorizonMs, CollisionAlert &out);
+
+    /**
+     * @brief 把告警事件格式化为转发记录（CSV不含结尾'\0'）
+     */
+    static void format(const CollisionAlert &alert, bool binary, std::string &out);
+
+private:
+    static uint64_t pairKey(uint32_t a, uint32_t b);
+
+    /**
+     * @brief 是否满足告警条件
+     * @param factor 阈值放宽倍数（产生告警为1，保持告警为CLEAR_FACTOR）
+     */
+    bool risky(const CollisionAlert &alert, double factor) const;
+
+    /**
+     * @brief 计算新船对，满足告警条件时产生告警
+     */
+    void evaluatePair(const Track &a, const Track &b, int64_t nowMs);
+
+    const LiveSpatialIndex *index_;
+    double rangeM_;
+    double cpaM_;
+    double tcpaSec_;
+    int64_t maxHorizonMs_;
+    alert_func alert_;
+
+    // 处理线程写入的待处理更新（短临界区，evaluate时整体交换取出），位置不可用的条目表示船舶消失
+    std::mutex pendingMutex_;
+    std::vector<Track> pending_;
+    bool pendingClear_ = false;
+
+    // 以下仅维护线程访问
+    struct Entry
+    {
+        Track track;
+        uint64_t dirtyCycle = 0;        // 最近一次有更新的周期
+    };
+    std::unordered_map<uint32_t, Entry> tracks_;
+    std::unordered_map<uint64_t, CollisionAlert> alerts_;   // 处于告警状态的船对
+    std::vector<Track> updates_;
+    std::vector<uint32_t> dirty_;
+    std::vector<SpatialHit> hits_;
+    uint64_t cycle_ = 0;
+    uint64_t evaluatedPairs_ = 0;
+};
+
+} // namespace ais
+
+#endif // AIS_COLLISION_RISK_H
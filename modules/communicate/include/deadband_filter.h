@@ -0,0 +1,90 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        deadband_filter.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 按船舶的死区过滤，抑制变化不超过阈值的位置报告转发
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        记录表增加容量上限
+
+*****************************************************************/
+
+#ifndef AIS_DEADBAND_FILTER_H
+#define AIS_DEADBAND_FILTER_H
+
+#include "flat_lru.h"
+#include "messages/message.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ais
+{
+
+/**
+ * @brief 死区过滤器
+ *
+ * 记录每艘船最后一次转发的位置、航速、航向和导航状态。新的位置报告与之相比
+ * 位移、航速差、航向差均不超过阈值且导航状态不变时抑制转发；距上次转发超过
+ * maxSilenceSec时无论是否变化都转发一次（心跳），接收端的航迹误差不超过阈值。
+ * 非位置类消息不过滤。记录表最多保留CAPACITY艘船，被淘汰的船舶下一条报告直接转发。
+ *
+ * @note 非线程安全，每个处理线程一份；多个处理线程时必须按MMSI分片，保证同一船舶只经过同一个过滤器
+ */
+class DeadbandFilter
+{
+public:
+    static constexpr size_t CAPACITY = 200000;      // 记录的船舶数上限
+
+    /**
+     * @brief 构造函数
+     * @param distanceM 位置死区（米）
+     * @param speedKn 航速死区（节）
+     * @param courseDeg 航向死区（度）
+     * @param maxSilenceSec 最长静默时间（秒），非正数表示不发送心跳
+     */
+    DeadbandFilter(double distanceM, double speedKn, double courseDeg, int maxSilenceSec);
+
+    /**
+     * @brief 判断消息是否需要转发，需要转发时记录为该船最后转发的值
+     * @param msg AIS消息
+     * @param timeMs 接收时间（毫秒）
+     * @return 需要转发返回true
+     */
+    bool accept(const AISMessage &msg, int64_t timeMs);
+
+    uint64_t getSuppressedCount() const { return suppressed_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief 最后转发的值
+     */
+    struct Forwarded
+    {
+        double latitude = 91.0;
+        double longitude = 181.0;
+        double speedOverGround = 0.0;
+        double courseOverGround = 0.0;
+        int navigationStatus = 15;
+        int64_t timeMs = 0;             // 0表示尚未转发过
+    };
+
+    double distanceM_;
+    double speedKn_;
+    double courseDeg_;
+    int64_t maxSilenceMs_;
+
+    // 超过最长静默时间的记录已无意义，按同样的时间淘汰；另按CAPACITY限制总量
+    CFlatLRU<uint32_t, Forwarded> last_;
+    std::atomic<uint64_t> suppressed_{0};
+};
+
+} // namespace ais
+
+#endif // AIS_DEADBAND_FILTER_H
@@ -0,0 +1,711 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        flat_lru.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 开放寻址哈希表+侵入式链表的LRU缓存（结点池预分配，接口与CLRU一致）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        增加淘汰回调和分步超时淘汰接口Tick
+
+*****************************************************************/
+
+#ifndef FLAT_LRU_H_
+#define FLAT_LRU_H_
+
+#include "lru.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @brief 粗粒度时钟（秒），用于LRU结点访问时间
+ *
+ * Linux下读取CLOCK_REALTIME_COARSE（vDSO读取内核tick缓存值，不触发系统调用也不读硬件计数器），
+ * 其他平台退化为time()。
+ */
+class CoarseClock
+{
+public:
+    static time_t Now()
+    {
+#if defined(__linux__)
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+        return ts.tv_sec;
+#else
+        return std::time(nullptr);
+#endif
+    }
+};
+
+/**
+ * @brief 扁平存储的LRU缓存
+ *
+ * 与CLRU接口和淘汰语义一致，内部结构换成连续内存：
+ * - 结点池：所有结点存放在一个vector中，prev/next为池内下标构成侵入式双向链表，
+ *   删除和淘汰的结点挂入空闲链表复用
+ * - 索引：线性探测开放寻址哈希表，槽内直接保存32位哈希标签和结点下标，
+ *   比较标签后才访问结点，删除采用后移法不留墓碑
+ * - 访问时间：每次操作只读取一次粗粒度时钟
+ *
+ * 池和哈希表只在超过已有容量时扩容（Reset设置了最大容量时按上限预分配），
+ * 预热后插入、查找、淘汰都不再申请内存。
+ */
+template <class K, class T, class Lock = NullLock, class Hash = std::hash<K>>
+class CFlatLRU
+{
+public:
+    typedef Lock lock_type;
+    using Guard = std::lock_guard<lock_type>;
+    typedef typename CLRU<K, T, Lock>::CacheStats CacheStats;
+    typedef typename CLRU<K, T, Lock>::evict_callback evict_callback;
+
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;        /**< 空下标 */
+    static constexpr size_t MIN_SLOTS = 16;             /**< 哈希表最小槽数 */
+
+public:
+    /**
+     * @brief 构造函数
+     * @param maxSize [in] 结点最大数
+     * @param elasticity [in] 弹性数量
+     * @param maxTimeSpan [in] 最大时间间隔
+     */
+    explicit CFlatLRU(size_t maxSize, size_t elasticity, time_t maxTimeSpan)
+        : m_maxSize(maxSize), m_elasticity(elasticity), m_maxTimeSpan(maxTimeSpan)
+    {
+        Reserve(maxSize > 0 ? maxSize + elasticity : 0);
+    }
+
+    virtual ~CFlatLRU() = default;
+
+public:
+    /**
+     * 获取缓存数目
+     * @return 当前缓存大小
+     */
+    size_t GetSize() const
+    {
+        Guard g(m_lock);
+        return m_size;
+    }
+
+    /**
+     * 缓存是否为空
+     * @return true: 为空; false: 不为空
+     */
+    bool IsEmpty() const
+    {
+        Guard g(m_lock);
+        return m_size == 0;
+    }
+
+    /**
+     * 清空缓存（保留已分配的结点池和哈希表）
+     */
+    void Clear()
+    {
+        Guard g(m_lock);
+        m_entries.clear();
+        for (auto &slot : m_slots)
+        {
+            slot.index = NIL;
+        }
+        m_head = m_tail = m_free = NIL;
+        m_size = 0;
+        m_evictedByCapacity = 0;
+        m_evictedByTime = 0;
+    }
+
+public:
+    /**
+     * @brief 重置LRU缓存配置
+     * @param maxSize 最大容量，0表示不限制
+     * @param elasticity 弹性大小
+     * @param maxTimeSpan 最大存活时间(秒)，0表示不限制
+     */
+    void Reset(size_t maxSize, size_t elasticity, time_t maxTimeSpan)
+    {
+        Guard g(m_lock);
+        m_maxSize = maxSize;
+        m_elasticity = elasticity;
+        m_maxTimeSpan = maxTimeSpan;
+        Reserve(maxSize > 0 ? maxSize + elasticity : 0);
+        ExpireCapacity();
+        ExpireTime(CoarseClock::Now());
+    }
+
+    /**
+     * @brief 设置结点淘汰回调
+     * @param callback [in] 按容量或存活时间淘汰结点前调用，在锁内执行，回调中不得再访问本缓存
+     */
+    void SetEvictCallback(evict_callback callback)
+    {
+        Guard g(m_lock);
+        m_onEvict = std::move(callback);
+    }
+
+    /**
+     * @brief 分步执行超时淘汰，供后台线程周期调用，使不再被访问的结点也能及时淘汰
+     * @param maxCount [in] 本次最多淘汰的结点数，限制单次持锁时间
+     * @return 本次淘汰的结点数
+     */
+    size_t Tick(size_t maxCount)
+    {
+        Guard g(m_lock);
+        return ExpireTime(CoarseClock::Now(), maxCount);
+    }
+
+    /**
+     * 插入一个键值对（key，value）到缓存中，
+     * @param key [in] 键
+     * @param value [in] 值
+     * @return true: 插入成功; false: 插入失败
+     */
+    bool Insert(const K &key, const T &value)
+    {
+        Guard g(m_lock);
+        const time_t now = CoarseClock::Now();
+        const uint32_t tag = HashTag(key);
+        const uint32_t pos = FindSlot(key, tag);
+        if (pos != NIL)
+        {
+            const uint32_t idx = m_slots[pos].index;
+            m_entries[idx].value = value;
+            Touch(idx, now);
+            return true;
+        }
+
+        const uint32_t idx = Allocate(key, tag, now);
+        m_entries[idx].value = value;
+        Expire(now);
+        return true;
+    }
+
+    /**
+     * @brief 原地更新给定键对应的值，不存在时先插入默认构造的值再更新
+     * @param key [in] 键
+     * @param func [in] 更新函数，签名为 void(T &value)，在锁内调用
+     * @return true: 新插入结点; false: 更新已有结点
+     */
+    template <typename Func>
+    bool Upsert(const K &key, Func func)
+    {
+        Guard g(m_lock);
+        const time_t now = CoarseClock::Now();
+        const uint32_t tag = HashTag(key);
+        const uint32_t pos = FindSlot(key, tag);
+        if (pos != NIL)
+        {
+            const uint32_t idx = m_slots[pos].index;
+            func(m_entries[idx].value);
+            Touch(idx, now);
+            return false;
+        }
+
+        const uint32_t idx = Allocate(key, tag, now);
+        func(m_entries[idx].value);
+        Expire(now);
+        return true;
+    }
+
+    /**
+     * 缓存中是否存在给定键对应的结点
+     * @param key [in] 键
+     * @return true: 存在对应的键值; false: 不存在对应的键值
+     */
+    bool IsExist(const K &key) const
+    {
+        Guard g(m_lock);
+        return FindSlot(key, HashTag(key)) != NIL;
+    }
+
+    /**
+     * 删除缓存中包含给定键所指向的结点
+     * @param key [in] 键
+     * @return true: 删除成功; false: 删除失败
+     */
+    bool Erase(const K &key)
+    {
+        Guard g(m_lock);
+        const uint32_t pos = FindSlot(key, HashTag(key));
+        if (pos == NIL)
+        {
+            return false;
+        }
+        const uint32_t idx = m_slots[pos].index;
+        EraseSlot(pos);
+        Release(idx);
+        return true;
+    }
+
+    /**
+     * 查找缓存中给定键对应的结点
+     * @param key [in] 键
+     * @return 包含查找结果和值的pair
+     */
+    std::pair<bool, T> Find(const K &key)
+    {
+        Guard g(m_lock);
+        std::pair<bool, T> p;
+        const uint32_t pos = FindSlot(key, HashTag(key));
+        if (pos == NIL)
+        {
+            p.first = false;
+            return p;
+        }
+        const uint32_t idx = m_slots[pos].index;
+        Touch(idx, CoarseClock::Now());
+        p.first = true;
+        p.second = m_entries[idx].value;
+        return p;
+    }
+
+    /**
+     * @brief 查看指定键对应的值，但不更新访问时间和位置
+     * @param key [in] 键
+     * @return 包含查找结果和值的pair
+     */
+    std::pair<bool, T> Peek(const K &key) const
+    {
+        Guard g(m_lock);
+        std::pair<bool, T> p;
+        const uint32_t pos = FindSlot(key, HashTag(key));
+        if (pos == NIL)
+        {
+            p.first = false;
+            return p;
+        }
+        p.first = true;
+        p.second = m_entries[m_slots[pos].index].value;
+        return p;
+    }
+
+    /**
+     * @brief 获取缓存中所有键的列表
+     * @return 键的向量
+     */
+    std::vector<K> GetKeys() const
+    {
+        return GetKeysByAccessTime();
+    }
+
+    /**
+     * @brief 获取按访问时间从新到旧排序的键列表
+     * @return 排序后的键向量
+     */
+    std::vector<K> GetKeysByAccessTime() const
+    {
+        return GetTopNKeys(static_cast<size_t>(-1));
+    }
+
+    /**
+     * @brief 获取最近访问的前N个键（从最新到最旧）
+     * @param n [in] 要获取的键数量
+     * @return 前N个键的向量
+     */
+    std::vector<K> GetTopNKeys(size_t n) const
+    {
+        Guard g(m_lock);
+        std::vector<K> keys;
+        keys.reserve(std::min(n, m_size));
+        for (uint32_t idx = m_head; idx != NIL && keys.size() < n; idx = m_entries[idx].next)
+        {
+            keys.push_back(m_entries[idx].key);
+        }
+        return keys;
+    }
+
+    /**
+     * @brief 获取最新插入或访问的键值对
+     * @return 包含最新键值对的optional，如果缓存为空则返回std::nullopt
+     */
+    std::optional<std::pair<K, T>> GetLatest() const
+    {
+        Guard g(m_lock);
+        if (m_head == NIL)
+        {
+            return std::nullopt;
+        }
+        const Entry &front = m_entries[m_head];
+        return std::make_pair(front.key, front.value);
+    }
+
+    /**
+     * @brief 获取缓存统计信息
+     * @return 缓存统计信息结构体
+     */
+    CacheStats GetStats() const
+    {
+        Guard g(m_lock);
+        CacheStats stats;
+        stats.current_size = m_size;
+        stats.max_size = m_maxSize;
+        stats.elasticity = m_elasticity;
+        stats.max_time_span = m_maxTimeSpan;
+        stats.evicted_by_capacity = m_evictedByCapacity;
+        stats.evicted_by_time = m_evictedByTime;
+        stats.oldest_access_time = m_tail != NIL ? m_entries[m_tail].lastTouch : 0;
+        stats.newest_access_time = m_head != NIL ? m_entries[m_head].lastTouch : 0;
+        return stats;
+    }
+
+    /**
+     * @brief 批量获取多个键的值
+     * @param keys [in] 要查找的键向量
+     * @return 包含找到的键值对的unordered_map
+     */
+    std::unordered_map<K, T> BatchFind(const std::vector<K> &keys)
+    {
+        Guard g(m_lock);
+        const time_t now = CoarseClock::Now();
+        std::unordered_map<K, T> result;
+        for (const auto &key : keys)
+        {
+            const uint32_t pos = FindSlot(key, HashTag(key));
+            if (pos != NIL)
+            {
+                const uint32_t idx = m_slots[pos].index;
+                Touch(idx, now);
+                result[key] = m_entries[idx].value;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief 遍历缓存中的所有元素（从新到旧）
+     * @param func [in] 处理每个键值对的函数，返回false可中断遍历
+     */
+    template<typename Func>
+    void ForEach(Func func) const
+    {
+        Guard g(m_lock);
+        for (uint32_t idx = m_head; idx != NIL; idx = m_entries[idx].next)
+        {
+            if (!func(m_entries[idx].key, m_entries[idx].value))
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief 遍历缓存中的所有元素（包含访问时间）
+     * @param func [in] 处理每个键值对和访问时间的函数，返回false可中断遍历
+     */
+    template<typename Func>
+    void ForEachWithTime(Func func) const
+    {
+        Guard g(m_lock);
+        for (uint32_t idx = m_head; idx != NIL; idx = m_entries[idx].next)
+        {
+            const Entry &entry = m_entries[idx];
+            if (!func(entry.key, entry.value, entry.lastTouch))
+            {
+                break;
+            }
+        }
+    }
+
+protected:
+    /**
+     * @brief 池中结点，prev/next为池内下标
+     */
+    struct Entry
+    {
+        K key{};
+        uint32_t hash = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;   /**< 空闲结点复用为空闲链表指针 */
+        time_t lastTouch = 0;
+        T value{};
+    };
+
+    /**
+     * @brief 哈希表槽，index为NIL表示空槽
+     */
+    struct Slot
+    {
+        uint32_t hash = 0;
+        uint32_t index = NIL;
+    };
+
+protected:
+    /**
+     * 检查LRU结点的数量和最近访问时间，淘汰超过限制的结点
+     */
+    void Expire(time_t now)
+    {
+        ExpireCapacity();
+        ExpireTime(now);
+    }
+
+    /**
+     * 检查LRU结点的数量，淘汰超过限制的结点
+     */
+    void ExpireCapacity()
+    {
+        size_t maxAllowed = m_maxSize + m_elasticity;
+        if (0 >= m_maxSize || m_size < maxAllowed)
+        {
+            return;
+        }
+
+        while (m_size > m_maxSize)
+        {
+            EvictTail(EvictReason::CAPACITY);
+            m_evictedByCapacity++;
+        }
+    }
+
+    /**
+     * 检查LRU结点最近访问时间，从链表尾开始淘汰超过限制的结点，最多淘汰maxCount个
+     * （链表按访问时间有序，无需额外的定时轮等超时索引）
+     */
+    size_t ExpireTime(time_t now, size_t maxCount = SIZE_MAX)
+    {
+        if (0 >= m_maxTimeSpan)
+        {
+            return 0;
+        }
+
+        size_t evicted = 0;
+        while (m_tail != NIL && evicted < maxCount && now - m_entries[m_tail].lastTouch > m_maxTimeSpan)
+        {
+            EvictTail(EvictReason::TIME);
+            evicted++;
+        }
+        m_evictedByTime += evicted;
+        return evicted;
+    }
+
+    void EvictTail(EvictReason reason)
+    {
+        const uint32_t idx = m_tail;
+        if (m_onEvict)
+        {
+            m_onEvict(m_entries[idx].key, m_entries[idx].value, reason);
+        }
+        EraseSlot(FindSlot(m_entries[idx].key, m_entries[idx].hash));
+        Release(idx);
+    }
+
+protected:
+    /**
+     * 键哈希再做Fibonacci散列，取高32位作为标签（std::hash对整数是恒等映射）
+     */
+    uint32_t HashTag(const K &key) const
+    {
+        return static_cast<uint32_t>((static_cast<uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+
+    uint32_t FindSlot(const K &key, uint32_t tag) const
+    {
+        if (m_slots.empty())
+        {
+            return NIL;
+        }
+        for (uint32_t pos = tag & m_mask;; pos = (pos + 1) & m_mask)
+        {
+            const Slot &slot = m_slots[pos];
+            if (slot.index == NIL)
+            {
+                return NIL;
+            }
+            if (slot.hash == tag && m_entries[slot.index].key == key)
+            {
+                return pos;
+            }
+        }
+    }
+
+    void InsertSlot(uint32_t tag, uint32_t index)
+    {
+        uint32_t pos = tag & m_mask;
+        while (m_slots[pos].index != NIL)
+        {
+            pos = (pos + 1) & m_mask;
+        }
+        m_slots[pos].hash = tag;
+        m_slots[pos].index = index;
+    }
+
+    /**
+     * 后移删除：把探测链上后续槽中可以前移的元素依次前移，保持查找不跨空槽
+     */
+    void EraseSlot(uint32_t pos)
+    {
+        uint32_t hole = pos;
+        uint32_t next = pos;
+        for (;;)
+        {
+            next = (next + 1) & m_mask;
+            if (m_slots[next].index == NIL)
+            {
+                break;
+            }
+            // 元素的理想位置在(hole, next]之间时不能前移
+            const uint32_t home = m_slots[next].hash & m_mask;
+            const bool stay = hole <= next ? (hole < home && home <= next)
+                                           : (hole < home || home <= next);
+            if (stay)
+            {
+                continue;
+            }
+            m_slots[hole] = m_slots[next];
+            hole = next;
+        }
+        m_slots[hole].index = NIL;
+    }
+
+    /**
+     * 按结点数预留结点池和哈希表（负载因子不超过0.75）
+     */
+    void Reserve(size_t count)
+    {
+        if (count > 0)
+        {
+            m_entries.reserve(count);
+        }
+        size_t slots = MIN_SLOTS;
+        while (slots * 3 < count * 4)
+        {
+            slots <<= 1;
+        }
+        if (slots > m_slots.size())
+        {
+            Rehash(slots);
+        }
+    }
+
+    void Rehash(size_t slots)
+    {
+        m_slots.assign(slots, Slot());
+        m_mask = static_cast<uint32_t>(slots - 1);
+        for (uint32_t idx = m_head; idx != NIL; idx = m_entries[idx].next)
+        {
+            InsertSlot(m_entries[idx].hash, idx);
+        }
+    }
+
+    /**
+     * 取一个结点（优先复用空闲结点），挂到链表头并建立索引
+     */
+    uint32_t Allocate(const K &key, uint32_t tag, time_t now)
+    {
+        if ((m_size + 1) * 4 > m_slots.size() * 3)
+        {
+            Rehash(std::max(m_slots.size() * 2, MIN_SLOTS));
+        }
+
+        uint32_t idx;
+        if (m_free != NIL)
+        {
+            idx = m_free;
+            m_free = m_entries[idx].next;
+            m_entries[idx].value = T();
+        }
+        else
+        {
+            idx = static_cast<uint32_t>(m_entries.size());
+            m_entries.emplace_back();
+        }
+
+        Entry &entry = m_entries[idx];
+        entry.key = key;
+        entry.hash = tag;
+        entry.lastTouch = now;
+        LinkFront(idx);
+        InsertSlot(tag, idx);
+        m_size++;
+        return idx;
+    }
+
+    /**
+     * 结点移出链表并放入空闲链表（索引需已删除）
+     */
+    void Release(uint32_t idx)
+    {
+        Unlink(idx);
+        m_entries[idx].next = m_free;
+        m_free = idx;
+        m_size--;
+    }
+
+    void Touch(uint32_t idx, time_t now)
+    {
+        m_entries[idx].lastTouch = now;
+        if (idx != m_head)
+        {
+            Unlink(idx);
+            LinkFront(idx);
+        }
+    }
+
+    void LinkFront(uint32_t idx)
+    {
+        Entry &entry = m_entries[idx];
+        entry.prev = NIL;
+        entry.next = m_head;
+        if (m_head != NIL)
+        {
+            m_entries[m_head].prev = idx;
+        }
+        m_head = idx;
+        if (m_tail == NIL)
+        {
+            m_tail = idx;
+        }
+    }
+
+    void Unlink(uint32_t idx)
+    {
+        Entry &entry = m_entries[idx];
+        if (entry.prev != NIL)
+        {
+            m_entries[entry.prev].next = entry.next;
+        }
+        else
+        {
+            m_head = entry.next;
+        }
+        if (entry.next != NIL)
+        {
+            m_entries[entry.next].prev = entry.prev;
+        }
+        else
+        {
+            m_tail = entry.prev;
+        }
+        entry.prev = entry.next = NIL;
+    }
+
+protected:
+    mutable Lock m_lock; /**< 互斥锁 */
+    Hash m_hash;         /**< 键哈希函数 */
+
+    std::vector<Entry> m_entries; /**< 结点池 */
+    std::vector<Slot> m_slots;    /**< 开放寻址哈希表 */
+    uint32_t m_mask = 0;          /**< 槽数-1 */
+    uint32_t m_head = NIL;        /**< 最新访问结点 */
+    uint32_t m_tail = NIL;        /**< 最旧访问结点 */
+    uint32_t m_free = NIL;        /**< 空闲结点链表 */
+    size_t m_size = 0;            /**< 有效结点数 */
+
+    size_t m_maxSize;     /**< 结点最大数 */
+    size_t m_elasticity;  /**< 弹性数量 */
+    time_t m_maxTimeSpan; /**< 最大时间间隔 */
+
+    size_t m_evictedByCapacity = 0; /**< 因容量淘汰的数量 */
+    size_t m_evictedByTime = 0;     /**< 因超时淘汰的数量 */
+
+    evict_callback m_onEvict;       /**< 淘汰回调 */
+};
+
+#endif // FLAT_LRU_H_
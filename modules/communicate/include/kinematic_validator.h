@@ -0,0 +1,174 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        kinematic_validator.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 位置报告运动学校验（位置跳变、不可能航速、航向不符、时间倒退、MMSI冲突）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        说明接收时延限制
+
+*****************************************************************/
+
+#ifndef AIS_KINEMATIC_VALIDATOR_H
+#define AIS_KINEMATIC_VALIDATOR_H
+
+#include "flat_lru.h"
+#include "messages/message.h"
+#include "sharded_lru.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 异常类型
+ */
+enum class AnomalyType : uint8_t
+{
+    NONE = 0,
+    REPORTED_SPEED = 1,     // 报告的对地速度超过上限
+    TIME_REGRESSION = 2,    // 报告时刻早于该船上一条已接受的报告
+    POSITION_JUMP = 3,      // 相对上一位置的隐含速度超过上限
+    COURSE_MISMATCH = 4,    // 实际移动方向与报告的对地航向不符
+    MMSI_CONFLICT = 5,      // 两条互相独立的航迹交替使用同一MMSI
+    TYPE_COUNT
+};
+
+/**
+ * @brief 异常记录
+ */
+struct Anomaly
+{
+    uint32_t mmsi = 0;
+    AnomalyType type = AnomalyType::NONE;
+    double latitude = 91.0;         // 本条报告的位置
+    double longitude = 181.0;
+    double impliedSpeedKn = 0.0;    // 相对上一位置的隐含速度（节），无法计算时为0
+    int64_t timeMs = 0;             // 报告时刻（毫秒）
+    bool quarantined = false;       // 是否已隔离（不进入船舶状态、转发和存储）
+};
+
+/**
+ * @brief 运动学校验器
+ *
+ * 对每条船舶位置报告与该船上一条已接受的报告比较（每船固定大小的状态，O(1)）：
+ * - 报告时刻由接收时间和报告中的UTC秒还原，早于上一条已接受报告时为时间倒退（重放或迟到的旧数据）；
+ * - 两点间距离超过 maxSpeedKn * 时间差 + POSITION_TOLERANCE_M 为位置跳变；
+ * - 移动距离不小于COURSE_MIN_DISTANCE_M且航速不低于COURSE_MIN_SPEED_KN时，移动方位与报告航向相差超过courseDeg为航向不符
+ *   （位置可信，仍更新航迹，隔离模式下也只标记）。
+ * 跳变的报告另记为候选航迹：后续报告与候选航迹连贯、同时原航迹也持续有报告时判定为MMSI冲突
+ * （两艘船使用同一MMSI），候选航迹的报告按冲突标记；候选航迹连续REANCHOR_HITS条而原航迹无新报告时，
+ * 认为原航迹本身是错误数据（如首条报告即为跳点），改以候选航迹为准。
+ * 超过STATE_TTL_SEC无报告的船舶状态被淘汰，之后的第一条报告不做比较。
+ *
+ * 按MMSI分片加锁，可由多个处理线程并发调用；同一船舶的报告须按到达顺序校验（多线程时按MMSI分发）。
+ *
+ * @note 报告只含UTC秒，时刻按接收时间还原（见reportTimeMs），要求接收时延小于1分钟；时延达到1分钟及以上的
+ *       数据源（卫星AIS、延迟转发、回放旧数据）还原出的时刻会错开整分钟，产生时间倒退和位置跳变误报，不应启用校验
+ */
+class KinematicValidator
+{
+public:
+    static constexpr double POSITION_TOLERANCE_M = 100.0;   // 定位误差容限
+    static constexpr double COURSE_MIN_DISTANCE_M = 200.0;  // 航向校验的最小移动距离
+    static constexpr double COURSE_MIN_SPEED_KN = 2.0;      // 航向校验的最低航速
+    static constexpr int REANCHOR_HITS = 3;                 // 候选航迹替换原航迹所需的连续报告数
+    static constexpr int CONFLICT_HITS = 2;                 // 判定MMSI冲突时两条航迹各自所需的报告数
+    static constexpr int64_t ALT_TTL_MS = 600000;           // 候选航迹无新报告的保留时长
+    static constexpr time_t STATE_TTL_SEC = 3600;           // 船舶状态保留时长
+    static constexpr size_t RECENT_CAPACITY = 1024;         // 保留的最近异常记录数
+
+    /**
+     * @brief 构造函数
+     * @param maxSpeedKn 航速上限（节）
+     * @param courseDeg 航向偏差上限（度），非正数表示不校验航向
+     * @param quarantine 异常报告是否隔离（否则只标记）
+     * @param shardCount 状态分片数
+     */
+    KinematicValidator(double maxSpeedKn, double courseDeg, bool quarantine, size_t shardCount);
+
+    /**
+     * @brief 校验一条消息（非位置报告或无有效位置时直接通过）
+     * @param msg AIS消息
+     * @param receiveMs 接收时间（毫秒）
+     * @param out [out] 有异常时的异常记录
+     * @return 异常类型，NONE表示正常
+     */
+    AnomalyType check(const AISMessage &msg, int64_t receiveMs, Anomaly &out);
+
+    bool quarantine() const { return quarantine_; }
+
+    void clear();
+
+    /**
+     * @brief 各类型异常的累计数（下标为AnomalyType）
+     */
+    std::array<uint64_t, static_cast<size_t>(AnomalyType::TYPE_COUNT)> getCounts() const;
+
+    /**
+     * @brief 最近的异常记录（从旧到新，最多RECENT_CAPACITY条）
+     */
+    std::vector<Anomaly> getRecent() const;
+
+    /**
+     * @brief 由接收时间和报告中的UTC秒还原报告时刻（报告时刻不晚于接收时间，时延小于1分钟）
+     * @param utcSecond UTC秒，60及以上表示不可用（返回接收时间）
+     */
+    static int64_t reportTimeMs(int64_t receiveMs, int utcSecond);
+
+    static const char *typeName(AnomalyType type);
+
+    /**
+     * @brief 把异常记录格式化为转发记录（CSV不含结尾'\0'）
+     *
+     * - CSV：X,mmsi,TYPE,latitude,longitude,impliedSpeedKn,timeMs,QUARANTINED|FLAGGED
+     * - 二进制（小端）：记录头8字节 魔数0xA6 + 版本 + 类型'X' + 异常类型 + MMSI(u32)，
+     *        之后为 纬度i32 + 经度i32（同BinaryCodec） + 隐含速度u16(0.1节) + 是否隔离u8 + 时间(i64)
+     */
+    static void format(const Anomaly &anomaly, bool binary, std::string &out);
+
+private:
+    /**
+     * @brief 每船校验状态（原航迹为最后一条已接受的报告）
+     */
+    struct Track
+    {
+        double latitude = 91.0;
+        double longitude = 181.0;
+        int64_t timeMs = 0;             // 0表示尚无报告
+        double altLatitude = 91.0;      // 候选航迹（跳变报告）
+        double altLongitude = 181.0;
+        int64_t altTimeMs = 0;          // 0表示无候选航迹
+        uint16_t altHits = 0;           // 与候选航迹连贯的报告数
+        uint16_t primaryHits = 0;       // 候选航迹出现后原航迹的报告数
+    };
+
+    void record(const Anomaly &anomaly);
+
+    double maxSpeedMs_;
+    double courseDeg_;
+    bool quarantine_;
+
+    CShardedLRU<uint32_t, Track, std::mutex, std::hash<uint32_t>, CFlatLRU<uint32_t, Track, std::mutex>> tracks_;
+
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(AnomalyType::TYPE_COUNT)> counts_{};
+    mutable std::mutex recentMutex_;
+    std::deque<Anomaly> recent_;
+};
+
+} // namespace ais
+
+#endif // AIS_KINEMATIC_VALIDATOR_H
@@ -0,0 +1,134 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        live_spatial_index.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 实时船位的均匀经纬度网格索引（增量维护，支持矩形、半径和最近邻查询）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        距离计算移至utils/geo_math.h
+3             2026-10-18     cjx        queryNearest与其他查询一致改为追加结果
+
+*****************************************************************/
+
+#ifndef AIS_LIVE_SPATIAL_INDEX_H
+#define AIS_LIVE_SPATIAL_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 空间查询结果
+ */
+struct SpatialHit
+{
+    uint32_t mmsi = 0;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double distanceM = 0.0;     // 到查询点的距离（米），矩形查询为0
+};
+
+/**
+ * @brief 实时船位网格索引
+ *
+ * 经纬度按cellDeg划分为均匀网格，每个单元格保存其中船舶的MMSI和位置；船位更新时
+ * 只在跨单元格时移动一次（交换删除，O(1)），查询只访问与查询区域相交的单元格，
+ * 耗时与结果规模（及覆盖的单元格数）成正比，与船舶总数无关。
+ * 按MMSI哈希分片，每个分片一把读写锁，不同分片的更新互不阻塞，查询逐分片汇总。
+ */
+class LiveSpatialIndex
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param cellDeg 单元格边长（度），取值范围(0, 90]
+     * @param shardCount 分片数，0按1处理
+     */
+    LiveSpatialIndex(double cellDeg, size_t shardCount);
+
+    /**
+     * @brief 更新船位，位置不可用（纬度超出±90或经度超出±180）时从索引中删除
+     */
+    void update(uint32_t mmsi, double latitude, double longitude);
+
+    void remove(uint32_t mmsi);
+    void clear();
+    size_t size() const;
+
+    double cellDeg() const { return cellDeg_; }
+
+    /**
+     * @brief 矩形查询，west > east 表示跨越180度经线
+     * @param out [out] 追加结果（顺序不定）
+     * @return 本次追加的结果数
+     */
+    size_t queryBox(double south, double west, double north, double east, std::vector<SpatialHit> &out) const;
+
+    /**
+     * @brief 半径查询（大圆距离）
+     * @param out [out] 追加结果（顺序不定），distanceM为到中心的距离
+     * @return 本次追加的结果数
+     */
+    size_t queryRadius(double latitude, double longitude, double radiusM, std::vector<SpatialHit> &out) const;
+
+    /**
+     * @brief 最近邻查询：从一个单元格边长起倍增半径做半径查询，半径内不少于k个结果时取最近的k个
+     * @param out [out] 追加结果，追加部分按距离升序，最多k个
+     * @return 本次追加的结果数
+     */
+    size_t queryNearest(double latitude, double longitude, size_t k, std::vector<SpatialHit> &out) const;
+
+private:
+    struct Item
+    {
+        uint32_t mmsi;
+        double latitude;
+        double longitude;
+    };
+
+    struct Slot
+    {
+        uint32_t cell;
+        uint32_t index;         // 在单元格数组中的下标
+    };
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<uint32_t, std::vector<Item>> cells;     // 单元格 -> 船舶
+        std::unordered_map<uint32_t, Slot> vessels;                // MMSI -> 所在位置
+    };
+
+    Shard &shardOf(uint32_t mmsi) const;
+    uint32_t cellKey(int32_t x, int32_t y) const;
+    int32_t column(double longitude) const;
+    int32_t row(double latitude) const;
+    static void removeLocked(Shard &shard, uint32_t mmsi);
+
+    /**
+     * @brief 访问行[y0, y1]、列[x0, x1]范围内各单元格的船舶，wrap表示列范围跨越180度经线
+     */
+    template <class Func>
+    void visitCells(int32_t y0, int32_t y1, int32_t x0, int32_t x1, bool wrap, Func func) const;
+
+    double cellDeg_;
+    int32_t columns_;
+    int32_t rows_;
+    unsigned shardBits_ = 0;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace ais
+
+#endif // AIS_LIVE_SPATIAL_INDEX_H
@@ -11,6 +11,8 @@ Version history
 [序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
 1             2023-8-28      cjx        create
 2             2024-1-15      cjx        补充完善接口
+3             2026-10-18     cjx        增加原地更新接口Upsert
+4             2026-10-18     cjx        增加淘汰回调和分步超时淘汰接口Tick
 
 *****************************************************************/
 
@@ -24,6 +26,7 @@ Version history
 #include <vector>
 #include <functional>
 #include <optional>
+#include <cstdint>
 
 // 空锁
 class NullLock
@@ -43,6 +46,15 @@ public:
     }
 };
 
+/**
+ * @brief 结点淘汰原因
+ */
+enum class EvictReason
+{
+    CAPACITY, // 超过容量
+    TIME      // 超过存活时间
+};
+
 template <typename K, typename V>
 struct Node
 {
@@ -76,6 +88,7 @@ public:
     typedef Map map_type;
     typedef Lock lock_type;
     using Guard = std::lock_guard<lock_type>;
+    typedef std::function<void(const K &, const T &, EvictReason)> evict_callback;
 
     /**
      * @brief 缓存统计信息结构体
@@ -156,6 +169,27 @@ public:
         ExpireTime();
     }
 
+    /**
+     * @brief 设置结点淘汰回调
+     * @param callback [in] 按容量或存活时间淘汰结点前调用，在锁内执行，回调中不得再访问本缓存
+     */
+    void SetEvictCallback(evict_callback callback)
+    {
+        Guard g(m_lock);
+        m_onEvict = std::move(callback);
+    }
+
+    /**
+     * @brief 分步执行超时淘汰，供后台线程周期调用，使不再被访问的结点也能及时淘汰
+     * @param maxCount [in] 本次最多淘汰的结点数，限制单次持锁时间
+     * @return 本次淘汰的结点数
+     */
+    size_t Tick(size_t maxCount)
+    {
+        Guard g(m_lock);
+        return ExpireTimeLimited(std::time(nullptr), maxCount);
+    }
+
     /**
      * 插入一个键值对（key，value）到缓存中，
      * @param key [in] 键
@@ -180,6 +214,33 @@ public:
         return true;
     }
 
+    /**
+     * @brief 原地更新给定键对应的值，不存在时先插入默认构造的值再更新
+     * @param key [in] 键
+     * @param func [in] 更新函数，签名为 void(T &value)，在锁内调用
+     * @return true: 新插入结点; false: 更新已有结点
+     * @note 已有结点直接在链表结点上修改，不拷贝、不分配内存
+     */
+    template <typename Func>
+    bool Upsert(const K &key, Func func)
+    {
+        Guard g(m_lock);
+        const auto iter = m_map.find(key);
+        if (iter != m_map.end())
+        {
+            func(iter->second->m_value);
+            iter->second->update();
+            m_list.splice(m_list.begin(), m_list, iter->second);
+            return false;
+        }
+
+        m_list.emplace_front(key, T());
+        func(m_list.front().m_value);
+        m_map[key] = m_list.begin();
+        Expire();
+        return true;
+    }
+
     /**
      * 缓存中是否存在给定键对应的结点
      * @param key [in] 键
@@ -424,6 +485,10 @@ protected:
         size_t evicted = 0;
         while (m_map.size() > m_maxSize)
         {
+            if (m_onEvict)
+            {
+                m_onEvict(m_list.back().m_key, m_list.back().m_value, EvictReason::CAPACITY);
+            }
             m_map.erase(m_list.back().m_key);
             m_list.pop_back();
             evicted++;
@@ -435,18 +500,29 @@ protected:
      * 检查LRU结点最近访问时间，淘汰超过限制的结点
      */
     virtual void ExpireTime()
+    {
+        ExpireTimeLimited(std::time(nullptr), SIZE_MAX);
+    }
+
+    /**
+     * 从链表尾（最久未访问）开始淘汰超时结点，最多淘汰maxCount个
+     */
+    size_t ExpireTimeLimited(time_t now, size_t maxCount)
     {
         if (0 >= m_maxTimeSpan)
         {
-            return;
+            return 0;
         }
 
-        time_t now = std::time(nullptr);
         size_t evicted = 0;
-        while (!m_list.empty())
+        while (!m_list.empty() && evicted < maxCount)
         {
             if (now - m_list.back().m_lastTouch > m_maxTimeSpan)
             {
+                if (m_onEvict)
+                {
+                    m_onEvict(m_list.back().m_key, m_list.back().m_value, EvictReason::TIME);
+                }
                 m_map.erase(m_list.back().m_key);
                 m_list.pop_back();
                 evicted++;
@@ -457,6 +533,7 @@ protected:
             }
         }
         m_evictedByTime += evicted;
+        return evicted;
     }
 
 protected:
@@ -471,6 +548,8 @@ protected:
 
     size_t m_evictedByCapacity; /**< 因容量淘汰的数量 */
     size_t m_evictedByTime;     /**< 因超时淘汰的数量 */
+
+    evict_callback m_onEvict;   /**< 淘汰回调 */
 };
 
 #endif // LRU_H_
\ No newline at end of file
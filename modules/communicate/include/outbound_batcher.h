@@ -0,0 +1,86 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        outbound_batcher.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 转发记录合批，按数据报大小或最大等待时间发送
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_OUTBOUND_BATCHER_H
+#define AIS_OUTBOUND_BATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 转发记录合批器
+ *
+ * 把多条序列化后的记录拼成一个数据报，累计达到maxBytes或最早一条等待超过maxDelayUs时发送。
+ * - 文本模式（CSV）：记录以'\n'分隔，整个数据报以一个'\0'结尾，接收端按C字符串处理后按行拆分
+ * - 二进制模式：定长记录直接首尾相接，接收端按记录头逐条解码
+ * 单条记录超过maxBytes时单独发送。非线程安全，由发送线程独占使用
+ */
+class OutboundBatcher
+{
+public:
+    /**
+     * @brief 发送函数
+     * @param data 数据报
+     * @param size 数据报长度
+     * @param enqueueUs 数据报内各记录的入队时刻（用于延迟统计）
+     * @return 成功返回0
+     */
+    typedef std::function<int(const char *data, size_t size, const std::vector<int64_t> &enqueueUs)> send_func;
+
+    OutboundBatcher(size_t maxBytes, int64_t maxDelayUs, bool text, send_func send);
+
+    /**
+     * @brief 追加一条记录，放不下时先发送已有数据，达到上限时立即发送
+     * @param data 记录（文本模式下可带结尾'\0'）
+     * @param size 记录长度
+     * @param enqueueUs 入队时刻（steady_clock微秒）
+     */
+    void add(const char *data, size_t size, int64_t enqueueUs);
+
+    /**
+     * @brief 最早一条记录等待超过maxDelayUs时发送
+     * @param nowUs 当前时刻（steady_clock微秒）
+     */
+    void poll(int64_t nowUs);
+
+    /**
+     * @brief 立即发送已合批的数据
+     */
+    void flush();
+
+    bool empty() const { return enqueueUs_.empty(); }
+
+    uint64_t getDatagramCount() const { return datagrams_; }
+
+private:
+    size_t maxBytes_;
+    int64_t maxDelayUs_;
+    bool text_;
+    send_func send_;
+
+    std::string buffer_;                // 文本模式下不含结尾'\0'，发送时补上
+    std::vector<int64_t> enqueueUs_;    // 当前批内各记录入队时刻
+    uint64_t datagrams_ = 0;
+};
+
+} // namespace ais
+
+#endif // AIS_OUTBOUND_BATCHER_H
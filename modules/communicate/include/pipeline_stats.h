@@ -0,0 +1,107 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        pipeline_stats.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 接收处理流水线各级的计数与延迟统计
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        增加按MMSI分片标志、发送数据报计数、死区抑制计数
+3             2026-10-18     cjx        增加运动学异常计数、隔离计数
+
+*****************************************************************/
+
+#ifndef AIS_PIPELINE_STATS_H
+#define AIS_PIPELINE_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ais
+{
+
+/**
+ * @brief 单级统计
+ */
+struct StageStats
+{
+    size_t depth = 0;           // 当前排队数（近似）
+    uint64_t processed = 0;     // 已处理数
+    uint64_t dropped = 0;       // 队列满丢弃数
+    uint64_t failed = 0;        // 处理失败数（解析失败、发送失败等）
+    double avgLatencyUs = 0.0;  // 平均延迟（微秒）
+    uint64_t maxLatencyUs = 0;  // 最大延迟（微秒）
+};
+
+/**
+ * @brief 流水线统计
+ *
+ * receive：接收回调入队耗时；parse：从接收到解析、状态更新完成；send：从入发送队列到发出（按记录计）
+ */
+struct PipelineStats
+{
+    bool enabled = false;       // 是否启用流水线（否则在接收回调线程中同步处理）
+    bool sharded = false;       // 是否按MMSI分发到各工作线程
+    size_t workers = 0;         // 解析工作线程数
+    uint64_t datagrams = 0;     // 已发送数据报数（合批时一个数据报含多条记录）
+    uint64_t suppressed = 0;    // 死区过滤抑制的转发数
+    uint64_t anomalies = 0;     // 运动学校验发现的异常报告数
+    uint64_t quarantined = 0;   // 其中被隔离（未进入船舶状态）的报告数
+    StageStats receive;
+    StageStats parse;
+    StageStats send;
+};
+
+/**
+ * @brief 单级计数器，多线程并发更新，只用relaxed原子操作
+ */
+class StageCounter
+{
+public:
+    void record(uint64_t latencyUs)
+    {
+        processed_.fetch_add(1, std::memory_order_relaxed);
+        latencySumUs_.fetch_add(latencyUs, std::memory_order_relaxed);
+        uint64_t current = latencyMaxUs_.load(std::memory_order_relaxed);
+        while (latencyUs > current &&
+               !latencyMaxUs_.compare_exchange_weak(current, latencyUs, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @return 计数前的丢弃数（便于按间隔打印告警）
+     */
+    uint64_t drop() { return dropped_.fetch_add(1, std::memory_order_relaxed); }
+
+    void fail() { failed_.fetch_add(1, std::memory_order_relaxed); }
+
+    StageStats stats(size_t depth) const
+    {
+        StageStats stats;
+        stats.depth = depth;
+        stats.processed = processed_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        stats.failed = failed_.load(std::memory_order_relaxed);
+        stats.maxLatencyUs = latencyMaxUs_.load(std::memory_order_relaxed);
+        if (stats.processed > 0) {
+            stats.avgLatencyUs = static_cast<double>(latencySumUs_.load(std::memory_order_relaxed)) / stats.processed;
+        }
+        return stats;
+    }
+
+private:
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> latencySumUs_{0};
+    std::atomic<uint64_t> latencyMaxUs_{0};
+};
+
+} // namespace ais
+
+#endif // AIS_PIPELINE_STATS_H
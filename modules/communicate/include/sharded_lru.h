@@ -0,0 +1,509 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        sharded_lru.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 分片加锁的并发LRU缓存（按键哈希分散到多个独立CLRU）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        增加淘汰回调和分步超时淘汰接口Tick
+3             2026-10-18     cjx        公开键到分片的映射GetShardIndex，供调用方按分片分配写线程
+
+*****************************************************************/
+
+#ifndef SHARDED_LRU_H_
+#define SHARDED_LRU_H_
+
+#include "lru.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief 分片加锁的并发LRU缓存
+ *
+ * 键经哈希后选择N个分片之一（N取2的幂），每个分片是独立的CLRU，拥有自己的锁、链表和哈希表，
+ * 不同分片上的读写互不阻塞。
+ * - 容量和弹性按分片平均分配，总容量限制是近似的（单个分片满即淘汰本分片最旧结点）
+ * - 存活时间在各分片内独立检查
+ * - 数量、统计信息在查询时逐分片汇总，写路径上不维护全局计数
+ * - 分片类型默认为CLRU，可替换为接口一致的CFlatLRU等实现
+ * - 跨分片的按时间排序接口（GetLatest/GetKeysByAccessTime/GetTopNKeys）以秒级访问时间合并，
+ *   同一秒内不同分片的先后顺序不保证
+ */
+template <class K, class T, class Lock = std::mutex, class Hash = std::hash<K>,
+          class ShardImpl = CLRU<K, T, Lock>>
+class CShardedLRU
+{
+public:
+    typedef ShardImpl shard_type;
+    typedef typename shard_type::CacheStats CacheStats;
+    typedef typename shard_type::evict_callback evict_callback;
+
+    static constexpr size_t MAX_SHARDS = 1024; /**< 最大分片数 */
+
+public:
+    /**
+     * @brief 构造函数
+     * @param shardCount [in] 分片数，向上取2的幂，0按1处理
+     * @param maxSize [in] 总结点最大数，0表示不限制
+     * @param elasticity [in] 总弹性数量
+     * @param maxTimeSpan [in] 最大时间间隔（秒），0表示不限制
+     */
+    CShardedLRU(size_t shardCount, size_t maxSize, size_t elasticity, time_t maxTimeSpan)
+        : m_maxSize(maxSize), m_elasticity(elasticity), m_maxTimeSpan(maxTimeSpan)
+    {
+        Build(shardCount);
+    }
+
+public:
+    /**
+     * @brief 获取分片数
+     */
+    size_t GetShardCount() const
+    {
+        return m_shards.size();
+    }
+
+    /**
+     * @brief 获取键所在分片的序号（0 ~ GetShardCount()-1），同一键始终映射到同一分片
+     */
+    size_t GetShardIndex(const K &key) const
+    {
+        return ShardIndex(key);
+    }
+
+    /**
+     * 获取缓存数目（逐分片汇总，并发写入时为近似值）
+     * @return 当前缓存大小
+     */
+    size_t GetSize() const
+    {
+        size_t size = 0;
+        for (const auto &shard : m_shards)
+        {
+            size += shard->GetSize();
+        }
+        return size;
+    }
+
+    /**
+     * 缓存是否为空
+     * @return true: 为空; false: 不为空
+     */
+    bool IsEmpty() const
+    {
+        for (const auto &shard : m_shards)
+        {
+            if (!shard->IsEmpty())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * 清空缓存
+     */
+    void Clear()
+    {
+        for (auto &shard : m_shards)
+        {
+            shard->Clear();
+        }
+    }
+
+public:
+    /**
+     * @brief 重置缓存容量和存活时间配置，按分片平均分配
+     * @param maxSize 总最大容量，0表示不限制
+     * @param elasticity 总弹性大小
+     * @param maxTimeSpan 最大存活时间(秒)，0表示不限制
+     */
+    void Reset(size_t maxSize, size_t elasticity, time_t maxTimeSpan)
+    {
+        m_maxSize = maxSize;
+        m_elasticity = elasticity;
+        m_maxTimeSpan = maxTimeSpan;
+        for (auto &shard : m_shards)
+        {
+            shard->Reset(PerShard(m_maxSize), PerShard(m_elasticity), m_maxTimeSpan);
+        }
+    }
+
+    /**
+     * @brief 重置分片数和缓存配置
+     * @param shardCount 分片数，与当前不同时重建所有分片（已有数据清空）
+     * @param maxSize 总最大容量，0表示不限制
+     * @param elasticity 总弹性大小
+     * @param maxTimeSpan 最大存活时间(秒)，0表示不限制
+     * @note 重建分片不是线程安全的，只能在没有并发访问时调用（如初始化阶段）
+     */
+    void Reset(size_t shardCount, size_t maxSize, size_t elasticity, time_t maxTimeSpan)
+    {
+        m_maxSize = maxSize;
+        m_elasticity = elasticity;
+        m_maxTimeSpan = maxTimeSpan;
+        if (RoundShards(shardCount) != m_shards.size())
+        {
+            Build(shardCount);
+            return;
+        }
+        Reset(maxSize, elasticity, maxTimeSpan);
+    }
+
+    /**
+     * @brief 设置结点淘汰回调（所有分片共用）
+     * @param callback [in] 在被淘汰结点所在分片的锁内执行，回调中不得再访问本缓存
+     */
+    void SetEvictCallback(const evict_callback &callback)
+    {
+        m_onEvict = callback;
+        for (auto &shard : m_shards)
+        {
+            shard->SetEvictCallback(callback);
+        }
+    }
+
+    /**
+     * @brief 分步执行超时淘汰，逐分片加锁，每个分片最多淘汰maxCountPerShard个
+     * @return 本次淘汰的结点总数
+     */
+    size_t Tick(size_t maxCountPerShard)
+    {
+        size_t evicted = 0;
+        for (auto &shard : m_shards)
+        {
+            evicted += shard->Tick(maxCountPerShard);
+        }
+        return evicted;
+    }
+
+    /**
+     * 插入一个键值对（key，value）到缓存中
+     * @param key [in] 键
+     * @param value [in] 值
+     * @return true: 插入成功; false: 插入失败
+     */
+    bool Insert(const K &key, const T &value)
+    {
+        return Shard(key).Insert(key, value);
+    }
+
+    /**
+     * @brief 原地更新给定键对应的值，不存在时先插入默认构造的值再更新
+     * @param key [in] 键
+     * @param func [in] 更新函数，签名为 void(T &value)，在分片锁内调用
+     * @return true: 新插入结点; false: 更新已有结点
+     */
+    template <typename Func>
+    bool Upsert(const K &key, Func func)
+    {
+        return Shard(key).Upsert(key, std::move(func));
+    }
+
+    /**
+     * 缓存中是否存在给定键对应的结点
+     * @param key [in] 键
+     * @return true: 存在对应的键值; false: 不存在对应的键值
+     */
+    bool IsExist(const K &key) const
+    {
+        return Shard(key).IsExist(key);
+    }
+
+    /**
+     * 删除缓存中包含给定键所指向的结点
+     * @param key [in] 键
+     * @return true: 删除成功; false: 删除失败
+     */
+    bool Erase(const K &key)
+    {
+        return Shard(key).Erase(key);
+    }
+
+    /**
+     * 查找缓存中给定键对应的结点（更新访问时间）
+     * @param key [in] 键
+     * @return 包含查找结果和值的pair
+     */
+    std::pair<bool, T> Find(const K &key)
+    {
+        return Shard(key).Find(key);
+    }
+
+    /**
+     * @brief 查看指定键对应的值，但不更新访问时间和位置
+     * @param key [in] 键
+     * @return 包含查找结果和值的pair
+     */
+    std::pair<bool, T> Peek(const K &key) const
+    {
+        return Shard(key).Peek(key);
+    }
+
+    /**
+     * @brief 批量获取多个键的值
+     * @param keys [in] 要查找的键向量
+     * @return 包含找到的键值对的unordered_map
+     */
+    std::unordered_map<K, T> BatchFind(const std::vector<K> &keys)
+    {
+        std::unordered_map<K, T> result;
+        for (const auto &key : keys)
+        {
+            auto p = Shard(key).Find(key);
+            if (p.first)
+            {
+                result[key] = std::move(p.second);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief 获取缓存中所有键的列表（按分片顺序）
+     * @return 键的向量
+     */
+    std::vector<K> GetKeys() const
+    {
+        std::vector<K> keys;
+        for (const auto &shard : m_shards)
+        {
+            std::vector<K> part = shard->GetKeys();
+            keys.insert(keys.end(), part.begin(), part.end());
+        }
+        return keys;
+    }
+
+    /**
+     * @brief 获取按访问时间从新到旧排序的键列表
+     * @return 排序后的键向量
+     */
+    std::vector<K> GetKeysByAccessTime() const
+    {
+        return GetTopNKeys(static_cast<size_t>(-1));
+    }
+
+    /**
+     * @brief 获取最近访问的前N个键（从最新到最旧）
+     * @param n [in] 要获取的键数量
+     * @return 前N个键的向量
+     */
+    std::vector<K> GetTopNKeys(size_t n) const
+    {
+        // 各分片链表本身按访问时间有序，每个分片最多取前N个再合并
+        std::vector<std::pair<time_t, K>> touched;
+        for (const auto &shard : m_shards)
+        {
+            size_t count = 0;
+            shard->ForEachWithTime([&](const K &key, const T &, time_t lastTouch) {
+                if (count >= n)
+                {
+                    return false;
+                }
+                touched.emplace_back(lastTouch, key);
+                count++;
+                return true;
+            });
+        }
+
+        std::stable_sort(touched.begin(), touched.end(),
+                         [](const std::pair<time_t, K> &a, const std::pair<time_t, K> &b) {
+                             return a.first > b.first;
+                         });
+
+        std::vector<K> keys;
+        keys.reserve(std::min(n, touched.size()));
+        for (const auto &item : touched)
+        {
+            if (keys.size() >= n) break;
+            keys.push_back(item.second);
+        }
+        return keys;
+    }
+
+    /**
+     * @brief 获取最新插入或访问的键值对
+     * @return 包含最新键值对的optional，如果缓存为空则返回std::nullopt
+     */
+    std::optional<std::pair<K, T>> GetLatest() const
+    {
+        std::optional<std::pair<K, T>> latest;
+        time_t latestTouch = 0;
+        for (const auto &shard : m_shards)
+        {
+            shard->ForEachWithTime([&](const K &key, const T &value, time_t lastTouch) {
+                if (!latest || lastTouch > latestTouch)
+                {
+                    latest = std::make_pair(key, value);
+                    latestTouch = lastTouch;
+                }
+                return false;
+            });
+        }
+        return latest;
+    }
+
+    /**
+     * @brief 获取缓存统计信息（逐分片汇总）
+     * @return 缓存统计信息结构体，容量相关字段为总配置值
+     */
+    CacheStats GetStats() const
+    {
+        CacheStats stats;
+        stats.current_size = 0;
+        stats.max_size = m_maxSize;
+        stats.elasticity = m_elasticity;
+        stats.max_time_span = m_maxTimeSpan;
+        stats.oldest_access_time = 0;
+        stats.newest_access_time = 0;
+        stats.evicted_by_capacity = 0;
+        stats.evicted_by_time = 0;
+
+        for (const auto &shard : m_shards)
+        {
+            const CacheStats part = shard->GetStats();
+            stats.current_size += part.current_size;
+            stats.evicted_by_capacity += part.evicted_by_capacity;
+            stats.evicted_by_time += part.evicted_by_time;
+            if (part.current_size == 0)
+            {
+                continue;
+            }
+            if (stats.oldest_access_time == 0 || part.oldest_access_time < stats.oldest_access_time)
+            {
+                stats.oldest_access_time = part.oldest_access_time;
+            }
+            stats.newest_access_time = std::max(stats.newest_access_time, part.newest_access_time);
+        }
+        return stats;
+    }
+
+    /**
+     * @brief 遍历缓存中的所有元素（逐分片加锁，分片内从新到旧）
+     * @param func [in] 处理每个键值对的函数，返回false可中断遍历
+     */
+    template<typename Func>
+    void ForEach(Func func) const
+    {
+        bool stop = false;
+        for (const auto &shard : m_shards)
+        {
+            shard->ForEach([&](const K &key, const T &value) {
+                stop = !func(key, value);
+                return !stop;
+            });
+            if (stop) break;
+        }
+    }
+
+    /**
+     * @brief 遍历缓存中的所有元素（包含访问时间）
+     * @param func [in] 处理每个键值对和访问时间的函数，返回false可中断遍历
+     */
+    template<typename Func>
+    void ForEachWithTime(Func func) const
+    {
+        bool stop = false;
+        for (const auto &shard : m_shards)
+        {
+            shard->ForEachWithTime([&](const K &key, const T &value, time_t lastTouch) {
+                stop = !func(key, value, lastTouch);
+                return !stop;
+            });
+            if (stop) break;
+        }
+    }
+
+protected:
+    /**
+     * 分片数向上取2的幂
+     */
+    static size_t RoundShards(size_t shardCount)
+    {
+        shardCount = std::min(std::max<size_t>(shardCount, 1), MAX_SHARDS);
+        size_t rounded = 1;
+        while (rounded < shardCount)
+        {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    /**
+     * 重建分片
+     */
+    void Build(size_t shardCount)
+    {
+        const size_t count = RoundShards(shardCount);
+        m_shardBits = 0;
+        while ((static_cast<size_t>(1) << m_shardBits) < count)
+        {
+            m_shardBits++;
+        }
+
+        m_shards.clear();
+        m_shards.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_shards.emplace_back(new shard_type(PerShard(m_maxSize), PerShard(m_elasticity), m_maxTimeSpan));
+            if (m_onEvict)
+            {
+                m_shards.back()->SetEvictCallback(m_onEvict);
+            }
+        }
+    }
+
+    /**
+     * 总量平均分配到各分片（向上取整，非0总量每个分片至少为1）
+     */
+    size_t PerShard(size_t total) const
+    {
+        const size_t count = static_cast<size_t>(1) << m_shardBits;
+        return total == 0 ? 0 : (total + count - 1) / count;
+    }
+
+    /**
+     * 键到分片的映射：哈希值再做一次Fibonacci散列取高位，避免MMSI等低位规律的键集中到少数分片
+     */
+    size_t ShardIndex(const K &key) const
+    {
+        if (m_shardBits == 0)
+        {
+            return 0;
+        }
+        const uint64_t h = static_cast<uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(h >> (64 - m_shardBits));
+    }
+
+    shard_type &Shard(const K &key)
+    {
+        return *m_shards[ShardIndex(key)];
+    }
+
+    const shard_type &Shard(const K &key) const
+    {
+        return *m_shards[ShardIndex(key)];
+    }
+
+protected:
+    std::vector<std::unique_ptr<shard_type>> m_shards; /**< 分片 */
+    unsigned m_shardBits = 0; /**< 分片数的对数 */
+    Hash m_hash;              /**< 键哈希函数 */
+
+    size_t m_maxSize;     /**< 总结点最大数 */
+    size_t m_elasticity;  /**< 总弹性数量 */
+    time_t m_maxTimeSpan; /**< 最大时间间隔 */
+
+    evict_callback m_onEvict; /**< 淘汰回调 */
+};
+
+#endif // SHARDED_LRU_H_
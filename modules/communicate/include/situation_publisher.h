@@ -0,0 +1,124 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        situation_publisher.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 船舶态势周期发布（关键帧+字段级增量）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        记录头改用EventRecord
+
+*****************************************************************/
+
+#ifndef AIS_SITUATION_PUBLISHER_H
+#define AIS_SITUATION_PUBLISHER_H
+
+#include "vessel_snapshot.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 船舶态势周期发布器
+ *
+ * 每次publish()与上一帧快照按MMSI归并比较，只输出有变化的船舶及其变化的字段；
+ * 每keyframeInterval帧输出一次全量关键帧（接收端以关键帧重建全表，丢失增量帧后可自愈）。
+ * 输出速率只取决于发布周期和船舶数，与输入突发无关。
+ *
+ * 每帧依次输出：帧头、各船记录、消失船舶的删除记录，每条记录调用一次输出函数。
+ * - CSV：帧头 F,seq,timeMs,K|D,recordCount；
+ *        关键帧记录 K,<VesselState::toCsv()各列>；
+ *        增量记录 D,<同样的列>，未变化的列为空（mmsi列总是有值）；
+ *        删除记录 R,mmsi
+ * - 二进制（小端）：记录头8字节 魔数0xA6 + 版本 + 类型('F'/'K'/'D'/'R') + 保留 + MMSI(u32)，
+ *        帧头之后为 帧序号(u32) + 记录数(u32) + 时间(i64)，K/D记录之后为 字段掩码(u32) + 掩码中各字段
+ *        （按位序：经纬度i32*2、航速u16(0.1节)、航向u16(0.1度)、艏向i16、导航状态u8、船名/呼号(u8长度+文本)、
+ *        IMO u32、船型u8、尺寸u16*2+u8*2、吃水u16(0.1米)、目的地(u8长度+文本)、位置时间i64、静态时间i64）
+ *
+ * @note 非线程安全，由维护线程独占调用
+ */
+class SituationPublisher
+{
+public:
+    /**
+     * @brief 字段掩码位
+     */
+    enum Field : uint32_t
+    {
+        POSITION = 1u << 0,         // 经纬度
+        SPEED = 1u << 1,
+        COURSE = 1u << 2,
+        HEADING = 1u << 3,
+        NAV_STATUS = 1u << 4,
+        NAME = 1u << 5,
+        CALLSIGN = 1u << 6,
+        IMO = 1u << 7,
+        SHIP_TYPE = 1u << 8,
+        DIMENSIONS = 1u << 9,
+        DRAUGHT = 1u << 10,
+        DESTINATION = 1u << 11,
+        POSITION_TIME = 1u << 12,
+        STATIC_TIME = 1u << 13,
+        ALL_FIELDS = (1u << 14) - 1
+    };
+
+    /**
+     * @brief 输出函数，每条记录调用一次（CSV记录带结尾'\0'）
+     */
+    typedef std::function<void(const char *data, size_t size, uint32_t mmsi)> emit_func;
+
+    /**
+     * @brief 构造函数
+     * @param keyframeInterval 关键帧间隔（帧数），非正数表示每帧都是关键帧
+     * @param binary 是否输出二进制记录（否则为CSV）
+     * @param emit 输出函数
+     */
+    SituationPublisher(int keyframeInterval, bool binary, emit_func emit);
+
+    /**
+     * @brief 发布一帧
+     * @param snapshot 当前船舶状态快照
+     * @return 本帧输出的船舶记录数（不含帧头）
+     */
+    size_t publish(const std::shared_ptr<const VesselSnapshot> &snapshot);
+
+    /**
+     * @brief 比较两个状态，返回变化的字段掩码
+     */
+    static uint32_t diff(const VesselState &prev, const VesselState &cur);
+
+    uint64_t getFrameCount() const { return frames_; }
+
+private:
+    void emitFrameHeader(bool keyframe, size_t records, int64_t timeMs);
+    void emitVessel(char kind, const VesselState &state, uint32_t mask);
+    void emitRemoved(uint32_t mmsi);
+    void beginBinary(char kind, uint32_t mmsi);
+    void emitBuffer(uint32_t mmsi);
+
+    int keyframeInterval_;
+    bool binary_;
+    emit_func emit_;
+
+    std::shared_ptr<const VesselSnapshot> previous_;    // 上一帧已发布的快照（只读，可安全持有）
+    uint64_t frames_ = 0;
+    std::string buffer_;
+    std::vector<std::pair<const VesselState *, uint32_t>> changed_;    // 本帧待输出的船舶及字段掩码
+    std::vector<uint32_t> removed_;                                    // 本帧消失的船舶
+};
+
+} // namespace ais
+
+#endif // AIS_SITUATION_PUBLISHER_H
@@ -0,0 +1,53 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        vessel_snapshot.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 船舶状态表的只读快照（读者无锁访问，周期刷新）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_VESSEL_SNAPSHOT_H
+#define AIS_VESSEL_SNAPSHOT_H
+
+#include "utils/vessel_state.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 船舶状态表快照
+ *
+ * 发布后不再修改，可被任意多个读者同时持有；船舶按MMSI升序排列。
+ */
+struct VesselSnapshot
+{
+    uint64_t version = 0;               // 快照序号，每次刷新加1
+    int64_t timeMs = 0;                 // 生成时间（毫秒）
+    std::vector<VesselState> vessels;   // 按MMSI升序
+
+    /**
+     * @brief 按MMSI二分查找
+     * @return 未找到返回nullptr
+     */
+    const VesselState *find(uint32_t mmsi) const
+    {
+        auto it = std::lower_bound(vessels.begin(), vessels.end(), mmsi,
+                                   [](const VesselState &state, uint32_t key) { return state.mmsi < key; });
+        return (it != vessels.end() && it->mmsi == mmsi) ? &*it : nullptr;
+    }
+};
+
+} // namespace ais
+
+#endif // AIS_VESSEL_SNAPSHOT_H
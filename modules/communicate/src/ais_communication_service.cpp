@@ -1,8 +1,14 @@
 #include "ais_communication_service.h"
 
 #include "logger_define.h"
+#include "core/nmea_parser.h"
+#include "outbound_batcher.h"
+#include "situation_publisher.h"
+#include "utils/geo_math.h"
+#include "utils/message_fields.h"
 // #include "messages/type_definitions.h"  // 若需按具体类型进行映射需要包含
 
+#include <algorithm>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
@@ -12,9 +18,31 @@ namespace ais {
 
 using namespace std::chrono;
 
+namespace {
+
+int64_t steadyNowUs()
+{
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 流水线线程取不到数据时的退避：先让出CPU，持续空闲后短暂休眠
+ */
+void idleWait(int& idleRounds)
+{
+    if (++idleRounds < AISCommunicationService::IDLE_SPIN) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(microseconds(AISCommunicationService::IDLE_SLEEP_US));
+    }
+}
+
+} // namespace
+
 AISCommunicationService::AISCommunicationService(std::shared_ptr<AISParser> aisParser)
     : aisParser_(aisParser)
-    , shipInfoCache_(0, 0, 0)  // 默认值：不限制大小，和存活时间
+    , shipInfoCache_(1, 0, 0, 0)  // 默认值：单分片，不限制大小，和存活时间
+    , snapshot_(std::make_shared<VesselSnapshot>())
 {
     if (!aisParser_) {
         LOG_WARNING("AISParser is null, service may not work properly");
@@ -23,6 +51,8 @@ AISCommunicationService::AISCommunicationService(std::shared_ptr<AISParser> aisP
 
 AISCommunicationService::~AISCommunicationService()
 {
+    stopMaintenance();
+    stopPipeline();
 }
 
 int AISCommunicationService::initialize(const CommunicateCfg& commCfg,
@@ -66,9 +96,78 @@ int AISCommunicationService::initialize(const CommunicateCfg& commCfg,
             maxTimeSpan = static_cast<time_t>(commCfg.msgSaveTime);
         }
         
-        // 使用Reset方法重新配置LRU缓存
-        shipInfoCache_.Reset(maxSize, elasticity, maxTimeSpan);
+        // 按MMSI分片处理时每个工作线程至少独占一个缓存分片
+        const size_t workers = commCfg.workerThreads > 0 ? static_cast<size_t>(commCfg.workerThreads) : 0;
+        // 死区过滤器每个工作线程一份，同一船舶必须始终经过同一个过滤器；
+        // 运动学校验按处理顺序比较同一船舶的相邻报告，多线程乱序处理会误报时间倒退；
+        // 围栏与会遇在缓存分片锁外更新，同一船舶的两次更新由不同线程处理时可能以旧位置覆盖新位置
+        const bool deadbandRouting = commCfg.deadbandDistanceM > 0 && commCfg.publishIntervalMs <= 0;
+        const bool validatorRouting = commCfg.anomalyAction != AnomalyAction::NONE;
+        const bool trackingRouting = !commCfg.geofenceFile.empty() ||
+                                     (commCfg.cpaRangeNm > 0 && commCfg.spatialCellDeg > 0);
+        if ((deadbandRouting || validatorRouting || trackingRouting) && !commCfg.shardByMmsi && workers > 1) {
+            LOG_WARNING("{} requires per-vessel routing, shardByMmsi forced on for {} workers",
+                        deadbandRouting ? "Deadband filter" :
+                        validatorRouting ? "Kinematic validation" : "Geofence/collision tracking", workers);
+        }
+        const bool sharded = (commCfg.shardByMmsi || deadbandRouting || validatorRouting || trackingRouting) &&
+                             workers > 1;
+        size_t cacheShards = commCfg.cacheShards > 0 ? static_cast<size_t>(commCfg.cacheShards) : 1;
+        if (sharded) {
+            cacheShards = std::max(cacheShards, workers);
+        }
+
+        // 使用Reset方法重新配置LRU缓存（尚未订阅，可安全重建分片）
+        shipInfoCache_.Reset(cacheShards, maxSize, elasticity, maxTimeSpan);
+        spatialIndex_.reset();
+        if (commCfg.spatialCellDeg > 0) {
+            spatialIndex_.reset(new LiveSpatialIndex(commCfg.spatialCellDeg, std::max<size_t>(workers, 1)));
+            LOG_INFO("Live spatial index enabled: CellDeg={}", spatialIndex_->cellDeg());
+        }
+        collision_.reset();
+        if (commCfg.cpaRangeNm > 0) {
+            if (!spatialIndex_) {
+                LOG_WARNING("Collision risk requires the live spatial index (spatialCellDeg > 0), disabled");
+            } else {
+                collision_.reset(new CollisionRiskEngine(spatialIndex_.get(), commCfg.cpaRangeNm * geo::NM_TO_M,
+                    commCfg.cpaAlertNm * geo::NM_TO_M, commCfg.tcpaAlertMin * 60.0, commCfg.predictHorizonSec * 1000LL,
+                    [this](const CollisionAlert& alert) { publishAlert(alert); }));
+                LOG_INFO("Collision risk enabled: Range={}nm, CPA<={}nm, TCPA<={}min, Interval={}ms",
+                         commCfg.cpaRangeNm, commCfg.cpaAlertNm, commCfg.tcpaAlertMin, commCfg.cpaIntervalMs);
+            }
+        }
+        geofence_.reset();
+        if (!commCfg.geofenceFile.empty()) {
+            geofence_.reset(new GeofenceEngine(commCfg.geofenceCellDeg, std::max<size_t>(workers, 1),
+                [this](const GeofenceEvent& event) { publishGeofenceEvent(event); }));
+            // 区域文件有误时先不带区域运行，修正后由热加载生效
+            if (geofence_->loadZones(commCfg.geofenceFile) != 0) {
+                LOG_ERROR("Failed to load geofence zones: {}", commCfg.geofenceFile);
+            }
+        }
+        validator_.reset();
+        if (commCfg.anomalyAction != AnomalyAction::NONE) {
+            const bool quarantine = commCfg.anomalyAction == AnomalyAction::QUARANTINE;
+            validator_.reset(new KinematicValidator(commCfg.anomalyMaxSpeedKn, commCfg.anomalyCourseDeg, quarantine,
+                                                    std::max<size_t>(cacheShards, workers)));
+            LOG_INFO("Kinematic validation enabled: Action={}, MaxSpeed={}kn, CourseDeviation={}deg "
+                     "(report time is rebuilt from the UTC second, feeds delayed by 1 minute or more are not supported)",
+                     quarantine ? "QUARANTINE" : "FLAG", commCfg.anomalyMaxSpeedKn, commCfg.anomalyCourseDeg);
+        }
+        shipInfoCache_.SetEvictCallback([this](const uint32_t& mmsi, const VesselState& state, EvictReason reason) {
+            if (spatialIndex_) {
+                spatialIndex_->remove(mmsi);
+            }
+            if (collision_) {
+                collision_->remove(mmsi);
+            }
+            if (geofence_) {
+                geofence_->remove(mmsi, state.positionTimeMs);
+            }
+            onVesselEvicted(state, reason);
+        });
         
+        LOG_INFO("LRU cache shards: {}", shipInfoCache_.GetShardCount());
         if (maxSize > 0 && maxTimeSpan > 0) {
             LOG_INFO("LRU cache configured: MaxSize={}, Elasticity={}, MaxTimeSpan={}s", 
                      maxSize, elasticity, maxTimeSpan);
@@ -91,14 +190,50 @@ int AISCommunicationService::initialize(const CommunicateCfg& commCfg,
 
         commCfg_ = commCfg;
 
+        // 周期发布态势时由维护线程输出，替代逐条转发
+        publisher_.reset();
+        if (commCfg.publishIntervalMs > 0) {
+            publisher_.reset(new SituationPublisher(commCfg.keyframeInterval, commCfg.outputFormat == OutputFormat::BINARY,
+                [this](const char* data, size_t size, uint32_t mmsi) { forward(data, size, mmsi); }));
+            LOG_INFO("Situation publisher enabled: Interval={}ms, KeyframeInterval={}",
+                     commCfg.publishIntervalMs, commCfg.keyframeInterval);
+        }
+
+        // 每个处理线程一份转发上下文，流水线需在订阅前就绪
+        contexts_.clear();
+        for (size_t i = 0; i < std::max<size_t>(workers, 1); ++i) {
+            contexts_.emplace_back(new ForwardContext());
+            contexts_.back()->csvWriter.setProjection(commCfg.csvColumns);
+            if (commCfg.deadbandDistanceM > 0) {
+                contexts_.back()->deadband.reset(new DeadbandFilter(commCfg.deadbandDistanceM, commCfg.deadbandSpeedKn,
+                                                                    commCfg.deadbandCourseDeg, commCfg.deadbandMaxSilenceSec));
+            }
+        }
+        const size_t queueSize = commCfg.pipelineQueueSize > 0 ? static_cast<size_t>(commCfg.pipelineQueueSize) : 65536;
+        if (workers > 0 || commCfg.sendBatchBytes > 0) {
+            startSender(queueSize);
+        }
+        if (workers > 0) {
+            startPipeline(workers, queueSize, sharded);
+        }
+
         // 订阅本地AIS数据
         ret = communicate::SubscribeLocal("127.0.0.1", commCfg.subPort, this);
         if (ret != 0) {
             LOG_ERROR("Failed to subscribe to local AIS data on port {}: {}", commCfg.subPort, ret);
+            stopPipeline();
             return errorCode;
         }
         --errorCode;
 
+        // 不再收到报告的船舶不会触发缓存内的淘汰，由后台线程周期检查；快照、态势发布、碰撞风险计算和围栏热加载也由该线程完成
+        const bool reloadGeofence = geofence_ && commCfg.geofenceReloadSec > 0;
+        if ((maxTimeSpan > 0 || commCfg.snapshotIntervalMs > 0 || publisher_ || collision_ || reloadGeofence) &&
+            !maintThread_.joinable()) {
+            maintStop_ = false;
+            maintThread_ = std::thread(&AISCommunicationService::runMaintenance, this);
+        }
+
         LOG_INFO("AIS communication service initialized: ListenPort={}, Target={}:{}",
                  commCfg.subPort, commCfg.sendIP, commCfg.sendPort);
 
@@ -111,16 +246,51 @@ int AISCommunicationService::initialize(const CommunicateCfg& commCfg,
     }
 }
 
+int AISCommunicationService::enableStorage(const AISSaveCfg& saveCfg)
+{
+    if (isInitialized_) {
+        LOG_WARNING("Storage must be enabled before service initialization");
+        return -1;
+    }
+
+    if (!saveCfg.saveSwitch || saveCfg.storageType == StorageType::NONE) {
+        return 0;
+    }
+
+    auto storage = createStorage(saveCfg);
+    if (!storage) {
+        LOG_ERROR("Unsupported storage type: {}", static_cast<int>(saveCfg.storageType));
+        return -2;
+    }
+    if (!storage->start()) {
+        LOG_ERROR("Failed to start storage: {}", saveCfg.storagePath);
+        return -3;
+    }
+
+    storage_ = storage;
+    LOG_INFO("Local storage enabled: Type={}, Path={}",
+             static_cast<int>(saveCfg.storageType), saveCfg.storagePath);
+    return 0;
+}
+
 void AISCommunicationService::destroy()
 {
     if (!isInitialized_) {
         return;
     }
 
+    // 先停止接收回调和态势发布，再取空流水线，最后释放解析器
+    communicate::Destroy();
+    stopMaintenance();
+    stopPipeline();
+
     aisParser_.reset();
     aisParser_ = nullptr;
 
-    communicate::Destroy();
+    // 接收回调停止后再停止存储，确保已入队的数据写完
+    if (storage_) {
+        storage_->stop();
+    }
 }
 
 int AISCommunicationService::handleMsg(std::shared_ptr<void> msg)
@@ -129,57 +299,343 @@ int AISCommunicationService::handleMsg(std::shared_ptr<void> msg)
         return 0;
     }
 
-    try {
-        // 假设消息是AIS原始数据字符串
-        const char* aisData = static_cast<const char*>(msg.get());
-        if (!aisData) {
-            LOG_WARNING("Received empty AIS message");
-            return 0;
+    // 假设消息是AIS原始数据字符串
+    if (!msg) {
+        LOG_WARNING("Received empty AIS message");
+        return 0;
+    }
+
+    const int64_t receiveMs = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+
+    if (!rawQueues_.empty()) {
+        // 流水线模式：只把缓冲区放入队列，队列满时丢弃，不阻塞接收
+        const int64_t receiveUs = steadyNowUs();
+        BoundedQueue<RawMessage>& queue = *rawQueues_[sharded_ ? routeWorker(static_cast<const char*>(msg.get())) : 0];
+        if (!queue.tryPush(RawMessage{std::move(msg), receiveUs, receiveMs})) {
+            if (receiveStage_.drop() % 10000 == 0) {
+                LOG_WARNING("Receive queue full, dropping AIS data (dropped={})",
+                            receiveStage_.stats(0).dropped);
+            }
+            return -1;
         }
+        receiveStage_.record(static_cast<uint64_t>(steadyNowUs() - receiveUs));
+        return 0;
+    }
+
+    const int64_t startUs = steadyNowUs();
+    receiveStage_.record(0);
+    int ret = processRaw(static_cast<const char*>(msg.get()), receiveMs, *contexts_[0]);
+    if (ret < 0) {
+        parseStage_.fail();
+        return -1;
+    }
+    if (ret > 0) {
+        parseStage_.fail();
+    }
+    parseStage_.record(static_cast<uint64_t>(steadyNowUs() - startUs));
+    return 0;
+}
 
+int AISCommunicationService::processRaw(const char* aisData, int64_t receiveMs, ForwardContext& ctx)
+{
+    try {
         LOG_DEBUG("Received AIS data: {}", aisData);
 
         // 使用外部提供的AISParser解析消息
-        auto parsedMessage = aisParser_->parse(aisData);
-        if (parsedMessage) {
-            processAISMessage(*parsedMessage);
-        } else {
-            LOG_DEBUG("Failed to parse AIS message: {}", *aisData);
+        std::shared_ptr<const AISMessage> parsedMessage = aisParser_->parse(aisData);
+        if (!parsedMessage) {
+            LOG_DEBUG("Failed to parse AIS message: {}", aisData);
+            return 1;
+        }
+
+        // 运动学校验在进入船舶状态前进行，隔离的报告不更新状态、不转发、不存储
+        if (validator_) {
+            Anomaly anomaly;
+            if (validator_->check(*parsedMessage, receiveMs, anomaly) != AnomalyType::NONE) {
+                publishAnomaly(anomaly);
+                if (anomaly.quarantined) {
+                    return 0;
+                }
+            }
         }
 
+        processAISMessage(*parsedMessage, receiveMs, ctx);
+
+        // 交给后台线程持久化，队列满时丢弃，不阻塞处理
+        if (storage_) {
+            storage_->store(parsedMessage, receiveMs);
+        }
         return 0;
 
     } catch (const std::exception& e) {
-        LOG_ERROR("Exception in handleMsg: {}", e.what());
+        LOG_ERROR("Exception while processing AIS message: {}", e.what());
         return -1;
     }
 }
 
-void AISCommunicationService::processAISMessage(const AISMessage& aisMsg)
+void AISCommunicationService::processAISMessage(const AISMessage& aisMsg, int64_t receiveMs, ForwardContext& ctx)
 {
     uint32_t mmsi = aisMsg.mmsi;
-    std::string csvData = aisMsg.toCsv();
 
-    if (communicate::SendGeneralMessage(commCfg_.sendIP.data(), commCfg_.sendPort,
-                                    csvData.data(), csvData.size() + 1) != 0)
-    {
-        // 使用LRU缓存自动管理船舶信息
-        bool inserted = shipInfoCache_.Insert(mmsi, csvData);
-        
+    // 合并到船舶综合状态，位置与静态字段互不覆盖，已有船舶原地更新
+    if (VesselState::accepts(aisMsg.type)) {
+        bool moved = false;
+        CollisionRiskEngine::Track track;
+        bool inserted = shipInfoCache_.Upsert(mmsi, [&](VesselState& state) {
+            if (!state.update(aisMsg, receiveMs) || !isVesselPositionType(aisMsg.type)) {
+                return;
+            }
+            // 网格索引在缓存分片锁内更新，同一船舶的多次更新不会乱序（与淘汰回调的加锁顺序一致）
+            if (spatialIndex_) {
+                spatialIndex_->update(mmsi, state.latitude, state.longitude);
+            }
+            moved = true;
+            track = CollisionRiskEngine::toTrack(state);
+        });
         if (inserted) {
-            LOG_INFO("New/Updated ship info: MMSI={}", mmsi);
-        } else {
-            LOG_WARNING("Failed to insert ship info into cache: MMSI={}", mmsi);
+            LOG_INFO("New ship info: MMSI={}", mmsi);
+        }
+
+        // 会遇和围栏判断较慢（围栏回调还会发出事件），放在分片锁外，不阻塞同分片的其他船舶和查询；
+        // 启用二者时强制按MMSI分片（见initialize），同一船舶的更新由同一线程按序完成
+        if (moved) {
+            if (collision_) {
+                collision_->update(track);
+            }
+            if (geofence_) {
+                geofence_->update(mmsi, track.latitude, track.longitude, receiveMs);
+            }
         }
     }
-    else
-    {
-        LOG_ERROR("Failed to send ship info: MMSI={}", mmsi);
+
+    // 周期发布态势时不逐条转发
+    if (publisher_) {
+        return;
     }
 
+    // 相对上次转发变化不超过死区的位置报告不转发
+    if (ctx.deadband && !ctx.deadband->accept(aisMsg, receiveMs)) {
+        LOG_DEBUG("Suppressed by dead-band: MMSI={}", mmsi);
+        return;
+    }
+
+    // 按配置选择转发格式，二进制记录按定长发送，CSV文本带结尾'\0'；二进制模式下不生成CSV文本
+    if (commCfg_.outputFormat == OutputFormat::BINARY) {
+        ctx.binaryBuffer.clear();
+        if (!BinaryCodec::serialize(aisMsg, ctx.binaryBuffer)) {
+            LOG_DEBUG("Message type {} has no binary record format, skip forwarding: MMSI={}",
+                      static_cast<int>(aisMsg.type), mmsi);
+            return;
+        }
+        forward(ctx.binaryBuffer.data(), ctx.binaryBuffer.size(), mmsi);
+        LOG_DEBUG("Processed ship info: MMSI={}, Type={}", mmsi, static_cast<int>(aisMsg.type));
+        return;
+    }
+
+    const std::string& csvData = ctx.csvWriter.write(aisMsg);
+    forward(csvData.data(), csvData.size() + 1, mmsi);
+
     LOG_DEBUG("Processed ship info: MMSI={}, Content={}", mmsi, csvData);
 }
 
+void AISCommunicationService::forward(const char* payload, size_t size, uint32_t mmsi)
+{
+    if (sendQueue_) {
+        if (!sendQueue_->tryPush(OutboundMessage{std::string(payload, size), steadyNowUs()})) {
+            if (sendStage_.drop() % 10000 == 0) {
+                LOG_WARNING("Send queue full, dropping outbound data (dropped={})",
+                            sendStage_.stats(0).dropped);
+            }
+        }
+        return;
+    }
+
+    const int64_t startUs = steadyNowUs();
+    if (communicate::SendGeneralMessage(commCfg_.sendIP.data(), commCfg_.sendPort, payload, size) != 0) {
+        sendStage_.fail();
+        LOG_ERROR("Failed to send ship info: MMSI={}", mmsi);
+        return;
+    }
+    sendStage_.record(static_cast<uint64_t>(steadyNowUs() - startUs));
+    datagrams_.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t AISCommunicationService::routeWorker(const char* aisData)
+{
+    NMEAHeader header;
+    if (!NMEAParser::peekHeader(aisData, header)) {
+        return 0;
+    }
+
+    const size_t workers = rawQueues_.size();
+    const bool multipart = header.fragmentCount > 1 && header.sequenceId >= 0;
+    const size_t slot = multipart ? (header.channel == 'B' || header.channel == '2' ? 10 : 0) + header.sequenceId : 0;
+
+    // 工作线程独占的缓存分片：分片序号对线程数取模
+    if (header.mmsi != 0) {
+        const size_t worker = shipInfoCache_.GetShardIndex(header.mmsi) % workers;
+        if (multipart) {
+            fragmentRoutes_[slot].store(static_cast<uint32_t>(worker), std::memory_order_relaxed);
+        }
+        return worker;
+    }
+    if (multipart) {
+        return fragmentRoutes_[slot].load(std::memory_order_relaxed) % workers;
+    }
+    return 0;
+}
+
+void AISCommunicationService::startPipeline(size_t workers, size_t queueSize, bool sharded)
+{
+    sharded_ = sharded;
+    rawQueues_.clear();
+    for (size_t i = 0; i < (sharded ? workers : 1); ++i) {
+        rawQueues_.emplace_back(new BoundedQueue<RawMessage>(queueSize));
+    }
+
+    workersRunning_ = true;
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back(&AISCommunicationService::runWorker, this, i);
+    }
+
+    LOG_INFO("Processing pipeline started: Workers={}, QueueSize={}, ShardByMmsi={}",
+             workers, rawQueues_[0]->capacity(), sharded);
+}
+
+void AISCommunicationService::startSender(size_t queueSize)
+{
+    sendQueue_.reset(new BoundedQueue<OutboundMessage>(queueSize));
+
+    senderRunning_ = true;
+    sender_ = std::thread(&AISCommunicationService::runSender, this);
+
+    if (commCfg_.sendBatchBytes > 0) {
+        LOG_INFO("Outbound batching enabled: MaxBytes={}, MaxDelay={}ms",
+                 commCfg_.sendBatchBytes, commCfg_.sendBatchDelayMs);
+    }
+}
+
+void AISCommunicationService::stopPipeline()
+{
+    // 工作线程取空接收队列后退出，之后发送线程取空发送队列后退出
+    workersRunning_ = false;
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+
+    senderRunning_ = false;
+    if (sender_.joinable()) {
+        sender_.join();
+    }
+}
+
+void AISCommunicationService::runWorker(size_t index)
+{
+    ForwardContext& ctx = *contexts_[index];
+    BoundedQueue<RawMessage>& queue = *rawQueues_[sharded_ ? index : 0];
+    RawMessage item;
+    int idleRounds = 0;
+
+    while (true) {
+        if (!queue.tryPop(item)) {
+            if (!workersRunning_.load(std::memory_order_acquire)) {
+                break;
+            }
+            idleWait(idleRounds);
+            continue;
+        }
+        idleRounds = 0;
+
+        int ret = processRaw(static_cast<const char*>(item.data.get()), item.receiveMs, ctx);
+        item.data.reset();
+        if (ret != 0) {
+            parseStage_.fail();
+        }
+        if (ret >= 0) {
+            parseStage_.record(static_cast<uint64_t>(steadyNowUs() - item.receiveUs));
+        }
+    }
+}
+
+void AISCommunicationService::runSender()
+{
+    auto send = [this](const char* data, size_t size, const std::vector<int64_t>& enqueueUs) {
+        if (communicate::SendGeneralMessage(commCfg_.sendIP.data(), commCfg_.sendPort, data, size) != 0) {
+            for (size_t i = 0; i < enqueueUs.size(); ++i) {
+                sendStage_.fail();
+            }
+            LOG_ERROR("Failed to send ship info, size={}, records={}", size, enqueueUs.size());
+            return -1;
+        }
+        datagrams_.fetch_add(1, std::memory_order_relaxed);
+        const int64_t nowUs = steadyNowUs();
+        for (int64_t us : enqueueUs) {
+            sendStage_.record(static_cast<uint64_t>(nowUs - us));
+        }
+        return 0;
+    };
+
+    // 未启用合批时上限为0，每条记录都会立即发送
+    const size_t maxBytes = commCfg_.sendBatchBytes > 0 ? static_cast<size_t>(commCfg_.sendBatchBytes) : 0;
+    const int64_t maxDelayUs = std::max(commCfg_.sendBatchDelayMs, 0) * 1000LL;
+    OutboundBatcher batcher(maxBytes, maxDelayUs, commCfg_.outputFormat != OutputFormat::BINARY, send);
+
+    OutboundMessage item;
+    int idleRounds = 0;
+
+    while (true) {
+        if (!sendQueue_->tryPop(item)) {
+            batcher.poll(steadyNowUs());
+            // 工作线程全部退出后才可能不再有新数据
+            if (!senderRunning_.load(std::memory_order_acquire)) {
+                batcher.flush();
+                break;
+            }
+            idleWait(idleRounds);
+            continue;
+        }
+        idleRounds = 0;
+
+        batcher.add(item.payload.data(), item.payload.size(), item.enqueueUs);
+        batcher.poll(steadyNowUs());
+    }
+}
+
+PipelineStats AISCommunicationService::getPipelineStats() const
+{
+    size_t parseDepth = 0;
+    for (const auto& queue : rawQueues_) {
+        parseDepth += queue->sizeApprox();
+    }
+
+    PipelineStats stats;
+    stats.enabled = !rawQueues_.empty();
+    stats.sharded = sharded_;
+    stats.workers = workers_.size();
+    stats.datagrams = datagrams_.load(std::memory_order_relaxed);
+    for (const auto& ctx : contexts_) {
+        if (ctx->deadband) {
+            stats.suppressed += ctx->deadband->getSuppressedCount();
+        }
+    }
+    if (validator_) {
+        const auto counts = validator_->getCounts();
+        for (uint64_t count : counts) {
+            stats.anomalies += count;
+        }
+        if (validator_->quarantine()) {
+            stats.quarantined = stats.anomalies - counts[static_cast<size_t>(AnomalyType::COURSE_MISMATCH)];
+        }
+    }
+    stats.receive = receiveStage_.stats(0);
+    stats.parse = parseStage_.stats(parseDepth);
+    stats.send = sendStage_.stats(sendQueue_ ? sendQueue_->sizeApprox() : 0);
+    return stats;
+}
+
 size_t AISCommunicationService::getShipCount() const
 {
     return shipInfoCache_.GetSize();
@@ -188,17 +644,311 @@ size_t AISCommunicationService::getShipCount() const
 void AISCommunicationService::clearShipInfo()
 {
     shipInfoCache_.Clear();
+    if (spatialIndex_) {
+        spatialIndex_->clear();
+    }
+    if (collision_) {
+        collision_->clear();
+    }
+    if (geofence_) {
+        geofence_->clear();
+    }
+    if (validator_) {
+        validator_->clear();
+    }
     LOG_INFO("Cleared all ship information");
 }
 
+std::string AISCommunicationService::getCsvSchema() const
+{
+    CsvWriter writer;
+    writer.setProjection(commCfg_.csvColumns);
+    return writer.schemaPreamble();
+}
+
+StorageStats AISCommunicationService::getStorageStats() const
+{
+    return storage_ ? storage_->getStats() : StorageStats();
+}
+
+std::vector<Anomaly> AISCommunicationService::getRecentAnomalies() const
+{
+    return validator_ ? validator_->getRecent() : std::vector<Anomaly>();
+}
+
+void AISCommunicationService::onVesselEvicted(const VesselState& state, EvictReason reason)
+{
+    if (reason == EvictReason::TIME) {
+        lostVessels_.fetch_add(1, std::memory_order_relaxed);
+        LOG_INFO("Vessel lost: MMSI={}, Name={}, LastUpdate={}, Messages={}",
+                 state.mmsi, state.vesselName, state.lastUpdateMs, state.messageCount);
+    } else {
+        LOG_DEBUG("Vessel evicted by cache capacity: MMSI={}", state.mmsi);
+    }
+}
+
+void AISCommunicationService::onCollisionAlert(const CollisionAlert& alert)
+{
+    if (alert.active) {
+        LOG_INFO("Collision risk: MMSI={}/{}, CPA={:.0f}m, TCPA={:.0f}s, Range={:.0f}m",
+                 alert.mmsiA, alert.mmsiB, alert.cpaM, alert.tcpaSec, alert.rangeM);
+    } else {
+        LOG_INFO("Collision risk cleared: MMSI={}/{}", alert.mmsiA, alert.mmsiB);
+    }
+}
+
+void AISCommunicationService::onGeofenceEvent(const GeofenceEvent& event)
+{
+    LOG_INFO("Geofence {}: MMSI={}, Zone={} \"{}\"",
+             event.type == GeofenceEventType::ENTER ? "enter" : (event.type == GeofenceEventType::EXIT ? "exit" : "dwell"),
+             event.mmsi, event.zoneId, event.zoneName);
+}
+
+void AISCommunicationService::onAnomaly(const Anomaly& anomaly)
+{
+    (void)anomaly;
+    LOG_DEBUG("Kinematic anomaly {}: MMSI={}, Position=({:.6f}, {:.6f}), ImpliedSpeed={:.1f}kn, Quarantined={}",
+              KinematicValidator::typeName(anomaly.type), anomaly.mmsi, anomaly.latitude, anomaly.longitude,
+              anomaly.impliedSpeedKn, anomaly.quarantined);
+}
+
+void AISCommunicationService::sendEvent(const std::string& record, uint32_t mmsi)
+{
+    // CSV记录与逐条转发保持一致，带结尾'\0'发送
+    const size_t size = commCfg_.outputFormat == OutputFormat::BINARY ? record.size() : record.size() + 1;
+    forward(record.c_str(), size, mmsi);
+    if (commCfg_.alertPort > 0 &&
+        communicate::SendGeneralMessage("127.0.0.1", commCfg_.alertPort, record.c_str(), size) != 0) {
+        LOG_WARNING("Failed to send event to local port {}", commCfg_.alertPort);
+    }
+}
+
+void AISCommunicationService::publishAlert(const CollisionAlert& alert)
+{
+    CollisionRiskEngine::format(alert, commCfg_.outputFormat == OutputFormat::BINARY, alertBuffer_);
+    sendEvent(alertBuffer_, alert.mmsiA);
+    onCollisionAlert(alert);
+}
+
+void AISCommunicationService::publishGeofenceEvent(const GeofenceEvent& event)
+{
+    thread_local std::string buffer;
+    GeofenceEngine::format(event, commCfg_.outputFormat == OutputFormat::BINARY, buffer);
+    sendEvent(buffer, event.mmsi);
+    onGeofenceEvent(event);
+}
+
+void AISCommunicationService::publishAnomaly(const Anomaly& anomaly)
+{
+    thread_local std::string buffer;
+    KinematicValidator::format(anomaly, commCfg_.outputFormat == OutputFormat::BINARY, buffer);
+    sendEvent(buffer, anomaly.mmsi);
+    onAnomaly(anomaly);
+}
+
+void AISCommunicationService::runMaintenance()
+{
+    const bool expire = commCfg_.msgSaveTime > 0;
+    const int snapshotIntervalMs = commCfg_.snapshotIntervalMs;
+    const int publishIntervalMs = publisher_ ? commCfg_.publishIntervalMs : 0;
+    const int cpaIntervalMs = collision_ ? std::max(commCfg_.cpaIntervalMs, 1) : 0;
+    const int geofenceReloadMs = geofence_ ? commCfg_.geofenceReloadSec * 1000 : 0;
+    steady_clock::time_point nextExpire = steady_clock::now() + milliseconds(EXPIRE_TICK_MS);
+    steady_clock::time_point nextSnapshot = steady_clock::now();
+    steady_clock::time_point nextPublish = steady_clock::now() + milliseconds(publishIntervalMs);
+    steady_clock::time_point nextCpa = steady_clock::now() + milliseconds(cpaIntervalMs);
+    steady_clock::time_point nextReload = steady_clock::now() + milliseconds(geofenceReloadMs);
+
+    std::unique_lock<std::mutex> lock(maintMutex_);
+    while (!maintStop_) {
+        steady_clock::time_point now = steady_clock::now();
+        lock.unlock();
+        if (expire && now >= nextExpire) {
+            size_t evicted = shipInfoCache_.Tick(EXPIRE_BATCH);
+            if (evicted > 0) {
+                LOG_DEBUG("Expired {} vessels, {} remaining", evicted, shipInfoCache_.GetSize());
+            }
+            nextExpire = now + milliseconds(EXPIRE_TICK_MS);
+        }
+        if (snapshotIntervalMs > 0 && now >= nextSnapshot) {
+            refreshSnapshot();
+            nextSnapshot = now + milliseconds(snapshotIntervalMs);
+        }
+        if (publishIntervalMs > 0 && now >= nextPublish) {
+            // 发布前重新生成快照，与上一帧发布的快照比较
+            refreshSnapshot();
+            [[maybe_unused]] size_t records = publisher_->publish(std::atomic_load(&snapshot_));
+            LOG_DEBUG("Published situation frame {}: Records={}", publisher_->getFrameCount() - 1, records);
+            nextPublish = now + milliseconds(publishIntervalMs);
+        }
+        if (cpaIntervalMs > 0 && now >= nextCpa) {
+            const int64_t nowMs = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+            [[maybe_unused]] size_t pairs = collision_->evaluate(nowMs);
+            LOG_DEBUG("Collision risk cycle: Pairs={}, ActiveAlerts={}", pairs, collision_->getActiveAlertCount());
+            nextCpa = now + milliseconds(cpaIntervalMs);
+        }
+        if (geofenceReloadMs > 0 && now >= nextReload) {
+            geofence_->reloadIfChanged();
+            nextReload = now + milliseconds(geofenceReloadMs);
+        }
+        lock.lock();
+
+        steady_clock::time_point wake = steady_clock::time_point::max();
+        if (expire) {
+            wake = std::min(wake, nextExpire);
+        }
+        if (snapshotIntervalMs > 0) {
+            wake = std::min(wake, nextSnapshot);
+        }
+        if (publishIntervalMs > 0) {
+            wake = std::min(wake, nextPublish);
+        }
+        if (cpaIntervalMs > 0) {
+            wake = std::min(wake, nextCpa);
+        }
+        if (geofenceReloadMs > 0) {
+            wake = std::min(wake, nextReload);
+        }
+        maintCv_.wait_until(lock, wake, [this] { return maintStop_; });
+    }
+}
+
+void AISCommunicationService::stopMaintenance()
+{
+    if (!maintThread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(maintMutex_);
+        maintStop_ = true;
+    }
+    maintCv_.notify_all();
+    maintThread_.join();
+}
+
+void AISCommunicationService::refreshSnapshot() const
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+
+    // 复用无读者持有的旧快照，避免每次刷新重新分配
+    std::shared_ptr<VesselSnapshot> next;
+    if (spareSnapshot_ && spareSnapshot_.use_count() == 1) {
+        next = std::move(spareSnapshot_);
+        next->vessels.clear();
+    } else {
+        next = std::make_shared<VesselSnapshot>();
+    }
+    spareSnapshot_.reset();
+
+    // 逐分片加锁复制，接收线程只在访问同一分片时短暂等待
+    next->vessels.reserve(shipInfoCache_.GetSize());
+    shipInfoCache_.ForEach([&next](const uint32_t&, const VesselState& state) {
+        next->vessels.push_back(state);
+        return true;
+    });
+    std::sort(next->vessels.begin(), next->vessels.end(),
+              [](const VesselState& a, const VesselState& b) { return a.mmsi < b.mmsi; });
+    next->version = ++snapshotVersion_;
+    next->timeMs = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+
+    std::shared_ptr<const VesselSnapshot> previous =
+        std::atomic_exchange(&snapshot_, std::shared_ptr<const VesselSnapshot>(next));
+    spareSnapshot_ = std::const_pointer_cast<VesselSnapshot>(previous);
+}
+
+std::shared_ptr<const VesselSnapshot> AISCommunicationService::getVesselSnapshot() const
+{
+    if (commCfg_.snapshotIntervalMs <= 0 || !maintThread_.joinable()) {
+        refreshSnapshot();
+    }
+    return std::atomic_load(&snapshot_);
+}
+
+bool AISCommunicationService::getVesselState(uint32_t mmsi, VesselState& state) const
+{
+    auto result = shipInfoCache_.Peek(mmsi);
+    if (result.first) {
+        state = result.second;
+    }
+    return result.first;
+}
+
+bool AISCommunicationService::predictPosition(uint32_t mmsi, int64_t atMs, PredictedPosition& out) const
+{
+    auto result = shipInfoCache_.Peek(mmsi);
+    if (!result.first) {
+        return false;
+    }
+    return DeadReckoning::predict(result.second, atMs, commCfg_.predictHorizonSec * 1000LL, out);
+}
+
+std::vector<PredictedPosition> AISCommunicationService::predictPositions(int64_t atMs) const
+{
+    std::shared_ptr<const VesselSnapshot> snapshot = getVesselSnapshot();
+    const std::vector<VesselState>& vessels = snapshot->vessels;
+
+    std::vector<PredictedPosition> positions(vessels.size());
+    size_t valid = DeadReckoning::predictBatch(vessels.data(), vessels.size(), atMs,
+                                               commCfg_.predictHorizonSec * 1000LL, positions.data());
+
+    // 去掉没有位置的船舶
+    if (valid < positions.size()) {
+        positions.erase(std::remove_if(positions.begin(), positions.end(),
+                                       [](const PredictedPosition& p) { return p.latitude > 90.0; }),
+                        positions.end());
+    }
+    return positions;
+}
+
+std::vector<SpatialHit> AISCommunicationService::getVesselsInBox(double south, double west,
+                                                                 double north, double east) const
+{
+    std::vector<SpatialHit> hits;
+    if (spatialIndex_) {
+        spatialIndex_->queryBox(south, west, north, east, hits);
+    }
+    return hits;
+}
+
+std::vector<SpatialHit> AISCommunicationService::getVesselsInRadius(double latitude, double longitude,
+                                                                    double radiusM) const
+{
+    std::vector<SpatialHit> hits;
+    if (spatialIndex_) {
+        spatialIndex_->queryRadius(latitude, longitude, radiusM, hits);
+    }
+    return hits;
+}
+
+std::vector<SpatialHit> AISCommunicationService::getNearestVessels(double latitude, double longitude, size_t k) const
+{
+    std::vector<SpatialHit> hits;
+    if (spatialIndex_) {
+        spatialIndex_->queryNearest(latitude, longitude, k, hits);
+    }
+    return hits;
+}
+
+std::vector<VesselState> AISCommunicationService::getVesselStates() const
+{
+    std::vector<VesselState> states;
+    states.reserve(shipInfoCache_.GetSize());
+    shipInfoCache_.ForEach([&states](const uint32_t&, const VesselState& state) {
+        states.push_back(state);
+        return true;
+    });
+    return states;
+}
+
 std::string AISCommunicationService::getLastMsgDealResult() const
 {
-    // 获取最新处理结果
-    if (shipInfoCache_.IsEmpty()) {
+    // 获取最近更新船舶的综合状态
+    auto latest = shipInfoCache_.GetLatest();
+    if (!latest) {
         return "";
     }
     
-    return shipInfoCache_.GetLatest().value().second;
+    return latest->second.toCsv();
 }
 
 } // namespace ais
\ No newline at end of file
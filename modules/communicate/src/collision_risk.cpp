@@ -0,0 +1,270 @@
+#include "collision_risk.h"
+
+#include "utils/event_record.h"
+#include "utils/geo_math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+namespace ais {
+
+namespace {
+
+using geo::DEG_TO_RAD;
+using geo::KNOT_MS;
+using geo::METERS_PER_DEGREE;
+using geo::validPosition;
+
+/**
+ * @brief 对地速度矢量（米/秒，东向、北向），航速或航向不可用时按静止处理
+ */
+void velocity(const CollisionRiskEngine::Track& track, double& ve, double& vn)
+{
+    ve = 0.0;
+    vn = 0.0;
+    if (track.speedOverGround < 102.2 && track.courseOverGround >= 0.0 && track.courseOverGround < 360.0) {
+        const double speed = track.speedOverGround * KNOT_MS;
+        ve = speed * std::sin(track.courseOverGround * DEG_TO_RAD);
+        vn = speed * std::cos(track.courseOverGround * DEG_TO_RAD);
+    }
+}
+
+} // namespace
+
+CollisionRiskEngine::CollisionRiskEngine(const LiveSpatialIndex* index, double rangeM, double cpaM, double tcpaSec,
+                                         int64_t maxHorizonMs, alert_func alert)
+    : index_(index)
+    , rangeM_(rangeM)
+    , cpaM_(cpaM)
+    , tcpaSec_(tcpaSec)
+    , maxHorizonMs_(maxHorizonMs)
+    , alert_(std::move(alert))
+{
+}
+
+uint64_t CollisionRiskEngine::pairKey(uint32_t a, uint32_t b)
+{
+    return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+}
+
+CollisionRiskEngine::Track CollisionRiskEngine::toTrack(const VesselState& state)
+{
+    Track track;
+    track.mmsi = state.mmsi;
+    track.latitude = state.latitude;
+    track.longitude = state.longitude;
+    track.speedOverGround = state.speedOverGround;
+    track.courseOverGround = state.courseOverGround;
+    track.timeMs = state.positionTimeMs;
+    return track;
+}
+
+void CollisionRiskEngine::update(const VesselState& state)
+{
+    update(toTrack(state));
+}
+
+void CollisionRiskEngine::update(const Track& track)
+{
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    pending_.push_back(track);
+}
+
+void CollisionRiskEngine::remove(uint32_t mmsi)
+{
+    Track track;
+    track.mmsi = mmsi;
+
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    pending_.push_back(track);
+}
+
+void CollisionRiskEngine::clear()
+{
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    pending_.clear();
+    pendingClear_ = true;
+}
+
+bool CollisionRiskEngine::computeCpa(const Track& a, const Track& b, int64_t atMs, int64_t maxHorizonMs,
+                                     CollisionAlert& out)
+{
+    if (!validPosition(a.latitude, a.longitude) || !validPosition(b.latitude, b.longitude)) {
+        return false;
+    }
+
+    out.mmsiA = std::min(a.mmsi, b.mmsi);
+    out.mmsiB = std::max(a.mmsi, b.mmsi);
+    out.timeMs = atMs;
+
+    // 以a的报告位置为原点的局部平面（东、北，米），两船各自外推到计算时刻
+    double dLon = b.longitude - a.longitude;
+    if (dLon > 180.0) {
+        dLon -= 360.0;
+    } else if (dLon < -180.0) {
+        dLon += 360.0;
+    }
+    const double cosLat = std::cos((a.latitude + b.latitude) * 0.5 * DEG_TO_RAD);
+
+    double dtA = (atMs - a.timeMs) / 1000.0;
+    double dtB = (atMs - b.timeMs) / 1000.0;
+    if (maxHorizonMs > 0) {
+        dtA = std::min(dtA, maxHorizonMs / 1000.0);
+        dtB = std::min(dtB, maxHorizonMs / 1000.0);
+    }
+
+    double veA, vnA, veB, vnB;
+    velocity(a, veA, vnA);
+    velocity(b, veB, vnB);
+
+    const double rx = dLon * METERS_PER_DEGREE * cosLat + veB * dtB - veA * dtA;
+    const double ry = (b.latitude - a.latitude) * METERS_PER_DEGREE + vnB * dtB - vnA * dtA;
+    const double vx = veB - veA;
+    const double vy = vnB - vnA;
+    const double v2 = vx * vx + vy * vy;
+
+    // 相对运动为匀速直线：TCPA = -(r·v)/|v|²，相对静止时CPA即当前距离
+    const double tcpa = v2 > 1e-9 ? -(rx * vx + ry * vy) / v2 : 0.0;
+    const double cx = rx + vx * tcpa;
+    const double cy = ry + vy * tcpa;
+
+    out.rangeM = std::sqrt(rx * rx + ry * ry);
+    out.cpaM = std::sqrt(cx * cx + cy * cy);
+    out.tcpaSec = tcpa;
+    out.relativeSpeedMs = std::sqrt(v2);
+    return true;
+}
+
+bool CollisionRiskEngine::risky(const CollisionAlert& alert, double factor) const
+{
+    return alert.relativeSpeedMs >= MIN_RELATIVE_SPEED_MS &&
+           alert.tcpaSec >= 0.0 && alert.tcpaSec <= tcpaSec_ * factor &&
+           alert.cpaM <= cpaM_ * factor;
+}
+
+void CollisionRiskEngine::evaluatePair(const Track& a, const Track& b, int64_t nowMs)
+{
+    CollisionAlert alert;
+    if (!computeCpa(a, b, nowMs, maxHorizonMs_, alert) || !risky(alert, 1.0)) {
+        return;
+    }
+    alert.active = true;
+    alerts_[pairKey(a.mmsi, b.mmsi)] = alert;
+    alert_(alert);
+}
+
+size_t CollisionRiskEngine::evaluate(int64_t nowMs)
+{
+    bool clearAll = false;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        updates_.swap(pending_);
+        clearAll = pendingClear_;
+        pendingClear_ = false;
+    }
+    cycle_++;
+
+    if (clearAll) {
+        for (auto& item : alerts_) {
+            item.second.active = false;
+            item.second.timeMs = nowMs;
+            alert_(item.second);
+        }
+        alerts_.clear();
+        tracks_.clear();
+    }
+
+    // 按到达顺序合并更新，记录本周期有更新的船舶
+    dirty_.clear();
+    for (const Track& track : updates_) {
+        if (!validPosition(track.latitude, track.longitude)) {
+            tracks_.erase(track.mmsi);
+            continue;
+        }
+        Entry& entry = tracks_[track.mmsi];
+        entry.track = track;
+        if (entry.dirtyCycle != cycle_) {
+            entry.dirtyCycle = cycle_;
+            dirty_.push_back(track.mmsi);
+        }
+    }
+    updates_.clear();
+
+    size_t pairs = 0;
+
+    // 已告警的船对每周期重新计算，风险解除或船舶消失时发出解除事件
+    for (auto it = alerts_.begin(); it != alerts_.end();) {
+        auto a = tracks_.find(it->second.mmsiA);
+        auto b = tracks_.find(it->second.mmsiB);
+        CollisionAlert current = it->second;
+        bool keep = false;
+        if (a != tracks_.end() && b != tracks_.end()) {
+            keep = computeCpa(a->second.track, b->second.track, nowMs, maxHorizonMs_, current) &&
+                   risky(current, CLEAR_FACTOR);
+            pairs++;
+        }
+        current.timeMs = nowMs;
+        current.active = keep;
+        if (keep) {
+            it->second = current;
+            ++it;
+        } else {
+            alert_(current);
+            it = alerts_.erase(it);
+        }
+    }
+
+    // 有更新的船舶与其邻船组成新船对；两船都有更新时只由MMSI较小的一方计算
+    for (uint32_t mmsi : dirty_) {
+        auto self = tracks_.find(mmsi);
+        if (self == tracks_.end()) {
+            continue;
+        }
+        const Track& track = self->second.track;
+        hits_.clear();
+        index_->queryRadius(track.latitude, track.longitude, rangeM_, hits_);
+        for (const SpatialHit& hit : hits_) {
+            if (hit.mmsi == mmsi) {
+                continue;
+            }
+            auto other = tracks_.find(hit.mmsi);
+            if (other == tracks_.end() || (other->second.dirtyCycle == cycle_ && hit.mmsi < mmsi)) {
+                continue;
+            }
+            if (alerts_.count(pairKey(mmsi, hit.mmsi)) != 0) {
+                continue;
+            }
+            evaluatePair(track, other->second.track, nowMs);
+            pairs++;
+        }
+    }
+
+    evaluatedPairs_ += pairs;
+    return pairs;
+}
+
+void CollisionRiskEngine::format(const CollisionAlert& alert, bool binary, std::string& out)
+{
+    out.clear();
+    if (binary) {
+        EventRecord::begin(out, 'A', alert.active ? 1 : 0, alert.mmsiA);
+        EventRecord::putLE<uint32_t>(out, alert.mmsiB);
+        EventRecord::putLE<uint32_t>(out, static_cast<uint32_t>(std::lround(alert.cpaM)));
+        EventRecord::putLE<int32_t>(out, static_cast<int32_t>(std::lround(alert.tcpaSec)));
+        EventRecord::putLE<uint32_t>(out, static_cast<uint32_t>(std::lround(alert.rangeM)));
+        EventRecord::putLE<int64_t>(out, alert.timeMs);
+        return;
+    }
+
+    char text[128];
+    int len = std::snprintf(text, sizeof(text), "A,%u,%u,%s,%.0f,%.0f,%.0f,%lld", alert.mmsiA, alert.mmsiB,
+                            alert.active ? "RAISE" : "CLEAR", alert.cpaM, alert.tcpaSec, alert.rangeM,
+                            static_cast<long long>(alert.timeMs));
+    if (len > 0) {
+        out.assign(text, std::min(static_cast<size_t>(len), sizeof(text) - 1));
+    }
+}
+
+} // namespace ais
@@ -0,0 +1,81 @@
+#include "deadband_filter.h"
+
+#include "utils/geo_math.h"
+#include "utils/message_fields.h"
+
+#include <cmath>
+
+namespace ais {
+
+namespace {
+
+/**
+ * @brief 航向差（考虑0/360度回绕），360表示不可用
+ */
+double courseDelta(double a, double b)
+{
+    if (a >= 360.0 || b >= 360.0) {
+        return (a >= 360.0 && b >= 360.0) ? 0.0 : 360.0;
+    }
+    const double d = std::fabs(a - b);
+    return d > 180.0 ? 360.0 - d : d;
+}
+
+} // namespace
+
+DeadbandFilter::DeadbandFilter(double distanceM, double speedKn, double courseDeg, int maxSilenceSec)
+    : distanceM_(distanceM)
+    , speedKn_(speedKn)
+    , courseDeg_(courseDeg)
+    , maxSilenceMs_(maxSilenceSec > 0 ? maxSilenceSec * 1000LL : 0)
+    , last_(CAPACITY, CAPACITY / 10, maxSilenceSec > 0 ? static_cast<time_t>(maxSilenceSec) : 0)
+{
+}
+
+bool DeadbandFilter::accept(const AISMessage& msg, int64_t timeMs)
+{
+    if (!isVesselPositionType(msg.type)) {
+        return true;
+    }
+
+    PositionFields pos;
+    if (!extractPosition(msg, pos)) {
+        return true;
+    }
+
+    bool forward = false;
+    last_.Upsert(msg.mmsi, [&](Forwarded& prev) {
+        if (prev.timeMs == 0 || (maxSilenceMs_ > 0 && timeMs - prev.timeMs >= maxSilenceMs_)) {
+            forward = true;
+        } else if (pos.navigationStatus != prev.navigationStatus) {
+            forward = true;
+        } else if (std::fabs(pos.speedOverGround - prev.speedOverGround) > speedKn_ ||
+                   courseDelta(pos.courseOverGround, prev.courseOverGround) > courseDeg_) {
+            forward = true;
+        } else {
+            const bool known = geo::validPosition(pos.latitude, pos.longitude);
+            if (known != geo::validPosition(prev.latitude, prev.longitude)) {
+                forward = true;
+            } else if (known) {
+                // 死区量级内等距柱状投影近似的误差可忽略
+                forward = geo::localDistanceMeters(prev.latitude, prev.longitude, pos.latitude, pos.longitude) > distanceM_;
+            }
+        }
+
+        if (forward) {
+            prev.latitude = pos.latitude;
+            prev.longitude = pos.longitude;
+            prev.speedOverGround = pos.speedOverGround;
+            prev.courseOverGround = pos.courseOverGround;
+            prev.navigationStatus = pos.navigationStatus;
+            prev.timeMs = timeMs;
+        }
+    });
+
+    if (!forward) {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return forward;
+}
+
+} // namespace ais
@@ -0,0 +1,244 @@
+#include "kinematic_validator.h"
+
+#include "utils/binary_codec.h"
+#include "utils/event_record.h"
+#include "utils/geo_math.h"
+#include "utils/message_fields.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace ais {
+
+namespace {
+
+using geo::KNOT_MS;
+
+constexpr int64_t TIME_TOLERANCE_MS = 1000;     // 报告时刻为秒级精度
+
+/**
+ * @brief 两个时刻间按上限航速允许的最大移动距离（米），时间差按秒级精度放宽1秒
+ */
+double allowedDistance(double maxSpeedMs, int64_t dtMs)
+{
+    const double dtSec = static_cast<double>(std::max<int64_t>(dtMs, 0) + TIME_TOLERANCE_MS) / 1000.0;
+    return maxSpeedMs * dtSec + KinematicValidator::POSITION_TOLERANCE_M;
+}
+
+double impliedSpeedKn(double distanceM, int64_t dtMs)
+{
+    const double dtSec = static_cast<double>(std::max<int64_t>(dtMs, TIME_TOLERANCE_MS)) / 1000.0;
+    return distanceM / dtSec / KNOT_MS;
+}
+
+} // namespace
+
+KinematicValidator::KinematicValidator(double maxSpeedKn, double courseDeg, bool quarantine, size_t shardCount)
+    : maxSpeedMs_(maxSpeedKn * KNOT_MS)
+    , courseDeg_(courseDeg)
+    , quarantine_(quarantine)
+    , tracks_(std::max<size_t>(shardCount, 1), 0, 0, STATE_TTL_SEC)
+{
+}
+
+AnomalyType KinematicValidator::check(const AISMessage& msg, int64_t receiveMs, Anomaly& out)
+{
+    PositionFields pos;
+    if (!isVesselPositionType(msg.type) || !extractPosition(msg, pos)) {
+        return AnomalyType::NONE;
+    }
+
+    const int64_t timeMs = reportTimeMs(receiveMs, pos.utcSecond);
+    const double maxSpeedKn = maxSpeedMs_ / KNOT_MS;
+
+    AnomalyType type = AnomalyType::NONE;
+    double implied = 0.0;
+
+    if (pos.hasKinematics && pos.speedOverGround > maxSpeedKn && pos.speedOverGround < 102.2) {
+        // 报告的航速本身不可信，不参与航迹比较
+        type = AnomalyType::REPORTED_SPEED;
+        implied = pos.speedOverGround;
+    } else {
+        tracks_.Upsert(msg.mmsi, [&](Track& track) {
+            if (track.timeMs == 0) {
+                track.latitude = pos.latitude;
+                track.longitude = pos.longitude;
+                track.timeMs = timeMs;
+                return;
+            }
+
+            if (timeMs + TIME_TOLERANCE_MS <= track.timeMs) {
+                type = AnomalyType::TIME_REGRESSION;
+                return;
+            }
+
+            if (track.altTimeMs != 0 && timeMs - track.altTimeMs > ALT_TTL_MS) {
+                track.altTimeMs = 0;
+                track.altHits = 0;
+                track.primaryHits = 0;
+            }
+
+            const int64_t dtMs = timeMs - track.timeMs;
+            const double distance = geo::distanceMeters(track.latitude, track.longitude, pos.latitude, pos.longitude);
+            if (distance <= allowedDistance(maxSpeedMs_, dtMs)) {
+                if (courseDeg_ > 0.0 && pos.hasKinematics && distance >= COURSE_MIN_DISTANCE_M &&
+                    pos.speedOverGround >= COURSE_MIN_SPEED_KN && pos.courseOverGround >= 0.0 &&
+                    pos.courseOverGround < 360.0) {
+                    double diff = std::fabs(geo::bearingDeg(track.latitude, track.longitude, pos.latitude, pos.longitude) -
+                                            pos.courseOverGround);
+                    diff = std::min(diff, 360.0 - diff);
+                    if (diff > courseDeg_) {
+                        type = AnomalyType::COURSE_MISMATCH;
+                        implied = impliedSpeedKn(distance, dtMs);
+                    }
+                }
+                track.latitude = pos.latitude;
+                track.longitude = pos.longitude;
+                track.timeMs = timeMs;
+                if (track.altTimeMs != 0 && track.primaryHits < UINT16_MAX) {
+                    track.primaryHits++;
+                }
+                return;
+            }
+
+            // 位置跳变：与候选航迹连贯时累计，否则以本条报告作为新的候选航迹
+            implied = impliedSpeedKn(distance, dtMs);
+            const int64_t altDtMs = timeMs - track.altTimeMs;
+            if (track.altTimeMs != 0 && altDtMs + TIME_TOLERANCE_MS > 0 &&
+                geo::distanceMeters(track.altLatitude, track.altLongitude, pos.latitude, pos.longitude) <=
+                    allowedDistance(maxSpeedMs_, altDtMs)) {
+                track.altLatitude = pos.latitude;
+                track.altLongitude = pos.longitude;
+                track.altTimeMs = std::max(track.altTimeMs, timeMs);
+                if (track.altHits < UINT16_MAX) {
+                    track.altHits++;
+                }
+
+                if (track.primaryHits >= CONFLICT_HITS && track.altHits >= CONFLICT_HITS) {
+                    type = AnomalyType::MMSI_CONFLICT;
+                } else if (track.primaryHits == 0 && track.altHits >= REANCHOR_HITS) {
+                    track.latitude = pos.latitude;
+                    track.longitude = pos.longitude;
+                    track.timeMs = timeMs;
+                    track.altTimeMs = 0;
+                    track.altHits = 0;
+                } else {
+                    type = AnomalyType::POSITION_JUMP;
+                }
+                return;
+            }
+
+            track.altLatitude = pos.latitude;
+            track.altLongitude = pos.longitude;
+            track.altTimeMs = timeMs;
+            track.altHits = 1;
+            track.primaryHits = 0;
+            type = AnomalyType::POSITION_JUMP;
+        });
+    }
+
+    if (type == AnomalyType::NONE) {
+        return type;
+    }
+
+    out.mmsi = msg.mmsi;
+    out.type = type;
+    out.latitude = pos.latitude;
+    out.longitude = pos.longitude;
+    out.impliedSpeedKn = implied;
+    out.timeMs = timeMs;
+    // 航向不符时位置本身可信，只标记不隔离
+    out.quarantined = quarantine_ && type != AnomalyType::COURSE_MISMATCH;
+    record(out);
+    return type;
+}
+
+void KinematicValidator::record(const Anomaly& anomaly)
+{
+    counts_[static_cast<size_t>(anomaly.type)].fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(recentMutex_);
+    if (recent_.size() >= RECENT_CAPACITY) {
+        recent_.pop_front();
+    }
+    recent_.push_back(anomaly);
+}
+
+void KinematicValidator::clear()
+{
+    tracks_.Clear();
+    std::lock_guard<std::mutex> lock(recentMutex_);
+    recent_.clear();
+}
+
+std::array<uint64_t, static_cast<size_t>(AnomalyType::TYPE_COUNT)> KinematicValidator::getCounts() const
+{
+    std::array<uint64_t, static_cast<size_t>(AnomalyType::TYPE_COUNT)> counts{};
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] = counts_[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+std::vector<Anomaly> KinematicValidator::getRecent() const
+{
+    std::lock_guard<std::mutex> lock(recentMutex_);
+    return std::vector<Anomaly>(recent_.begin(), recent_.end());
+}
+
+int64_t KinematicValidator::reportTimeMs(int64_t receiveMs, int utcSecond)
+{
+    if (utcSecond < 0 || utcSecond > 59) {
+        return receiveMs;
+    }
+    int64_t timeMs = receiveMs - receiveMs % 60000 + utcSecond * 1000LL;
+    if (timeMs > receiveMs + TIME_TOLERANCE_MS) {
+        timeMs -= 60000;
+    }
+    return timeMs;
+}
+
+const char* KinematicValidator::typeName(AnomalyType type)
+{
+    switch (type)
+    {
+    case AnomalyType::REPORTED_SPEED:
+        return "REPORTED_SPEED";
+    case AnomalyType::TIME_REGRESSION:
+        return "TIME_REGRESSION";
+    case AnomalyType::POSITION_JUMP:
+        return "POSITION_JUMP";
+    case AnomalyType::COURSE_MISMATCH:
+        return "COURSE_MISMATCH";
+    case AnomalyType::MMSI_CONFLICT:
+        return "MMSI_CONFLICT";
+    default:
+        return "NONE";
+    }
+}
+
+void KinematicValidator::format(const Anomaly& anomaly, bool binary, std::string& out)
+{
+    out.clear();
+    if (binary) {
+        EventRecord::begin(out, 'X', static_cast<uint8_t>(anomaly.type), anomaly.mmsi);
+        EventRecord::putLE<int32_t>(out, BinaryCodec::encodeCoord(anomaly.latitude));
+        EventRecord::putLE<int32_t>(out, BinaryCodec::encodeCoord(anomaly.longitude));
+        EventRecord::putLE<uint16_t>(
+            out, static_cast<uint16_t>(std::min(std::lround(anomaly.impliedSpeedKn * 10.0), 65535L)));
+        out.push_back(static_cast<char>(anomaly.quarantined ? 1 : 0));
+        EventRecord::putLE<int64_t>(out, anomaly.timeMs);
+        return;
+    }
+
+    char text[128];
+    int len = std::snprintf(text, sizeof(text), "X,%u,%s,%.6f,%.6f,%.1f,%lld,%s", anomaly.mmsi,
+                            typeName(anomaly.type), anomaly.latitude, anomaly.longitude, anomaly.impliedSpeedKn,
+                            static_cast<long long>(anomaly.timeMs), anomaly.quarantined ? "QUARANTINED" : "FLAGGED");
+    if (len > 0) {
+        out.assign(text, std::min(static_cast<size_t>(len), sizeof(text) - 1));
+    }
+}
+
+} // namespace ais
@@ -0,0 +1,268 @@
+#include "live_spatial_index.h"
+
+#include "utils/geo_math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace ais {
+
+namespace {
+
+using geo::DEG_TO_RAD;
+using geo::EARTH_RADIUS_M;
+using geo::METERS_PER_DEGREE;
+using geo::PI;
+using geo::validPosition;
+
+/**
+ * @brief 经度是否在[west, east]内，west > east 表示跨越180度经线
+ */
+bool inLongitude(double longitude, double west, double east)
+{
+    return west <= east ? (longitude >= west && longitude <= east)
+                        : (longitude >= west || longitude <= east);
+}
+
+double normalizeLongitude(double longitude)
+{
+    return std::fmod(std::fmod(longitude + 180.0, 360.0) + 360.0, 360.0) - 180.0;
+}
+
+} // namespace
+
+LiveSpatialIndex::LiveSpatialIndex(double cellDeg, size_t shardCount)
+    : cellDeg_(std::min(std::max(cellDeg, 1e-3), 90.0))
+{
+    columns_ = static_cast<int32_t>(std::ceil(360.0 / cellDeg_));
+    rows_ = static_cast<int32_t>(std::ceil(180.0 / cellDeg_));
+
+    // 分片数向上取2的幂，按MMSI的Fibonacci散列选择分片
+    while ((static_cast<size_t>(1) << shardBits_) < std::max<size_t>(shardCount, 1)) {
+        shardBits_++;
+    }
+    for (size_t i = 0; i < (static_cast<size_t>(1) << shardBits_); ++i) {
+        shards_.emplace_back(new Shard());
+    }
+}
+
+LiveSpatialIndex::Shard& LiveSpatialIndex::shardOf(uint32_t mmsi) const
+{
+    if (shardBits_ == 0) {
+        return *shards_[0];
+    }
+    const uint64_t h = static_cast<uint64_t>(mmsi) * 0x9E3779B97F4A7C15ULL;
+    return *shards_[static_cast<size_t>(h >> (64 - shardBits_))];
+}
+
+int32_t LiveSpatialIndex::column(double longitude) const
+{
+    const int32_t x = static_cast<int32_t>(std::floor((longitude + 180.0) / cellDeg_));
+    return std::min(std::max(x, 0), columns_ - 1);
+}
+
+int32_t LiveSpatialIndex::row(double latitude) const
+{
+    const int32_t y = static_cast<int32_t>(std::floor((latitude + 90.0) / cellDeg_));
+    return std::min(std::max(y, 0), rows_ - 1);
+}
+
+uint32_t LiveSpatialIndex::cellKey(int32_t x, int32_t y) const
+{
+    return static_cast<uint32_t>(y) * static_cast<uint32_t>(columns_) + static_cast<uint32_t>(x);
+}
+
+void LiveSpatialIndex::update(uint32_t mmsi, double latitude, double longitude)
+{
+    Shard& shard = shardOf(mmsi);
+    if (!validPosition(latitude, longitude)) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        removeLocked(shard, mmsi);
+        return;
+    }
+
+    const uint32_t cell = cellKey(column(longitude), row(latitude));
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    auto it = shard.vessels.find(mmsi);
+    if (it != shard.vessels.end()) {
+        // 同一单元格内原地更新
+        if (it->second.cell == cell) {
+            Item& item = shard.cells[cell][it->second.index];
+            item.latitude = latitude;
+            item.longitude = longitude;
+            return;
+        }
+        removeLocked(shard, mmsi);
+    }
+
+    std::vector<Item>& items = shard.cells[cell];
+    shard.vessels[mmsi] = Slot{cell, static_cast<uint32_t>(items.size())};
+    items.push_back(Item{mmsi, latitude, longitude});
+}
+
+void LiveSpatialIndex::removeLocked(Shard& shard, uint32_t mmsi)
+{
+    auto it = shard.vessels.find(mmsi);
+    if (it == shard.vessels.end()) {
+        return;
+    }
+
+    // 与单元格末尾元素交换后删除，并修正被移动船舶的下标
+    const Slot slot = it->second;
+    shard.vessels.erase(it);
+    auto cellIt = shard.cells.find(slot.cell);
+    std::vector<Item>& items = cellIt->second;
+    if (slot.index + 1 != items.size()) {
+        items[slot.index] = items.back();
+        shard.vessels[items[slot.index].mmsi].index = slot.index;
+    }
+    items.pop_back();
+    if (items.empty()) {
+        shard.cells.erase(cellIt);
+    }
+}
+
+void LiveSpatialIndex::remove(uint32_t mmsi)
+{
+    Shard& shard = shardOf(mmsi);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    removeLocked(shard, mmsi);
+}
+
+void LiveSpatialIndex::clear()
+{
+    for (auto& shard : shards_) {
+        std::unique_lock<std::shared_mutex> lock(shard->mutex);
+        shard->cells.clear();
+        shard->vessels.clear();
+    }
+}
+
+size_t LiveSpatialIndex::size() const
+{
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        total += shard->vessels.size();
+    }
+    return total;
+}
+
+template <class Func>
+void LiveSpatialIndex::visitCells(int32_t y0, int32_t y1, int32_t x0, int32_t x1, bool wrap, Func func) const
+{
+    // 跨越180度经线但两端落在同一列时覆盖全部经度
+    if (wrap && x0 <= x1) {
+        x0 = 0;
+        x1 = columns_ - 1;
+    }
+    wrap = x0 > x1;
+    const int64_t width = wrap ? (columns_ - x0) + (x1 + 1) : (x1 - x0 + 1);
+    const int64_t area = width * (y1 - y0 + 1);
+
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+
+        // 查询范围的单元格数多于已占用单元格数时，改为遍历已占用单元格
+        if (area > static_cast<int64_t>(shard->cells.size())) {
+            for (const auto& cell : shard->cells) {
+                const int32_t x = static_cast<int32_t>(cell.first % static_cast<uint32_t>(columns_));
+                const int32_t y = static_cast<int32_t>(cell.first / static_cast<uint32_t>(columns_));
+                const bool inX = wrap ? (x >= x0 || x <= x1) : (x >= x0 && x <= x1);
+                if (inX && y >= y0 && y <= y1) {
+                    func(cell.second);
+                }
+            }
+            continue;
+        }
+
+        for (int32_t y = y0; y <= y1; ++y) {
+            for (int64_t i = 0; i < width; ++i) {
+                const int32_t x = static_cast<int32_t>((x0 + i) % columns_);
+                auto it = shard->cells.find(cellKey(x, y));
+                if (it != shard->cells.end()) {
+                    func(it->second);
+                }
+            }
+        }
+    }
+}
+
+size_t LiveSpatialIndex::queryBox(double south, double west, double north, double east,
+                                  std::vector<SpatialHit>& out) const
+{
+    const size_t before = out.size();
+    visitCells(row(south), row(north), column(west), column(east), west > east, [&](const std::vector<Item>& items) {
+        for (const Item& item : items) {
+            if (item.latitude >= south && item.latitude <= north && inLongitude(item.longitude, west, east)) {
+                out.push_back(SpatialHit{item.mmsi, item.latitude, item.longitude, 0.0});
+            }
+        }
+    });
+    return out.size() - before;
+}
+
+size_t LiveSpatialIndex::queryRadius(double latitude, double longitude, double radiusM,
+                                     std::vector<SpatialHit>& out) const
+{
+    const size_t before = out.size();
+    if (!validPosition(latitude, longitude) || radiusM < 0.0) {
+        return 0;
+    }
+
+    // 圆的外接经纬度范围，覆盖极点时经度取全范围
+    const double dLat = radiusM / METERS_PER_DEGREE;
+    const double south = std::max(latitude - dLat, -90.0);
+    const double north = std::min(latitude + dLat, 90.0);
+    double west = -180.0;
+    double east = 180.0;
+    const double angular = radiusM / EARTH_RADIUS_M;
+    const double cosLat = std::cos(latitude * DEG_TO_RAD);
+    if (north < 90.0 && south > -90.0 && angular < PI / 2 && std::sin(angular) < cosLat) {
+        const double dLon = std::asin(std::sin(angular) / cosLat) / DEG_TO_RAD;
+        west = normalizeLongitude(longitude - dLon);
+        east = normalizeLongitude(longitude + dLon);
+    }
+
+    visitCells(row(south), row(north), column(west), column(east), west > east, [&](const std::vector<Item>& items) {
+        for (const Item& item : items) {
+            const double d = geo::distanceMeters(latitude, longitude, item.latitude, item.longitude);
+            if (d <= radiusM) {
+                out.push_back(SpatialHit{item.mmsi, item.latitude, item.longitude, d});
+            }
+        }
+    });
+    return out.size() - before;
+}
+
+size_t LiveSpatialIndex::queryNearest(double latitude, double longitude, size_t k,
+                                      std::vector<SpatialHit>& out) const
+{
+    const size_t before = out.size();
+    if (k == 0 || !validPosition(latitude, longitude)) {
+        return 0;
+    }
+
+    // 半径倍增：半径内已有不少于k个结果时，最近的k个必然都在其中
+    const size_t total = size();
+    const double maxRadius = PI * EARTH_RADIUS_M;
+    size_t found = 0;
+    for (double radius = cellDeg_ * METERS_PER_DEGREE; ; radius *= 2.0) {
+        out.resize(before);
+        found = queryRadius(latitude, longitude, std::min(radius, maxRadius), out);
+        if (found >= k || found >= total || radius >= maxRadius) {
+            break;
+        }
+    }
+
+    const size_t n = std::min(k, found);
+    const auto first = out.begin() + static_cast<std::ptrdiff_t>(before);
+    std::partial_sort(first, first + static_cast<std::ptrdiff_t>(n), out.end(),
+                      [](const SpatialHit& a, const SpatialHit& b) { return a.distanceM < b.distanceM; });
+    out.resize(before + n);
+    return n;
+}
+
+} // namespace ais
@@ -0,0 +1,60 @@
+#include "outbound_batcher.h"
+
+namespace ais {
+
+OutboundBatcher::OutboundBatcher(size_t maxBytes, int64_t maxDelayUs, bool text, send_func send)
+    : maxBytes_(maxBytes)
+    , maxDelayUs_(maxDelayUs)
+    , text_(text)
+    , send_(std::move(send))
+{
+    buffer_.reserve(maxBytes_ + 1);
+}
+
+void OutboundBatcher::add(const char* data, size_t size, int64_t enqueueUs)
+{
+    if (text_ && size > 0 && data[size - 1] == '\0') {
+        size--;
+    }
+
+    // 文本模式每条记录额外占用一个分隔符或结尾'\0'
+    const size_t extra = text_ ? 1 : 0;
+    if (!empty() && buffer_.size() + extra + size + extra > maxBytes_) {
+        flush();
+    }
+
+    if (text_ && !empty()) {
+        buffer_.push_back('\n');
+    }
+    buffer_.append(data, size);
+    enqueueUs_.push_back(enqueueUs);
+
+    if (buffer_.size() + extra >= maxBytes_) {
+        flush();
+    }
+}
+
+void OutboundBatcher::poll(int64_t nowUs)
+{
+    if (!empty() && nowUs - enqueueUs_.front() >= maxDelayUs_) {
+        flush();
+    }
+}
+
+void OutboundBatcher::flush()
+{
+    if (empty()) {
+        return;
+    }
+
+    if (text_) {
+        buffer_.push_back('\0');
+    }
+    send_(buffer_.data(), buffer_.size(), enqueueUs_);
+    datagrams_++;
+
+    buffer_.clear();
+    enqueueUs_.clear();
+}
+
+} // namespace ais
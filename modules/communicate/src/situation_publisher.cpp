@@ -0,0 +1,239 @@
+#include "situation_publisher.h"
+
+#include "utils/binary_codec.h"
+#include "utils/csv_writer.h"
+#include "utils/event_record.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace ais {
+
+namespace {
+
+void putText(std::string& out, const char* text)
+{
+    const size_t len = std::strlen(text);
+    out.push_back(static_cast<char>(len));
+    out.append(text, len);
+}
+
+uint16_t tenths(double value)
+{
+    return static_cast<uint16_t>(std::lround(value * 10.0));
+}
+
+void appendf(std::string& out, const char* format, ...)
+{
+    char text[64];
+    va_list args;
+    va_start(args, format);
+    int len = std::vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (len > 0) {
+        out.append(text, std::min(static_cast<size_t>(len), sizeof(text) - 1));
+    }
+}
+
+int64_t staticTimeMs(const VesselState& state)
+{
+    return std::max(state.identityTimeMs, state.shipDataTimeMs);
+}
+
+} // namespace
+
+SituationPublisher::SituationPublisher(int keyframeInterval, bool binary, emit_func emit)
+    : keyframeInterval_(keyframeInterval)
+    , binary_(binary)
+    , emit_(std::move(emit))
+{
+}
+
+uint32_t SituationPublisher::diff(const VesselState& prev, const VesselState& cur)
+{
+    // 未合并新消息的船舶不会有字段变化
+    if (prev.messageCount == cur.messageCount && prev.lastUpdateMs == cur.lastUpdateMs) {
+        return 0;
+    }
+
+    uint32_t mask = 0;
+    if (prev.latitude != cur.latitude || prev.longitude != cur.longitude) mask |= POSITION;
+    if (prev.speedOverGround != cur.speedOverGround) mask |= SPEED;
+    if (prev.courseOverGround != cur.courseOverGround) mask |= COURSE;
+    if (prev.trueHeading != cur.trueHeading) mask |= HEADING;
+    if (prev.navigationStatus != cur.navigationStatus) mask |= NAV_STATUS;
+    if (std::strcmp(prev.vesselName, cur.vesselName) != 0) mask |= NAME;
+    if (std::strcmp(prev.callSign, cur.callSign) != 0) mask |= CALLSIGN;
+    if (prev.imoNumber != cur.imoNumber) mask |= IMO;
+    if (prev.shipType != cur.shipType) mask |= SHIP_TYPE;
+    if (prev.dimensionToBow != cur.dimensionToBow || prev.dimensionToStern != cur.dimensionToStern ||
+        prev.dimensionToPort != cur.dimensionToPort || prev.dimensionToStarboard != cur.dimensionToStarboard) {
+        mask |= DIMENSIONS;
+    }
+    if (prev.draught != cur.draught) mask |= DRAUGHT;
+    if (std::strcmp(prev.destination, cur.destination) != 0) mask |= DESTINATION;
+    if (prev.positionTimeMs != cur.positionTimeMs) mask |= POSITION_TIME;
+    if (staticTimeMs(prev) != staticTimeMs(cur)) mask |= STATIC_TIME;
+    return mask;
+}
+
+size_t SituationPublisher::publish(const std::shared_ptr<const VesselSnapshot>& snapshot)
+{
+    if (!snapshot) {
+        return 0;
+    }
+
+    const bool keyframe = !previous_ || keyframeInterval_ <= 0 ||
+                          frames_ % static_cast<uint64_t>(keyframeInterval_) == 0;
+    const std::vector<VesselState>& cur = snapshot->vessels;
+
+    // 两帧均按MMSI升序，归并找出变化、新增和消失的船舶
+    changed_.clear();
+    removed_.clear();
+    if (keyframe) {
+        for (const VesselState& state : cur) {
+            changed_.emplace_back(&state, ALL_FIELDS);
+        }
+    } else {
+        const std::vector<VesselState>& prev = previous_->vessels;
+        size_t i = 0;
+        size_t j = 0;
+        while (i < prev.size() || j < cur.size()) {
+            if (j == cur.size() || (i < prev.size() && prev[i].mmsi < cur[j].mmsi)) {
+                removed_.push_back(prev[i++].mmsi);
+            } else if (i == prev.size() || cur[j].mmsi < prev[i].mmsi) {
+                changed_.emplace_back(&cur[j++], ALL_FIELDS);
+            } else {
+                uint32_t mask = diff(prev[i++], cur[j]);
+                if (mask != 0) {
+                    changed_.emplace_back(&cur[j], mask);
+                }
+                j++;
+            }
+        }
+    }
+
+    emitFrameHeader(keyframe, changed_.size() + removed_.size(), snapshot->timeMs);
+    for (const auto& item : changed_) {
+        emitVessel(keyframe ? 'K' : 'D', *item.first, item.second);
+    }
+    for (uint32_t mmsi : removed_) {
+        emitRemoved(mmsi);
+    }
+
+    frames_++;
+    previous_ = snapshot;
+    return changed_.size() + removed_.size();
+}
+
+void SituationPublisher::beginBinary(char kind, uint32_t mmsi)
+{
+    EventRecord::begin(buffer_, kind, 0, mmsi);
+}
+
+void SituationPublisher::emitBuffer(uint32_t mmsi)
+{
+    // CSV记录与逐条转发保持一致，带结尾'\0'发送
+    if (binary_) {
+        emit_(buffer_.data(), buffer_.size(), mmsi);
+    } else {
+        emit_(buffer_.c_str(), buffer_.size() + 1, mmsi);
+    }
+}
+
+void SituationPublisher::emitFrameHeader(bool keyframe, size_t records, int64_t timeMs)
+{
+    if (binary_) {
+        beginBinary('F', 0);
+        EventRecord::putLE<uint32_t>(buffer_, static_cast<uint32_t>(frames_));
+        EventRecord::putLE<uint32_t>(buffer_, static_cast<uint32_t>(records));
+        EventRecord::putLE<int64_t>(buffer_, timeMs);
+    } else {
+        buffer_.clear();
+        appendf(buffer_, "F,%llu,%lld,%c,%zu", static_cast<unsigned long long>(frames_),
+                static_cast<long long>(timeMs), keyframe ? 'K' : 'D', records);
+    }
+    emitBuffer(0);
+}
+
+void SituationPublisher::emitRemoved(uint32_t mmsi)
+{
+    if (binary_) {
+        beginBinary('R', mmsi);
+    } else {
+        buffer_.clear();
+        appendf(buffer_, "R,%u", mmsi);
+    }
+    emitBuffer(mmsi);
+}
+
+void SituationPublisher::emitVessel(char kind, const VesselState& s, uint32_t mask)
+{
+    if (binary_) {
+        beginBinary(kind, s.mmsi);
+        EventRecord::putLE<uint32_t>(buffer_, mask);
+        if (mask & POSITION) {
+            EventRecord::putLE<int32_t>(buffer_, BinaryCodec::encodeCoord(s.latitude));
+            EventRecord::putLE<int32_t>(buffer_, BinaryCodec::encodeCoord(s.longitude));
+        }
+        if (mask & SPEED) EventRecord::putLE<uint16_t>(buffer_, tenths(s.speedOverGround));
+        if (mask & COURSE) EventRecord::putLE<uint16_t>(buffer_, tenths(s.courseOverGround));
+        if (mask & HEADING) EventRecord::putLE<int16_t>(buffer_, s.trueHeading);
+        if (mask & NAV_STATUS) EventRecord::putLE<uint8_t>(buffer_, s.navigationStatus);
+        if (mask & NAME) putText(buffer_, s.vesselName);
+        if (mask & CALLSIGN) putText(buffer_, s.callSign);
+        if (mask & IMO) EventRecord::putLE<uint32_t>(buffer_, s.imoNumber);
+        if (mask & SHIP_TYPE) EventRecord::putLE<uint8_t>(buffer_, s.shipType);
+        if (mask & DIMENSIONS) {
+            EventRecord::putLE<uint16_t>(buffer_, s.dimensionToBow);
+            EventRecord::putLE<uint16_t>(buffer_, s.dimensionToStern);
+            EventRecord::putLE<uint8_t>(buffer_, s.dimensionToPort);
+            EventRecord::putLE<uint8_t>(buffer_, s.dimensionToStarboard);
+        }
+        if (mask & DRAUGHT) EventRecord::putLE<uint16_t>(buffer_, tenths(s.draught));
+        if (mask & DESTINATION) putText(buffer_, s.destination);
+        if (mask & POSITION_TIME) EventRecord::putLE<int64_t>(buffer_, s.positionTimeMs);
+        if (mask & STATIC_TIME) EventRecord::putLE<int64_t>(buffer_, staticTimeMs(s));
+        emitBuffer(s.mmsi);
+        return;
+    }
+
+    // 列顺序与VesselState::toCsv()一致，未变化的列留空
+    buffer_.clear();
+    buffer_.push_back(kind);
+    appendf(buffer_, ",%u,", s.mmsi);
+    if (mask & POSITION) appendf(buffer_, "%.6f,%.6f,", s.latitude, s.longitude);
+    else buffer_.append(",,");
+    if (mask & SPEED) appendf(buffer_, "%.1f", s.speedOverGround);
+    buffer_.push_back(',');
+    if (mask & COURSE) appendf(buffer_, "%.1f", s.courseOverGround);
+    buffer_.push_back(',');
+    if (mask & HEADING) appendf(buffer_, "%d", s.trueHeading);
+    buffer_.push_back(',');
+    if (mask & NAV_STATUS) appendf(buffer_, "%d", s.navigationStatus);
+    buffer_.push_back(',');
+    if (mask & NAME) CsvWriter::appendQuoted(buffer_, s.vesselName);
+    buffer_.push_back(',');
+    if (mask & CALLSIGN) CsvWriter::appendQuoted(buffer_, s.callSign);
+    buffer_.push_back(',');
+    if (mask & IMO) appendf(buffer_, "%u", s.imoNumber);
+    buffer_.push_back(',');
+    if (mask & SHIP_TYPE) appendf(buffer_, "%d", s.shipType);
+    buffer_.push_back(',');
+    if (mask & DIMENSIONS) appendf(buffer_, "%d,%d", s.length(), s.width());
+    else buffer_.push_back(',');
+    buffer_.push_back(',');
+    if (mask & DRAUGHT) appendf(buffer_, "%.1f", s.draught);
+    buffer_.push_back(',');
+    if (mask & DESTINATION) CsvWriter::appendQuoted(buffer_, s.destination);
+    buffer_.push_back(',');
+    if (mask & POSITION_TIME) appendf(buffer_, "%lld", static_cast<long long>(s.positionTimeMs));
+    buffer_.push_back(',');
+    if (mask & STATIC_TIME) appendf(buffer_, "%lld", static_cast<long long>(staticTimeMs(s)));
+    emitBuffer(s.mmsi);
+}
+
+} // namespace ais
@@ -2,6 +2,7 @@
 #define AIS_CONFIG_H
 
 #include <string>
+#include <vector>
 
 namespace ais
 {
@@ -31,9 +32,10 @@ struct AISParseCfg
 enum class StorageType
 {
     NONE,     // 不存储
-    DATABASE, // SQLite数据库
+    DATABASE, // SQLite数据库（storagePath为数据库文件）
     CSV,      // CSV文件
-    MEMORY    // 内存存储（调试用）
+    MEMORY,   // 内存环形存储（定长，覆盖最旧记录）
+    BINARY    // 定长二进制记录文件（见BinaryCodec）
 };
 
 /**
@@ -43,7 +45,18 @@ struct AISSaveCfg
 {
     bool saveSwitch = false;                    // 启用本地缓存
     StorageType storageType = StorageType::CSV; // 存储类型
-    std::string storagePath = "ais_data.csv";   // 存储路径
+    std::string storagePath = "ais_data.csv";   // 存储路径（分段文件以此为前缀）
+
+    int queueCapacity = 65536;                  // 写入队列容量，队列满时丢弃新记录
+    int flushIntervalMs = 1000;                 // 落盘周期（毫秒）
+    int segmentMaxSizeMB = 64;                  // 单个分段文件最大大小（MB，非正数表示不限制）
+    int segmentMaxSeconds = 3600;               // 单个分段文件最长时间跨度（秒，非正数表示不限制）
+    int transactionRows = 50000;                // 数据库单个事务最大行数（另按flushIntervalMs提交）
+    bool trackIndex = true;                     // 分段封存时生成按MMSI的航迹索引(.idx)
+    int spatialIndexLevel = 12;                 // 时空索引(.qidx)的QuadKey层级（0表示不生成）
+    int memoryRecords = 262144;                 // 内存环形存储的记录槽位数（每槽128字节）
+    int compactAfterHours = 0;                  // 二进制分段封存超过该小时数后做航迹压缩（0表示不压缩）
+    double compactToleranceMeters = 20.0;       // 航迹压缩容差（米），偏离匀速推算位置不超过该值的点被删除
 };
 
 /**
@@ -57,6 +70,25 @@ struct AISGenerateCfg
     std::string defaultSequenceId = "";         // 默认序列ID
 };
 
+/**
+ * @brief 转发数据格式枚举
+ */
+enum class OutputFormat
+{
+    CSV,      // CSV文本
+    BINARY    // 定长二进制记录（见BinaryCodec）
+};
+
+/**
+ * @brief 运动学异常报告的处理方式枚举
+ */
+enum class AnomalyAction
+{
+    NONE,       // 不校验
+    FLAG,       // 校验并发出异常事件，报告照常处理
+    QUARANTINE  // 校验并发出异常事件，异常报告不进入船舶状态、转发和存储
+};
+
 /**
  * @brief AIS通讯配置结构体
  */
@@ -68,6 +100,35 @@ struct CommunicateCfg
 
     int msgSaveSize;    // 本地保留消息最大长度（设置非正整数表示 不限制存储数量）
     int msgSaveTime;    // 本地保留消息的有效时间（单位秒）（设置非正整数表示 永久保留）
+    int cacheShards = 16; // 船舶信息缓存分片数（向上取2的幂，非正整数表示不分片）
+    int snapshotIntervalMs = 1000; // 船舶状态快照刷新周期（毫秒）（设置非正整数表示 查询时实时生成）
+    int workerThreads = 1;       // 解析工作线程数（设置非正整数表示 在接收回调线程中同步处理）
+    int pipelineQueueSize = 65536; // 流水线接收/发送队列容量
+    bool shardByMmsi = false;    // 按MMSI分发到各工作线程，每个线程独占部分船舶状态（workerThreads > 1时有效）
+    int sendBatchBytes = 1400;   // 转发合批的数据报大小上限（字节）（设置非正整数表示 每条记录单独发送）
+    int sendBatchDelayMs = 20;   // 合批最大等待时间（毫秒）
+    int publishIntervalMs = 0;   // 态势周期发布间隔（毫秒），启用后只发送变化船舶的增量，不再逐条转发（设置非正整数表示 逐条转发）
+    int keyframeInterval = 10;   // 态势发布的全量关键帧间隔（帧数）
+    double deadbandDistanceM = 0.0; // 逐条转发的位置死区（米），变化在死区内的位置报告不转发（设置非正数表示 不过滤）
+    double deadbandSpeedKn = 0.5;   // 航速死区（节）
+    double deadbandCourseDeg = 5.0; // 航向死区（度）
+    int deadbandMaxSilenceSec = 60; // 死区过滤下单船最长不转发时间（秒），超过时补发一次（设置非正整数表示 不补发）
+    int predictHorizonSec = 300; // 船位推算的最长外推时间（秒）（设置非正整数表示 不限制）
+    double spatialCellDeg = 0.1; // 实时船位网格索引的单元格边长（度）（设置非正数表示 不建立索引）
+    double cpaRangeNm = 0.0; // 碰撞风险候选船对的搜索半径（海里）（设置非正数表示 不计算，需启用网格索引；多个工作线程时强制按MMSI分片）
+    double cpaAlertNm = 0.5; // 碰撞风险告警的最近会遇距离CPA阈值（海里）
+    double tcpaAlertMin = 20.0; // 碰撞风险告警的最近会遇时间TCPA阈值（分钟）
+    int cpaIntervalMs = 1000; // 碰撞风险计算周期（毫秒）
+    int alertPort = 0; // 告警和围栏事件另发的本地端口（设置非正整数表示 只随转发数据发送）
+    std::string geofenceFile; // 电子围栏区域文件（YAML）（为空表示 不启用；多个工作线程时强制按MMSI分片）
+    double geofenceCellDeg = 0.01; // 电子围栏索引的单元格边长（度）
+    int geofenceReloadSec = 5; // 电子围栏区域文件的修改检查周期（秒）（设置非正整数表示 不热加载）
+    AnomalyAction anomalyAction = AnomalyAction::NONE; // 运动学异常报告的处理方式（要求接收时延小于1分钟，多个工作线程时强制按MMSI分片）
+    double anomalyMaxSpeedKn = 60.0; // 运动学校验的航速上限（节）
+    double anomalyCourseDeg = 90.0; // 移动方向与报告航向的偏差上限（度）（设置非正数表示 不校验航向）
+
+    OutputFormat outputFormat = OutputFormat::CSV; // 转发数据格式
+    std::vector<std::string> csvColumns; // 转发CSV的列投影（为空表示按消息类型输出完整列）
 };
 
 } // namespace ais
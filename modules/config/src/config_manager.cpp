@@ -86,10 +86,21 @@ bool ConfigManager::saveConfig()
             case StorageType::DATABASE: storageTypeStr = "DATABASE"; break;
             case StorageType::CSV: storageTypeStr = "CSV"; break;
             case StorageType::MEMORY: storageTypeStr = "MEMORY"; break;
+            case StorageType::BINARY: storageTypeStr = "BINARY"; break;
             default: storageTypeStr = "CSV";
         }
         configNode_["ais"]["save"]["storageType"] = storageTypeStr;
         configNode_["ais"]["save"]["storagePath"] = saveCfg_.storagePath;
+        configNode_["ais"]["save"]["queueCapacity"] = saveCfg_.queueCapacity;
+        configNode_["ais"]["save"]["flushIntervalMs"] = saveCfg_.flushIntervalMs;
+        configNode_["ais"]["save"]["segmentMaxSizeMB"] = saveCfg_.segmentMaxSizeMB;
+        configNode_["ais"]["save"]["segmentMaxSeconds"] = saveCfg_.segmentMaxSeconds;
+        configNode_["ais"]["save"]["transactionRows"] = saveCfg_.transactionRows;
+        configNode_["ais"]["save"]["trackIndex"] = saveCfg_.trackIndex;
+        configNode_["ais"]["save"]["spatialIndexLevel"] = saveCfg_.spatialIndexLevel;
+        configNode_["ais"]["save"]["memoryRecords"] = saveCfg_.memoryRecords;
+        configNode_["ais"]["save"]["compactAfterHours"] = saveCfg_.compactAfterHours;
+        configNode_["ais"]["save"]["compactToleranceMeters"] = saveCfg_.compactToleranceMeters;
         
         // 生成器配置
         configNode_["ais"]["generate"]["enableFragmentation"] = generateCfg_.enableFragmentation;
@@ -104,6 +115,37 @@ bool ConfigManager::saveConfig()
             configNode_["ais"]["communicate"]["sendPort"] = communicateCfg_->sendPort;
             configNode_["ais"]["communicate"]["msgSaveSize"] = communicateCfg_->msgSaveSize;
             configNode_["ais"]["communicate"]["msgSaveTime"] = communicateCfg_->msgSaveTime;
+            configNode_["ais"]["communicate"]["cacheShards"] = communicateCfg_->cacheShards;
+            configNode_["ais"]["communicate"]["snapshotIntervalMs"] = communicateCfg_->snapshotIntervalMs;
+            configNode_["ais"]["communicate"]["workerThreads"] = communicateCfg_->workerThreads;
+            configNode_["ais"]["communicate"]["pipelineQueueSize"] = communicateCfg_->pipelineQueueSize;
+            configNode_["ais"]["communicate"]["shardByMmsi"] = communicateCfg_->shardByMmsi;
+            configNode_["ais"]["communicate"]["sendBatchBytes"] = communicateCfg_->sendBatchBytes;
+            configNode_["ais"]["communicate"]["sendBatchDelayMs"] = communicateCfg_->sendBatchDelayMs;
+            configNode_["ais"]["communicate"]["publishIntervalMs"] = communicateCfg_->publishIntervalMs;
+            configNode_["ais"]["communicate"]["keyframeInterval"] = communicateCfg_->keyframeInterval;
+            configNode_["ais"]["communicate"]["deadbandDistanceM"] = communicateCfg_->deadbandDistanceM;
+            configNode_["ais"]["communicate"]["deadbandSpeedKn"] = communicateCfg_->deadbandSpeedKn;
+            configNode_["ais"]["communicate"]["deadbandCourseDeg"] = communicateCfg_->deadbandCourseDeg;
+            configNode_["ais"]["communicate"]["deadbandMaxSilenceSec"] = communicateCfg_->deadbandMaxSilenceSec;
+            configNode_["ais"]["communicate"]["predictHorizonSec"] = communicateCfg_->predictHorizonSec;
+            configNode_["ais"]["communicate"]["spatialCellDeg"] = communicateCfg_->spatialCellDeg;
+            configNode_["ais"]["communicate"]["cpaRangeNm"] = communicateCfg_->cpaRangeNm;
+            configNode_["ais"]["communicate"]["cpaAlertNm"] = communicateCfg_->cpaAlertNm;
+            configNode_["ais"]["communicate"]["tcpaAlertMin"] = communicateCfg_->tcpaAlertMin;
+            configNode_["ais"]["communicate"]["cpaIntervalMs"] = communicateCfg_->cpaIntervalMs;
+            configNode_["ais"]["communicate"]["alertPort"] = communicateCfg_->alertPort;
+            configNode_["ais"]["communicate"]["geofenceFile"] = communicateCfg_->geofenceFile;
+            configNode_["ais"]["communicate"]["geofenceCellDeg"] = communicateCfg_->geofenceCellDeg;
+            configNode_["ais"]["communicate"]["geofenceReloadSec"] = communicateCfg_->geofenceReloadSec;
+            configNode_["ais"]["communicate"]["anomalyAction"] =
+                communicateCfg_->anomalyAction == AnomalyAction::QUARANTINE ? "QUARANTINE" :
+                communicateCfg_->anomalyAction == AnomalyAction::FLAG ? "FLAG" : "NONE";
+            configNode_["ais"]["communicate"]["anomalyMaxSpeedKn"] = communicateCfg_->anomalyMaxSpeedKn;
+            configNode_["ais"]["communicate"]["anomalyCourseDeg"] = communicateCfg_->anomalyCourseDeg;
+            configNode_["ais"]["communicate"]["outputFormat"] =
+                communicateCfg_->outputFormat == OutputFormat::BINARY ? "BINARY" : "CSV";
+            configNode_["ais"]["communicate"]["csvColumns"] = communicateCfg_->csvColumns;
         }
         
         // 通讯库配置文件路径
@@ -290,6 +332,9 @@ void ConfigManager::parseSaveConfig()
         const auto& node = configNode_["ais"]["save"];
         if (node && node.IsMap()) {
             if (node["saveSwitch"]) {
+                saveCfg_.saveSwitch = node["saveSwitch"].as<bool>();
+            } else if (node["storageSwitch"]) {
+                // 兼容旧版配置键名
                 saveCfg_.saveSwitch = node["storageSwitch"].as<bool>();
             }
             
@@ -304,12 +349,44 @@ void ConfigManager::parseSaveConfig()
                     saveCfg_.storageType = StorageType::CSV;
                 } else if (typeStr == "MEMORY") {
                     saveCfg_.storageType = StorageType::MEMORY;
+                } else if (typeStr == "BINARY") {
+                    saveCfg_.storageType = StorageType::BINARY;
                 }
             }
             
             if (node["storagePath"]) {
                 saveCfg_.storagePath = node["storagePath"].as<std::string>();
             }
+            if (node["queueCapacity"]) {
+                saveCfg_.queueCapacity = node["queueCapacity"].as<int>();
+            }
+            if (node["flushIntervalMs"]) {
+                saveCfg_.flushIntervalMs = node["flushIntervalMs"].as<int>();
+            }
+            if (node["segmentMaxSizeMB"]) {
+                saveCfg_.segmentMaxSizeMB = node["segmentMaxSizeMB"].as<int>();
+            }
+            if (node["segmentMaxSeconds"]) {
+                saveCfg_.segmentMaxSeconds = node["segmentMaxSeconds"].as<int>();
+            }
+            if (node["transactionRows"]) {
+                saveCfg_.transactionRows = node["transactionRows"].as<int>();
+            }
+            if (node["trackIndex"]) {
+                saveCfg_.trackIndex = node["trackIndex"].as<bool>();
+            }
+            if (node["spatialIndexLevel"]) {
+                saveCfg_.spatialIndexLevel = node["spatialIndexLevel"].as<int>();
+            }
+            if (node["memoryRecords"]) {
+                saveCfg_.memoryRecords = node["memoryRecords"].as<int>();
+            }
+            if (node["compactAfterHours"]) {
+                saveCfg_.compactAfterHours = node["compactAfterHours"].as<int>();
+            }
+            if (node["compactToleranceMeters"]) {
+                saveCfg_.compactToleranceMeters = node["compactToleranceMeters"].as<double>();
+            }
         }
     } catch (...) {
         // 忽略解析错误，使用默认值
@@ -363,6 +440,93 @@ void ConfigManager::parseCommunicateConfig()
             if (node["msgSaveTime"]) {
                 cfg.msgSaveTime = node["msgSaveTime"].as<int>();
             }
+            if (node["cacheShards"]) {
+                cfg.cacheShards = node["cacheShards"].as<int>();
+            }
+            if (node["snapshotIntervalMs"]) {
+                cfg.snapshotIntervalMs = node["snapshotIntervalMs"].as<int>();
+            }
+            if (node["workerThreads"]) {
+                cfg.workerThreads = node["workerThreads"].as<int>();
+            }
+            if (node["pipelineQueueSize"]) {
+                cfg.pipelineQueueSize = node["pipelineQueueSize"].as<int>();
+            }
+            if (node["shardByMmsi"]) {
+                cfg.shardByMmsi = node["shardByMmsi"].as<bool>();
+            }
+            if (node["sendBatchBytes"]) {
+                cfg.sendBatchBytes = node["sendBatchBytes"].as<int>();
+            }
+            if (node["sendBatchDelayMs"]) {
+                cfg.sendBatchDelayMs = node["sendBatchDelayMs"].as<int>();
+            }
+            if (node["publishIntervalMs"]) {
+                cfg.publishIntervalMs = node["publishIntervalMs"].as<int>();
+            }
+            if (node["keyframeInterval"]) {
+                cfg.keyframeInterval = node["keyframeInterval"].as<int>();
+            }
+            if (node["deadbandDistanceM"]) {
+                cfg.deadbandDistanceM = node["deadbandDistanceM"].as<double>();
+            }
+            if (node["deadbandSpeedKn"]) {
+                cfg.deadbandSpeedKn = node["deadbandSpeedKn"].as<double>();
+            }
+            if (node["deadbandCourseDeg"]) {
+                cfg.deadbandCourseDeg = node["deadbandCourseDeg"].as<double>();
+            }
+            if (node["deadbandMaxSilenceSec"]) {
+                cfg.deadbandMaxSilenceSec = node["deadbandMaxSilenceSec"].as<int>();
+            }
+            if (node["predictHorizonSec"]) {
+                cfg.predictHorizonSec = node["predictHorizonSec"].as<int>();
+            }
+            if (node["spatialCellDeg"]) {
+                cfg.spatialCellDeg = node["spatialCellDeg"].as<double>();
+            }
+            if (node["cpaRangeNm"]) {
+                cfg.cpaRangeNm = node["cpaRangeNm"].as<double>();
+            }
+            if (node["cpaAlertNm"]) {
+                cfg.cpaAlertNm = node["cpaAlertNm"].as<double>();
+            }
+            if (node["tcpaAlertMin"]) {
+                cfg.tcpaAlertMin = node["tcpaAlertMin"].as<double>();
+            }
+            if (node["cpaIntervalMs"]) {
+                cfg.cpaIntervalMs = node["cpaIntervalMs"].as<int>();
+            }
+            if (node["alertPort"]) {
+                cfg.alertPort = node["alertPort"].as<int>();
+            }
+            if (node["geofenceFile"]) {
+                cfg.geofenceFile = node["geofenceFile"].as<std::string>();
+            }
+            if (node["geofenceCellDeg"]) {
+                cfg.geofenceCellDeg = node["geofenceCellDeg"].as<double>();
+            }
+            if (node["geofenceReloadSec"]) {
+                cfg.geofenceReloadSec = node["geofenceReloadSec"].as<int>();
+            }
+            if (node["anomalyAction"]) {
+                std::string actionStr = node["anomalyAction"].as<std::string>();
+                cfg.anomalyAction = (actionStr == "QUARANTINE") ? AnomalyAction::QUARANTINE :
+                                    (actionStr == "FLAG") ? AnomalyAction::FLAG : AnomalyAction::NONE;
+            }
+            if (node["anomalyMaxSpeedKn"]) {
+                cfg.anomalyMaxSpeedKn = node["anomalyMaxSpeedKn"].as<double>();
+            }
+            if (node["anomalyCourseDeg"]) {
+                cfg.anomalyCourseDeg = node["anomalyCourseDeg"].as<double>();
+            }
+            if (node["outputFormat"]) {
+                std::string formatStr = node["outputFormat"].as<std::string>();
+                cfg.outputFormat = (formatStr == "BINARY") ? OutputFormat::BINARY : OutputFormat::CSV;
+            }
+            if (node["csvColumns"] && node["csvColumns"].IsSequence()) {
+                cfg.csvColumns = node["csvColumns"].as<std::vector<std::string>>();
+            }
             
             communicateCfg_ = cfg;
         } else {
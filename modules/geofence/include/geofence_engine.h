@@ -0,0 +1,172 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        geofence_engine.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 电子围栏（按船舶跟踪在区状态，产生进入/离开/停留事件，区域文件可热加载）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        CSV事件的区域名称按CSV规则转义引号
+
+*****************************************************************/
+
+#ifndef AIS_GEOFENCE_ENGINE_H
+#define AIS_GEOFENCE_ENGINE_H
+
+#include "geofence_index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 围栏事件类型
+ */
+enum class GeofenceEventType : uint8_t
+{
+    ENTER = 1,
+    EXIT = 2,
+    DWELL = 3       // 在区时间达到区域的dwellSec（每次进入只产生一次）
+};
+
+/**
+ * @brief 围栏事件
+ */
+struct GeofenceEvent
+{
+    uint32_t mmsi = 0;
+    uint32_t zoneId = 0;
+    GeofenceEventType type = GeofenceEventType::ENTER;
+    int64_t timeMs = 0;         // 触发事件的位置时间（毫秒）
+    int64_t enterMs = 0;        // 进入区域的时间（毫秒）
+    std::string zoneName;       // 区域已在重新加载中删除时为空
+};
+
+/**
+ * @brief 电子围栏引擎
+ *
+ * 每次位置更新在当前区域索引中查询所在区域（与区域总数无关），与该船上次的在区集合比较产生进入/离开事件，
+ * 在区时间达到区域dwellSec时产生一次停留事件。只保存位于某个区域内的船舶，每船状态为其所在区域列表。
+ * 按MMSI分片加锁，不同处理线程更新不同船舶时互不阻塞；事件在释放分片锁后回调。
+ *
+ * 区域文件为YAML，格式：
+ * @code
+ * zones:
+ *   - id: 1
+ *     name: "berth-3"
+ *     dwellSec: 600                    # 可选
+ *     points: [[31.2301, 121.4901], [31.2305, 121.4950], [31.2280, 121.4952]]   # [纬度, 经度]
+ * @endcode
+ * 重新加载时构建新索引后原子替换，查询中的线程继续使用旧索引；按区域ID保留船舶的在区状态，
+ * 已删除区域在该船下次位置更新时产生离开事件。
+ *
+ * 事件格式（format）：
+ * - CSV：G,mmsi,zoneId,ENTER|EXIT|DWELL,timeMs,enterMs,"zoneName"（名称中的引号按CSV规则转义）
+ * - 二进制（小端）：记录头8字节 魔数0xA6 + 版本 + 类型'G' + 事件类型(1/2/3) + MMSI(u32)，
+ *        之后为 区域ID(u32) + 时间(i64) + 进入时间(i64)
+ */
+class GeofenceEngine
+{
+public:
+    /**
+     * @brief 事件回调（在调用update/remove的线程中调用，需线程安全）
+     */
+    typedef std::function<void(const GeofenceEvent &event)> event_func;
+
+    /**
+     * @brief 构造函数
+     * @param cellDeg 区域索引的单元格边长（度）
+     * @param shardCount 船舶状态分片数，0按1处理
+     * @param event 事件回调
+     */
+    GeofenceEngine(double cellDeg, size_t shardCount, event_func event);
+
+    /**
+     * @brief 从文件加载区域并替换当前索引
+     * @return 成功返回0，文件无法解析返回-1（保留原有区域）
+     */
+    int loadZones(const std::string &path);
+
+    /**
+     * @brief 上次加载的文件修改时间变化时重新加载
+     * @return 重新加载成功返回true
+     */
+    bool reloadIfChanged();
+
+    /**
+     * @brief 处理一次位置更新（线程安全），位置不可用时忽略
+     * @param timeMs 位置时间（毫秒）
+     */
+    void update(uint32_t mmsi, double latitude, double longitude, int64_t timeMs);
+
+    /**
+     * @brief 船舶消失（线程安全），对其所在的每个区域产生离开事件
+     */
+    void remove(uint32_t mmsi, int64_t timeMs);
+
+    /**
+     * @brief 清空全部船舶的在区状态（不产生事件）
+     */
+    void clear();
+
+    size_t getZoneCount() const;
+    std::shared_ptr<const GeofenceIndex> getIndex() const;
+
+    /**
+     * @brief 解析区域文件
+     * @param zones [out] 区域列表
+     * @return 成功返回0，失败返回-1
+     */
+    static int parseZones(const std::string &path, std::vector<GeoZone> &zones);
+
+    /**
+     * @brief 把事件格式化为转发记录（CSV不含结尾'\0'）
+     */
+    static void format(const GeofenceEvent &event, bool binary, std::string &out);
+
+private:
+    struct Presence
+    {
+        uint32_t zoneId;
+        int64_t enterMs;
+        bool dwellSent;
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<uint32_t, std::vector<Presence>> vessels;    // 只保存在区船舶
+    };
+
+    Shard &shardOf(uint32_t mmsi);
+
+    double cellDeg_;
+    event_func event_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    unsigned shardBits_ = 0;
+
+    // 当前区域索引：查询方通过std::atomic_load取得，加载方原子替换
+    std::shared_ptr<const GeofenceIndex> index_;
+
+    // 热加载状态（仅加载方访问）
+    std::mutex loadMutex_;
+    std::string path_;
+    std::filesystem::file_time_type mtime_{};
+};
+
+} // namespace ais
+
+#endif // AIS_GEOFENCE_ENGINE_H
@@ -0,0 +1,143 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        geofence_index.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 电子围栏多边形区域的网格索引（预计算单元格归属和行内边桶，点查询与区域总数无关）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        大区域按粗网格分桶，查询不再逐个扫描
+
+*****************************************************************/
+
+#ifndef AIS_GEOFENCE_INDEX_H
+#define AIS_GEOFENCE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 多边形顶点（度）
+ */
+struct GeoPoint
+{
+    double latitude = 0.0;
+    double longitude = 0.0;
+};
+
+/**
+ * @brief 围栏区域
+ */
+struct GeoZone
+{
+    uint32_t id = 0;                // 区域ID（重新加载时按ID保持船舶的在区状态）
+    std::string name;
+    int dwellSec = 0;               // 停留告警时长（秒），非正数表示不产生停留事件
+    std::vector<GeoPoint> points;   // 多边形顶点（不少于3个，首尾不必重复，不支持跨越180度经线）
+};
+
+/**
+ * @brief 围栏区域网格索引（构建后只读，可多线程并发查询）
+ *
+ * 经纬度按cellDeg划分网格，构建时对每个区域外接矩形内的单元格分类：
+ * - 完全在多边形内：查询落在该单元格时直接命中，不做点在多边形内判断；
+ * - 有多边形边经过：查询时做射线判断，只使用该区域在查询点所在网格行内的边（行内边桶）；
+ * - 完全在多边形外：不记录。
+ * 查询只访问查询点所在的一个单元格，耗时取决于该单元格内的区域数和边数，与区域总数无关。
+ * 外接矩形超过MAX_ZONE_CELLS个单元格的大区域不展开到单元格，只按外接矩形登记到边长不小于LARGE_CELL_MIN_DEG的
+ * 粗网格中，查询时只判断查询点所在粗单元格内的大区域（行内边桶射线判断）。
+ */
+class GeofenceIndex
+{
+public:
+    static constexpr size_t MAX_ZONE_CELLS = 65536;     // 单个区域展开的单元格数上限
+    static constexpr double LARGE_CELL_MIN_DEG = 1.0;   // 大区域粗网格的最小边长（度），全球范围不超过64800个单元格
+    static constexpr double LARGE_CELL_FACTOR = 16.0;   // 粗网格边长相对单元格边长的倍数
+
+    /**
+     * @brief 构建索引
+     * @param cellDeg 单元格边长（度）
+     * @param zones 区域列表（顶点少于3个的区域被忽略）
+     */
+    GeofenceIndex(double cellDeg, std::vector<GeoZone> zones);
+
+    /**
+     * @brief 查询包含指定位置的区域
+     * @param zones [out] 追加包含该位置的区域在zones()中的下标
+     * @return 本次追加的区域数
+     */
+    size_t query(double latitude, double longitude, std::vector<uint32_t> &zones) const;
+
+    const std::vector<GeoZone> &zones() const { return zones_; }
+
+    /**
+     * @brief 按区域ID查找区域，不存在时返回nullptr
+     */
+    const GeoZone *findZone(uint32_t id) const;
+
+    double cellDeg() const { return cellDeg_; }
+    size_t getCellCount() const { return cells_.size(); }
+    size_t getLargeZoneCount() const { return largeZones_.size(); }
+
+private:
+    struct Edge
+    {
+        double x0, y0, x1, y1;      // 经度、纬度
+    };
+
+    struct Slab
+    {
+        uint32_t offset;            // 在edges_中的起始下标
+        uint32_t count;
+    };
+
+    struct ZoneGrid
+    {
+        double minLat, minLon, maxLat, maxLon;
+        int64_t row0, row1;         // 外接矩形覆盖的网格行
+        size_t slabOffset;          // 在slabs_中的起始下标，每行一个
+    };
+
+    struct CellEntry
+    {
+        uint32_t zone;              // 区域下标
+        bool boundary;              // 是否有多边形边经过（需做射线判断）
+    };
+
+    int64_t column(double longitude) const;
+    int64_t row(double latitude) const;
+    uint64_t largeCellKey(double latitude, double longitude) const;
+    static uint64_t cellKey(int64_t x, int64_t y);
+
+    /**
+     * @brief 射线法判断点是否在区域内（只使用点所在行的边桶）
+     */
+    bool contains(uint32_t zone, double latitude, double longitude) const;
+
+    void build(uint32_t zone);
+
+    double cellDeg_;
+    double largeCellDeg_;
+    std::vector<GeoZone> zones_;
+    std::unordered_map<uint32_t, uint32_t> zoneIds_;                // 区域ID -> 下标
+    std::vector<ZoneGrid> grids_;
+    std::vector<Slab> slabs_;
+    std::vector<Edge> edges_;
+    std::unordered_map<uint64_t, std::vector<CellEntry>> cells_;
+    std::vector<uint32_t> largeZones_;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> largeCells_;   // 粗单元格 -> 外接矩形覆盖它的大区域
+};
+
+} // namespace ais
+
+#endif // AIS_GEOFENCE_INDEX_H
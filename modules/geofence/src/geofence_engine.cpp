@@ -0,0 +1,291 @@
+#include "geofence_engine.h"
+
+#include "logger_define.h"
+#include "utils/csv_writer.h"
+#include "utils/event_record.h"
+
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <unordered_set>
+#include <utility>
+
+namespace ais {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* eventName(GeofenceEventType type)
+{
+    switch (type)
+    {
+    case GeofenceEventType::ENTER:
+        return "ENTER";
+    case GeofenceEventType::EXIT:
+        return "EXIT";
+    case GeofenceEventType::DWELL:
+        return "DWELL";
+    }
+    return "";
+}
+
+GeofenceEvent makeEvent(uint32_t mmsi, uint32_t zoneId, GeofenceEventType type, int64_t timeMs, int64_t enterMs,
+                        const GeofenceIndex* index)
+{
+    GeofenceEvent event;
+    event.mmsi = mmsi;
+    event.zoneId = zoneId;
+    event.type = type;
+    event.timeMs = timeMs;
+    event.enterMs = enterMs;
+    const GeoZone* zone = index ? index->findZone(zoneId) : nullptr;
+    if (zone) {
+        event.zoneName = zone->name;
+    }
+    return event;
+}
+
+} // namespace
+
+GeofenceEngine::GeofenceEngine(double cellDeg, size_t shardCount, event_func event)
+    : cellDeg_(cellDeg)
+    , event_(std::move(event))
+{
+    // 分片数向上取2的幂，按MMSI的Fibonacci散列选择分片
+    while ((static_cast<size_t>(1) << shardBits_) < std::max<size_t>(shardCount, 1)) {
+        shardBits_++;
+    }
+    for (size_t i = 0; i < (static_cast<size_t>(1) << shardBits_); ++i) {
+        shards_.emplace_back(new Shard());
+    }
+}
+
+GeofenceEngine::Shard& GeofenceEngine::shardOf(uint32_t mmsi)
+{
+    if (shardBits_ == 0) {
+        return *shards_[0];
+    }
+    const uint64_t h = static_cast<uint64_t>(mmsi) * 0x9E3779B97F4A7C15ULL;
+    return *shards_[static_cast<size_t>(h >> (64 - shardBits_))];
+}
+
+int GeofenceEngine::parseZones(const std::string& path, std::vector<GeoZone>& zones)
+{
+    zones.clear();
+    try {
+        const YAML::Node root = YAML::LoadFile(path);
+        const YAML::Node list = root["zones"];
+        if (!list || !list.IsSequence()) {
+            LOG_ERROR("Geofence file has no zone list: {}", path);
+            return -1;
+        }
+
+        std::unordered_set<uint32_t> ids;
+        for (size_t i = 0; i < list.size(); ++i) {
+            const YAML::Node node = list[i];
+            GeoZone zone;
+            zone.id = node["id"] ? node["id"].as<uint32_t>() : static_cast<uint32_t>(i + 1);
+            if (node["name"]) {
+                zone.name = node["name"].as<std::string>();
+            }
+            if (node["dwellSec"]) {
+                zone.dwellSec = node["dwellSec"].as<int>();
+            }
+            if (node["points"]) {
+                for (const auto& point : node["points"]) {
+                    if (point.IsSequence() && point.size() >= 2) {
+                        zone.points.push_back(GeoPoint{point[0].as<double>(), point[1].as<double>()});
+                    }
+                }
+            }
+
+            if (zone.points.size() < 3) {
+                LOG_WARNING("Geofence zone {} has fewer than 3 points, skipped", zone.id);
+                continue;
+            }
+            if (!ids.insert(zone.id).second) {
+                LOG_WARNING("Duplicate geofence zone id {}, skipped", zone.id);
+                continue;
+            }
+            zones.push_back(std::move(zone));
+        }
+        return 0;
+
+    } catch (const YAML::Exception& e) {
+        LOG_ERROR("Failed to load geofence file {}: {}", path, e.what());
+        return -1;
+    }
+}
+
+int GeofenceEngine::loadZones(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(loadMutex_);
+
+    std::error_code ec;
+    const fs::file_time_type mtime = fs::last_write_time(path, ec);
+
+    std::vector<GeoZone> zones;
+    if (parseZones(path, zones) != 0) {
+        // 记录修改时间，文件修正前不再反复尝试
+        path_ = path;
+        mtime_ = mtime;
+        return -1;
+    }
+
+    auto index = std::make_shared<const GeofenceIndex>(cellDeg_, std::move(zones));
+    std::atomic_store(&index_, index);
+    path_ = path;
+    mtime_ = mtime;
+
+    LOG_INFO("Geofence zones loaded: Zones={}, Cells={}, LargeZones={}, File={}",
+             index->zones().size(), index->getCellCount(), index->getLargeZoneCount(), path);
+    return 0;
+}
+
+bool GeofenceEngine::reloadIfChanged()
+{
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(loadMutex_);
+        if (path_.empty()) {
+            return false;
+        }
+        std::error_code ec;
+        const fs::file_time_type mtime = fs::last_write_time(path_, ec);
+        if (ec || mtime == mtime_) {
+            return false;
+        }
+        path = path_;
+    }
+    return loadZones(path) == 0;
+}
+
+void GeofenceEngine::update(uint32_t mmsi, double latitude, double longitude, int64_t timeMs)
+{
+    if (latitude < -90.0 || latitude > 90.0 || longitude < -180.0 || longitude > 180.0) {
+        return;
+    }
+
+    const std::shared_ptr<const GeofenceIndex> index = std::atomic_load(&index_);
+    thread_local std::vector<uint32_t> hits;
+    thread_local std::vector<GeofenceEvent> events;
+    hits.clear();
+    events.clear();
+    if (index) {
+        index->query(latitude, longitude, hits);
+    }
+
+    Shard& shard = shardOf(mmsi);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.vessels.find(mmsi);
+        if (it == shard.vessels.end()) {
+            if (hits.empty()) {
+                return;
+            }
+            it = shard.vessels.emplace(mmsi, std::vector<Presence>()).first;
+        }
+        std::vector<Presence>& presence = it->second;
+
+        // 不再包含该位置的区域（含已删除的区域）产生离开事件
+        for (size_t i = 0; i < presence.size();) {
+            const uint32_t zoneId = presence[i].zoneId;
+            const bool still = std::any_of(hits.begin(), hits.end(), [&](uint32_t zone) {
+                return index->zones()[zone].id == zoneId;
+            });
+            if (still) {
+                ++i;
+                continue;
+            }
+            events.push_back(makeEvent(mmsi, zoneId, GeofenceEventType::EXIT, timeMs, presence[i].enterMs, index.get()));
+            presence[i] = presence.back();
+            presence.pop_back();
+        }
+
+        for (uint32_t zone : hits) {
+            const GeoZone& geoZone = index->zones()[zone];
+            auto p = std::find_if(presence.begin(), presence.end(), [&](const Presence& item) {
+                return item.zoneId == geoZone.id;
+            });
+            if (p == presence.end()) {
+                presence.push_back(Presence{geoZone.id, timeMs, false});
+                events.push_back(makeEvent(mmsi, geoZone.id, GeofenceEventType::ENTER, timeMs, timeMs, index.get()));
+            } else if (geoZone.dwellSec > 0 && !p->dwellSent && timeMs - p->enterMs >= geoZone.dwellSec * 1000LL) {
+                p->dwellSent = true;
+                events.push_back(makeEvent(mmsi, geoZone.id, GeofenceEventType::DWELL, timeMs, p->enterMs, index.get()));
+            }
+        }
+
+        if (presence.empty()) {
+            shard.vessels.erase(it);
+        }
+    }
+
+    for (const GeofenceEvent& event : events) {
+        event_(event);
+    }
+}
+
+void GeofenceEngine::remove(uint32_t mmsi, int64_t timeMs)
+{
+    const std::shared_ptr<const GeofenceIndex> index = std::atomic_load(&index_);
+    std::vector<Presence> presence;
+    {
+        Shard& shard = shardOf(mmsi);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.vessels.find(mmsi);
+        if (it == shard.vessels.end()) {
+            return;
+        }
+        presence.swap(it->second);
+        shard.vessels.erase(it);
+    }
+
+    for (const Presence& item : presence) {
+        event_(makeEvent(mmsi, item.zoneId, GeofenceEventType::EXIT, timeMs, item.enterMs, index.get()));
+    }
+}
+
+void GeofenceEngine::clear()
+{
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->vessels.clear();
+    }
+}
+
+size_t GeofenceEngine::getZoneCount() const
+{
+    const std::shared_ptr<const GeofenceIndex> index = std::atomic_load(&index_);
+    return index ? index->zones().size() : 0;
+}
+
+std::shared_ptr<const GeofenceIndex> GeofenceEngine::getIndex() const
+{
+    return std::atomic_load(&index_);
+}
+
+void GeofenceEngine::format(const GeofenceEvent& event, bool binary, std::string& out)
+{
+    out.clear();
+    if (binary) {
+        EventRecord::begin(out, 'G', static_cast<uint8_t>(event.type), event.mmsi);
+        EventRecord::putLE<uint32_t>(out, event.zoneId);
+        EventRecord::putLE<int64_t>(out, event.timeMs);
+        EventRecord::putLE<int64_t>(out, event.enterMs);
+        return;
+    }
+
+    char text[96];
+    int len = std::snprintf(text, sizeof(text), "G,%u,%u,%s,%lld,%lld,", event.mmsi, event.zoneId,
+                            eventName(event.type), static_cast<long long>(event.timeMs),
+                            static_cast<long long>(event.enterMs));
+    if (len > 0) {
+        out.assign(text, std::min(static_cast<size_t>(len), sizeof(text) - 1));
+    }
+    CsvWriter::appendQuoted(out, event.zoneName);
+}
+
+} // namespace ais
@@ -0,0 +1,210 @@
+#include "geofence_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ais {
+
+namespace {
+
+/**
+ * @brief 线段与闭矩形是否相交（Liang-Barsky裁剪）
+ */
+bool segmentHitsRect(double x0, double y0, double x1, double y1,
+                     double xmin, double ymin, double xmax, double ymax)
+{
+    double t0 = 0.0;
+    double t1 = 1.0;
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {x0 - xmin, xmax - x0, y0 - ymin, ymax - y0};
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0) {
+            if (q[i] < 0.0) {
+                return false;
+            }
+            continue;
+        }
+        const double t = q[i] / p[i];
+        if (p[i] < 0.0) {
+            if (t > t1) {
+                return false;
+            }
+            t0 = std::max(t0, t);
+        } else {
+            if (t < t0) {
+                return false;
+            }
+            t1 = std::min(t1, t);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+GeofenceIndex::GeofenceIndex(double cellDeg, std::vector<GeoZone> zones)
+    : cellDeg_(std::min(std::max(cellDeg, 1e-4), 90.0))
+    , largeCellDeg_(std::max(cellDeg_ * LARGE_CELL_FACTOR, LARGE_CELL_MIN_DEG))
+{
+    for (GeoZone& zone : zones) {
+        if (zone.points.size() >= 3) {
+            zones_.push_back(std::move(zone));
+        }
+    }
+    for (uint32_t i = 0; i < zones_.size(); ++i) {
+        zoneIds_[zones_[i].id] = i;
+        build(i);
+    }
+}
+
+int64_t GeofenceIndex::column(double longitude) const
+{
+    return static_cast<int64_t>(std::floor((longitude + 180.0) / cellDeg_));
+}
+
+int64_t GeofenceIndex::row(double latitude) const
+{
+    return static_cast<int64_t>(std::floor((latitude + 90.0) / cellDeg_));
+}
+
+uint64_t GeofenceIndex::cellKey(int64_t x, int64_t y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32) | static_cast<uint32_t>(x);
+}
+
+uint64_t GeofenceIndex::largeCellKey(double latitude, double longitude) const
+{
+    return cellKey(static_cast<int64_t>(std::floor((longitude + 180.0) / largeCellDeg_)),
+                   static_cast<int64_t>(std::floor((latitude + 90.0) / largeCellDeg_)));
+}
+
+const GeoZone* GeofenceIndex::findZone(uint32_t id) const
+{
+    auto it = zoneIds_.find(id);
+    return it == zoneIds_.end() ? nullptr : &zones_[it->second];
+}
+
+void GeofenceIndex::build(uint32_t zone)
+{
+    const std::vector<GeoPoint>& points = zones_[zone].points;
+
+    ZoneGrid grid;
+    grid.minLat = grid.maxLat = points[0].latitude;
+    grid.minLon = grid.maxLon = points[0].longitude;
+    for (const GeoPoint& p : points) {
+        grid.minLat = std::min(grid.minLat, p.latitude);
+        grid.maxLat = std::max(grid.maxLat, p.latitude);
+        grid.minLon = std::min(grid.minLon, p.longitude);
+        grid.maxLon = std::max(grid.maxLon, p.longitude);
+    }
+    grid.row0 = row(grid.minLat);
+    grid.row1 = row(grid.maxLat);
+    grid.slabOffset = slabs_.size();
+
+    // 每个网格行保存与该行纬度范围相交的边，同一条边可能出现在多行
+    for (int64_t r = grid.row0; r <= grid.row1; ++r) {
+        const double lo = r * cellDeg_ - 90.0;
+        const double hi = lo + cellDeg_;
+        Slab slab{static_cast<uint32_t>(edges_.size()), 0};
+        for (size_t i = 0; i < points.size(); ++i) {
+            const GeoPoint& a = points[i];
+            const GeoPoint& b = points[(i + 1) % points.size()];
+            if (std::max(a.latitude, b.latitude) >= lo && std::min(a.latitude, b.latitude) <= hi) {
+                edges_.push_back(Edge{a.longitude, a.latitude, b.longitude, b.latitude});
+                slab.count++;
+            }
+        }
+        slabs_.push_back(slab);
+    }
+    grids_.push_back(grid);
+
+    const int64_t col0 = column(grid.minLon);
+    const int64_t col1 = column(grid.maxLon);
+    if (static_cast<uint64_t>(col1 - col0 + 1) * static_cast<uint64_t>(grid.row1 - grid.row0 + 1) > MAX_ZONE_CELLS) {
+        largeZones_.push_back(zone);
+        const int64_t x0 = static_cast<int64_t>(std::floor((grid.minLon + 180.0) / largeCellDeg_));
+        const int64_t x1 = static_cast<int64_t>(std::floor((grid.maxLon + 180.0) / largeCellDeg_));
+        const int64_t y0 = static_cast<int64_t>(std::floor((grid.minLat + 90.0) / largeCellDeg_));
+        const int64_t y1 = static_cast<int64_t>(std::floor((grid.maxLat + 90.0) / largeCellDeg_));
+        for (int64_t y = y0; y <= y1; ++y) {
+            for (int64_t x = x0; x <= x1; ++x) {
+                largeCells_[cellKey(x, y)].push_back(zone);
+            }
+        }
+        return;
+    }
+
+    // 单元格分类：有边经过为边界单元格，否则整个单元格同在内或同在外，用中心点判断
+    for (int64_t r = grid.row0; r <= grid.row1; ++r) {
+        const Slab& slab = slabs_[grid.slabOffset + static_cast<size_t>(r - grid.row0)];
+        const double ymin = r * cellDeg_ - 90.0;
+        const double ymax = ymin + cellDeg_;
+        for (int64_t c = col0; c <= col1; ++c) {
+            const double xmin = c * cellDeg_ - 180.0;
+            const double xmax = xmin + cellDeg_;
+            bool boundary = false;
+            for (uint32_t i = 0; i < slab.count && !boundary; ++i) {
+                const Edge& e = edges_[slab.offset + i];
+                boundary = segmentHitsRect(e.x0, e.y0, e.x1, e.y1, xmin, ymin, xmax, ymax);
+            }
+            if (boundary) {
+                cells_[cellKey(c, r)].push_back(CellEntry{zone, true});
+            } else if (contains(zone, (ymin + ymax) * 0.5, (xmin + xmax) * 0.5)) {
+                cells_[cellKey(c, r)].push_back(CellEntry{zone, false});
+            }
+        }
+    }
+}
+
+bool GeofenceIndex::contains(uint32_t zone, double latitude, double longitude) const
+{
+    const ZoneGrid& grid = grids_[zone];
+    if (latitude < grid.minLat || latitude > grid.maxLat || longitude < grid.minLon || longitude > grid.maxLon) {
+        return false;
+    }
+
+    const int64_t r = std::min(std::max(row(latitude), grid.row0), grid.row1);
+    const Slab& slab = slabs_[grid.slabOffset + static_cast<size_t>(r - grid.row0)];
+
+    // 向东的水平射线与边的交点数为奇数时在区域内；与射线相交的边纬度范围必然覆盖查询点，都在本行边桶中
+    bool inside = false;
+    for (uint32_t i = 0; i < slab.count; ++i) {
+        const Edge& e = edges_[slab.offset + i];
+        if ((e.y0 > latitude) != (e.y1 > latitude) &&
+            longitude < (e.x1 - e.x0) * (latitude - e.y0) / (e.y1 - e.y0) + e.x0) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+size_t GeofenceIndex::query(double latitude, double longitude, std::vector<uint32_t>& zones) const
+{
+    if (latitude < -90.0 || latitude > 90.0 || longitude < -180.0 || longitude > 180.0) {
+        return 0;
+    }
+
+    const size_t before = zones.size();
+    auto it = cells_.find(cellKey(column(longitude), row(latitude)));
+    if (it != cells_.end()) {
+        for (const CellEntry& entry : it->second) {
+            if (!entry.boundary || contains(entry.zone, latitude, longitude)) {
+                zones.push_back(entry.zone);
+            }
+        }
+    }
+    auto large = largeCells_.find(largeCellKey(latitude, longitude));
+    if (large != largeCells_.end()) {
+        for (uint32_t zone : large->second) {
+            if (contains(zone, latitude, longitude)) {
+                zones.push_back(zone);
+            }
+        }
+    }
+    return zones.size() - before;
+}
+
+} // namespace ais
@@ -0,0 +1,93 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        ais_storage.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: AIS数据本地存储接口
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_STORAGE_H
+#define AIS_STORAGE_H
+
+#include "config.h"
+#include "messages/message.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace ais
+{
+
+/**
+ * @brief 待存储记录
+ */
+struct StorageRecord
+{
+    std::shared_ptr<const AISMessage> msg;  // 解析后的消息（与转发路径共享，不拷贝）
+    int64_t timeMs = 0;                     // 接收时间（Unix毫秒）
+};
+
+/**
+ * @brief 存储运行统计
+ */
+struct StorageStats
+{
+    uint64_t enqueued = 0;      // 入队记录数
+    uint64_t dropped = 0;       // 队列满被丢弃的记录数
+    uint64_t written = 0;       // 已写入记录数
+    uint64_t flushes = 0;       // 落盘次数
+    size_t queueDepth = 0;      // 当前队列深度（近似值）
+};
+
+/**
+ * @brief 存储后端接口
+ *
+ * store()在接收线程中调用，实现必须是非阻塞的
+ */
+class AISStorage
+{
+public:
+    virtual ~AISStorage() = default;
+
+    /**
+     * @brief 启动存储（打开文件/数据库并启动写线程）
+     * @return 成功返回true
+     */
+    virtual bool start() = 0;
+
+    /**
+     * @brief 停止存储，写出剩余数据后关闭
+     */
+    virtual void stop() = 0;
+
+    /**
+     * @brief 提交一条记录（非阻塞）
+     * @param msg 解析后的消息
+     * @param timeMs 接收时间（Unix毫秒）
+     * @return 记录被接收返回true，队列满或未启动时返回false
+     */
+    virtual bool store(std::shared_ptr<const AISMessage> msg, int64_t timeMs) = 0;
+
+    /**
+     * @brief 获取运行统计
+     */
+    virtual StorageStats getStats() const = 0;
+};
+
+/**
+ * @brief 按配置创建存储后端
+ * @param cfg 存储配置
+ * @return 存储实例，未启用存储或类型不支持时返回nullptr
+ */
+std::shared_ptr<AISStorage> createStorage(const AISSaveCfg &cfg);
+
+} // namespace ais
+
+#endif // AIS_STORAGE_H
@@ -0,0 +1,97 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        async_storage.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 后台线程批量写入的存储基类
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_ASYNC_STORAGE_H
+#define AIS_ASYNC_STORAGE_H
+
+#include "ais_storage.h"
+#include "utils/bounded_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 异步存储基类
+ *
+ * 接收线程通过store()将记录放入有界无锁队列，队列满时直接丢弃并计数；
+ * 后台写线程批量取出记录交给writeBatch()（组提交），并按flushInterval周期调用flushSink()
+ *
+ * @note 派生类析构时需先调用stop()，避免写线程回调已析构的派生类成员
+ */
+class AsyncStorage : public AISStorage
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param queueCapacity 队列容量
+     * @param flushIntervalMs 落盘周期（毫秒）
+     * @param maxBatch 单次组提交的最大记录数
+     */
+    AsyncStorage(size_t queueCapacity, int flushIntervalMs, size_t maxBatch = 4096);
+    ~AsyncStorage() override;
+
+    bool start() override;
+    void stop() override;
+    bool store(std::shared_ptr<const AISMessage> msg, int64_t timeMs) override;
+    StorageStats getStats() const override;
+
+protected:
+    /**
+     * @brief 打开存储目标（写线程启动前调用）
+     */
+    virtual bool openSink() = 0;
+
+    /**
+     * @brief 写入一批记录（写线程中调用）
+     * @return 成功返回true
+     */
+    virtual bool writeBatch(const std::vector<StorageRecord> &batch) = 0;
+
+    /**
+     * @brief 周期性落盘（写线程中调用，无新数据时也会调用）
+     */
+    virtual void flushSink() = 0;
+
+    /**
+     * @brief 关闭存储目标（写线程退出前调用）
+     */
+    virtual void closeSink() = 0;
+
+    static int64_t nowMs();
+
+private:
+    void run();
+
+    BoundedQueue<StorageRecord> queue_;
+    std::chrono::milliseconds flushInterval_;
+    size_t maxBatch_;
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+
+    std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> flushes_{0};
+};
+
+} // namespace ais
+
+#endif // AIS_ASYNC_STORAGE_H
@@ -0,0 +1,207 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        columnar_archive.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 历史船位的分块列式压缩归档格式
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        打开已有文件时截断异常退出留下的不完整尾块
+3             2026-10-18     cjx        数据块解码失败时不留下部分结果
+
+*****************************************************************/
+
+#ifndef AIS_COLUMNAR_ARCHIVE_H
+#define AIS_COLUMNAR_ARCHIVE_H
+
+#include "messages/message.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 船位列式数据（SoA）
+ *
+ * 经纬度为1/600000度的定点整数，速度/航向为0.1单位整数，与AIS原始精度一致
+ */
+struct PositionColumns
+{
+    std::vector<int64_t> timeMs;        // 接收时间（毫秒）
+    std::vector<uint32_t> mmsi;         // MMSI
+    std::vector<int32_t> latitude;      // 纬度定点值
+    std::vector<int32_t> longitude;     // 经度定点值
+    std::vector<uint16_t> speed;        // 对地速度 (0.1节)
+    std::vector<uint16_t> course;       // 对地航向 (0.1度)
+    std::vector<uint16_t> heading;      // 真航向 (511表示不可用)
+    std::vector<uint8_t> navStatus;     // 导航状态
+    std::vector<uint8_t> msgType;       // 消息类型
+
+    size_t size() const { return timeMs.size(); }
+    void clear();
+    void reserve(size_t n);
+
+    /**
+     * @brief 截断到前n行
+     */
+    void truncate(size_t n);
+
+    /**
+     * @brief 追加一行
+     */
+    void push(int64_t t, uint32_t id, int32_t lat, int32_t lon, uint16_t sog,
+              uint16_t cog, uint16_t hdg, uint8_t status, uint8_t type);
+
+    /**
+     * @brief 从另一列集拷贝指定行
+     */
+    void pushFrom(const PositionColumns &src, size_t row);
+};
+
+/**
+ * @brief 数据块头信息，用于按时间和空间范围跳过数据块
+ */
+struct ArchiveChunkInfo
+{
+    uint64_t fileOffset = 0;    // 块在文件中的偏移（块头起始）
+    uint32_t recordCount = 0;   // 记录数
+    uint32_t runCount = 0;      // MMSI连续段数
+    int64_t minTimeMs = 0;      // 最早时间
+    int64_t maxTimeMs = 0;      // 最晚时间
+    int32_t minLat = 0;         // 包围盒（定点值）
+    int32_t maxLat = 0;
+    int32_t minLon = 0;
+    int32_t maxLon = 0;
+    uint32_t payloadSize = 0;   // 列数据总长度
+
+    /**
+     * @brief 判断块是否与查询范围相交
+     */
+    bool overlaps(int64_t t0, int64_t t1, double south, double west, double north, double east) const;
+};
+
+/**
+ * @brief 列式归档写入器
+ *
+ * 文件由文件头和若干数据块组成，每块在内存中攒满chunkRecords条后排序压缩写出：
+ * - 记录按(MMSI, 时间)排序，MMSI以连续段(run)形式保存
+ * - 时间在每个run内做二阶差分(delta-of-delta)，ZigZag变长编码
+ * - 经纬度、速度、航向在每个run内做一阶差分，ZigZag变长编码
+ * - 导航状态(4位)、消息类型(5位)定宽位打包
+ */
+class ColumnarArchiveWriter
+{
+public:
+    static constexpr uint32_t FILE_MAGIC = 0x43534941;  // "AISC"
+    static constexpr uint32_t CHUNK_MAGIC = 0x4B4E4843; // "CHNK"
+    static constexpr uint16_t VERSION = 1;
+
+    /**
+     * @brief 构造函数
+     * @param chunkRecords 每块最大记录数
+     */
+    explicit ColumnarArchiveWriter(size_t chunkRecords = 65536);
+    ~ColumnarArchiveWriter();
+
+    /**
+     * @brief 打开归档文件（已存在时先截断不完整的尾块，再追加数据块）
+     * @param path 文件路径
+     * @return 成功返回true
+     */
+    bool open(const std::string &path);
+
+    /**
+     * @brief 写出剩余数据并关闭文件
+     */
+    void close();
+
+    bool isOpen() const { return out_.is_open(); }
+
+    /**
+     * @brief 追加一条消息，仅位置类消息会被记录
+     * @param msg AIS消息
+     * @param timeMs 接收时间（毫秒）
+     * @return 被记录返回true
+     */
+    bool append(const AISMessage &msg, int64_t timeMs);
+
+    /**
+     * @brief 直接追加一行列数据
+     */
+    void appendRow(const PositionColumns &src, size_t row);
+
+    /**
+     * @brief 将当前缓冲写出为一个数据块
+     * @return 成功返回true
+     */
+    bool flush();
+
+    /**
+     * @brief 已写出的块数与记录数
+     */
+    size_t chunksWritten() const { return chunksWritten_; }
+    uint64_t recordsWritten() const { return recordsWritten_; }
+
+private:
+    size_t chunkRecords_;
+    std::ofstream out_;
+    PositionColumns pending_;
+    size_t chunksWritten_ = 0;
+    uint64_t recordsWritten_ = 0;
+};
+
+/**
+ * @brief 列式归档读取器
+ *
+ * 打开时只读取各块头信息，按需解码指定块为列数据
+ */
+class ColumnarArchiveReader
+{
+public:
+    /**
+     * @brief 打开归档文件并加载块索引
+     * @param path 文件路径
+     * @return 成功返回true
+     */
+    bool open(const std::string &path);
+
+    void close();
+
+    const std::vector<ArchiveChunkInfo> &chunks() const { return chunks_; }
+
+    /**
+     * @brief 解码指定数据块，结果追加到out
+     * @param index 块序号
+     * @param out [out] 列数据
+     * @return 成功返回true，失败时out保持不变
+     */
+    bool readChunk(size_t index, PositionColumns &out);
+
+    /**
+     * @brief 按时间和空间范围扫描，跳过不相交的数据块
+     * @param t0 起始时间（毫秒，含）
+     * @param t1 结束时间（毫秒，含）
+     * @param south/west/north/east 包围盒（度）
+     * @param out [out] 满足条件的记录
+     * @return 实际解码的块数
+     */
+    size_t scan(int64_t t0, int64_t t1, double south, double west, double north, double east,
+                PositionColumns &out);
+
+private:
+    std::ifstream in_;
+    std::vector<ArchiveChunkInfo> chunks_;
+    std::string buffer_;
+};
+
+} // namespace ais
+
+#endif // AIS_COLUMNAR_ARCHIVE_H
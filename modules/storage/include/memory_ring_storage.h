@@ -0,0 +1,120 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        memory_ring_storage.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 定长内存环形存储（单写多读，无锁）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        时间范围遍历容忍多线程入队造成的接收时间乱序
+
+*****************************************************************/
+
+#ifndef AIS_MEMORY_RING_STORAGE_H
+#define AIS_MEMORY_RING_STORAGE_H
+
+#include "async_storage.h"
+#include "utils/binary_codec.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace ais
+{
+
+/**
+ * @brief 环形存储中的一条记录（读取时的拷贝）
+ */
+struct MemoryRecord
+{
+    uint64_t index = 0;         // 全局写入序号（从1开始）
+    int64_t timeMs = 0;         // 接收时间
+    uint32_t mmsi = 0;
+    AISMessageType type = AISMessageType::UNKNOWN;
+    uint8_t size = 0;           // BinaryCodec记录长度，0表示该类型无定长格式仅保留索引字段
+    uint8_t data[BinaryCodec::MAX_RECORD_SIZE];
+
+    /**
+     * @brief 解码为完整消息
+     * @return 无记录数据时返回nullptr
+     */
+    std::unique_ptr<AISMessage> decode() const;
+};
+
+/**
+ * @brief 内存环形存储（StorageType::MEMORY）
+ *
+ * 启动时一次性分配memoryRecords个128字节槽位，写满后覆盖最旧记录，运行期间不再申请内存。
+ * 写入方为AsyncStorage的写线程（唯一写者），任意线程可并发调用scan*()读取：
+ * 每个槽位带序列号(seqlock)，读方在序列号为奇数或前后不一致时重试，
+ * 读取过程中被覆盖的槽位会被跳过，读写双方均不加锁。
+ */
+class MemoryRingStorage : public AsyncStorage
+{
+public:
+    using Visitor = std::function<bool(const MemoryRecord &)>;  // 返回false停止遍历
+
+    static constexpr int64_t ORDER_SLACK_MS = 10000;    // 写入顺序与接收时间顺序的最大偏差
+
+    explicit MemoryRingStorage(const AISSaveCfg &cfg);
+    ~MemoryRingStorage() override;
+
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief 已写入的记录总数（含已被覆盖的）
+     */
+    uint64_t totalWritten() const { return head_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 由新到旧遍历时间范围内的记录
+     *
+     * 记录按入队顺序写入，多个处理线程入队时接收时间并不严格单调，
+     * 遇到早于 t0 - ORDER_SLACK_MS 的记录才停止，其间早于t0的记录跳过
+     *
+     * @param t0 起始时间（含）
+     * @param t1 结束时间（含）
+     * @param visitor 回调
+     * @return 访问的记录数
+     */
+    size_t scanTime(int64_t t0, int64_t t1, const Visitor &visitor) const;
+
+    /**
+     * @brief 由新到旧遍历指定MMSI在时间范围内的记录（mmsi为0时等同scanTime）
+     */
+    size_t scanMmsi(uint32_t mmsi, int64_t t0, int64_t t1, const Visitor &visitor) const;
+
+protected:
+    bool openSink() override;
+    bool writeBatch(const std::vector<StorageRecord> &batch) override;
+    void flushSink() override {}
+    void closeSink() override {}
+
+private:
+    static constexpr size_t SLOT_WORDS = 16;    // 128字节
+    static constexpr size_t DATA_WORDS = BinaryCodec::MAX_RECORD_SIZE / 8;
+
+    // 槽位：seq + 序号 + 时间 + (mmsi/type/size) + 记录数据
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<uint64_t> words[SLOT_WORDS - 1];
+    };
+    static_assert(3 + DATA_WORDS <= SLOT_WORDS - 1, "slot too small for binary record");
+
+    void writeSlot(const StorageRecord &record);
+    bool readSlot(uint64_t index, MemoryRecord &out) const;
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> head_{0};     // 已写入记录数
+};
+
+} // namespace ais
+
+#endif // AIS_MEMORY_RING_STORAGE_H
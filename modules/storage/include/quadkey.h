@@ -0,0 +1,99 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        quadkey.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: Bing风格QuadKey瓦片编码（不依赖Qt的整数实现）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        不再依赖非标准的M_PI
+
+*****************************************************************/
+
+#ifndef AIS_QUADKEY_H
+#define AIS_QUADKEY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace ais
+{
+namespace quadkey
+{
+
+constexpr int MAX_LEVEL = 23;
+constexpr double PI = 3.14159265358979323846;
+constexpr double MIN_LATITUDE = -85.05112878;
+constexpr double MAX_LATITUDE = 85.05112878;
+
+/**
+ * @brief 经纬度转瓦片坐标（Web墨卡托，与example中TileForCoord::Bing一致）
+ * @param lon 经度
+ * @param lat 纬度（超出墨卡托范围时截断）
+ * @param level 层级 (1-23)
+ * @param tileX [out] 瓦片X
+ * @param tileY [out] 瓦片Y（向南递增）
+ */
+inline void latLonToTile(double lon, double lat, int level, uint32_t &tileX, uint32_t &tileY)
+{
+    lon = std::min(std::max(lon, -180.0), 180.0);
+    lat = std::min(std::max(lat, MIN_LATITUDE), MAX_LATITUDE);
+
+    const double x = (lon + 180.0) / 360.0;
+    const double sinLat = std::sin(lat * PI / 180.0);
+    const double y = 0.5 - std::log((1.0 + sinLat) / (1.0 - sinLat)) / (4.0 * PI);
+
+    const uint32_t tiles = 1u << level;
+    tileX = static_cast<uint32_t>(std::min(std::max(x * tiles, 0.0), tiles - 1.0));
+    tileY = static_cast<uint32_t>(std::min(std::max(y * tiles, 0.0), tiles - 1.0));
+}
+
+/**
+ * @brief 瓦片坐标转整数QuadKey（X/Y位交错，等价于QuadKey字符串按四进制解释）
+ */
+inline uint64_t tileToKey(uint32_t tileX, uint32_t tileY, int level)
+{
+    uint64_t key = 0;
+    for (int i = level; i > 0; --i) {
+        const uint32_t mask = 1u << (i - 1);
+        key = (key << 2) | ((tileX & mask) ? 1u : 0u) | ((tileY & mask) ? 2u : 0u);
+    }
+    return key;
+}
+
+/**
+ * @brief 整数QuadKey转瓦片坐标
+ */
+inline void keyToTile(uint64_t key, int level, uint32_t &tileX, uint32_t &tileY)
+{
+    tileX = tileY = 0;
+    for (int i = 0; i < level; ++i) {
+        const uint32_t digit = static_cast<uint32_t>(key >> (2 * i)) & 3u;
+        tileX |= (digit & 1u) << i;
+        tileY |= ((digit >> 1) & 1u) << i;
+    }
+}
+
+/**
+ * @brief 整数QuadKey转字符串形式（如"0230102"）
+ */
+inline std::string keyToString(uint64_t key, int level)
+{
+    std::string text(static_cast<size_t>(level), '0');
+    for (int i = level - 1; i >= 0; --i) {
+        text[static_cast<size_t>(i)] = static_cast<char>('0' + (key & 3u));
+        key >>= 2;
+    }
+    return text;
+}
+
+} // namespace quadkey
+} // namespace ais
+
+#endif // AIS_QUADKEY_H
@@ -0,0 +1,92 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        segment_index.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 分段文件sidecar索引的公共部分（倒排列表编码、分段记录读取）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_SEGMENT_INDEX_H
+#define AIS_SEGMENT_INDEX_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 索引中的一条记录位置
+ */
+struct TrackPoint
+{
+    uint64_t offset = 0;        // 记录在分段文件中的字节偏移
+    int64_t timeMs = 0;         // 接收时间
+};
+
+/**
+ * @brief 倒排列表（某个键下的记录位置序列）
+ *
+ * 按写入顺序编码为(偏移增量varint, 时间增量zigzag varint)，同时维护时间范围
+ */
+struct PostingList
+{
+    std::string data;           // 已编码的位置序列
+    uint32_t count = 0;
+    uint64_t lastOffset = 0;
+    int64_t lastTimeMs = 0;
+    int64_t minTimeMs = 0;
+    int64_t maxTimeMs = 0;
+
+    void add(uint64_t offset, int64_t timeMs);
+
+    /**
+     * @brief 解码并筛选时间范围内的位置
+     * @param data 编码数据
+     * @param size 数据长度
+     * @param count 记录数
+     * @param t0 起始时间（含）
+     * @param t1 结束时间（含）
+     * @param out [out] 命中的位置
+     * @return 命中数
+     */
+    static size_t decode(const uint8_t *data, size_t size, uint32_t count,
+                         int64_t t0, int64_t t1, std::vector<TrackPoint> &out);
+};
+
+/**
+ * @brief 分段记录访问回调：记录位置与原始记录（CSV为不含换行的行，二进制为含时间前缀的整帧）
+ */
+using SegmentRecordVisitor = std::function<void(const TrackPoint &, const std::string &)>;
+
+/**
+ * @brief 按偏移读取分段中的记录
+ * @param segmentPath 分段文件路径
+ * @param binary 是否为二进制分段
+ * @param points 记录位置（建议按偏移升序）
+ * @param visitor 回调
+ * @return 成功读取的记录数
+ */
+size_t readSegmentRecords(const std::string &segmentPath, bool binary,
+                          const std::vector<TrackPoint> &points, const SegmentRecordVisitor &visitor);
+
+/**
+ * @brief 列出前缀下带指定sidecar索引的分段文件（按文件名排序）
+ * @param prefix 分段文件路径前缀（即storagePath去扩展名）
+ * @param indexExt 索引扩展名，如".idx"
+ * @return 分段文件路径（不含索引扩展名）
+ */
+std::vector<std::string> listIndexedSegments(const std::string &prefix, const std::string &indexExt);
+
+} // namespace ais
+
+#endif // AIS_SEGMENT_INDEX_H
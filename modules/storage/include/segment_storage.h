@@ -0,0 +1,173 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        segment_storage.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 按大小/时间滚动的分段追加写文件存储
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        增加二进制分段顺序读取器BinarySegmentReader
+3             2026-10-18     cjx        压缩跳过当前分段时按规范化绝对路径比较
+
+*****************************************************************/
+
+#ifndef AIS_SEGMENT_STORAGE_H
+#define AIS_SEGMENT_STORAGE_H
+
+#include "async_storage.h"
+#include "spatial_index.h"
+#include "track_compactor.h"
+#include "track_index.h"
+#include "utils/binary_codec.h"
+#include "utils/csv_writer.h"
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ais
+{
+
+/**
+ * @brief 分段文件信息
+ */
+struct SegmentInfo
+{
+    std::string path;           // 文件路径
+    uint32_t sequence = 0;      // 分段序号（本次运行内递增）
+    uint64_t records = 0;       // 记录数
+    uint64_t bytes = 0;         // 文件大小
+    int64_t firstTimeMs = 0;    // 首条记录接收时间
+    int64_t lastTimeMs = 0;     // 末条记录接收时间
+    int64_t openedMs = 0;       // 分段创建时间
+};
+
+/**
+ * @brief 分段追加写存储（CSV / 二进制）
+ *
+ * 文件名为 <storagePath去扩展名>_<创建时间>_<序号>.<csv|bin>，
+ * 当前分段超过segmentMaxSizeMB或segmentMaxSeconds后封存并新建分段。
+ *
+ * CSV分段：开头为CsvWriter列结构说明，每行为 接收时间毫秒,消息CSV
+ * 二进制分段：8字节文件头(魔数"AISS"、版本、标志bit0=已压缩)，之后每帧为 int64接收时间 + BinaryCodec记录，
+ *            无定长格式的消息类型不写入
+ *
+ * 启用trackIndex时，写入过程中增量记录每条数据的MMSI/偏移/时间，分段封存时
+ * 写出 <分段路径>.idx（见TrackIndexWriter），单船航迹查询只需读取命中的记录；
+ * spatialIndexLevel大于0时同时写出 <分段路径>.qidx（见SpatialIndexWriter），用于区域+时间查询
+ *
+ * 二进制分段且compactAfterHours大于0时，后台压缩线程定期检查封存（最后修改）超过该时长的分段，
+ * 用TrackCompactor按compactToleranceMeters抽稀航迹后原地改写，写入线程不受影响
+ */
+class SegmentStorage : public AsyncStorage
+{
+public:
+    static constexpr uint32_t BINARY_MAGIC = 0x53534941;    // "AISS"
+    static constexpr uint16_t BINARY_VERSION = 1;
+    static constexpr size_t BINARY_HEADER_SIZE = 8;
+    static constexpr int64_t COMPACT_CHECK_INTERVAL_MS = 300000;   // 后台压缩检查周期
+
+    explicit SegmentStorage(const AISSaveCfg &cfg);
+    ~SegmentStorage() override;
+
+    /**
+     * @brief 当前分段文件信息（仅在写线程或停止后访问）
+     */
+    const SegmentInfo &currentSegment() const { return current_; }
+
+    /**
+     * @brief 立即压缩所有满足时长条件的已封存分段（后台压缩线程定期调用）
+     * @return 本次改写的分段数
+     */
+    size_t compactSealedSegments();
+
+protected:
+    bool openSink() override;
+    bool writeBatch(const std::vector<StorageRecord> &batch) override;
+    void flushSink() override;
+    void closeSink() override;
+
+    /**
+     * @brief 分段封存回调（写线程中调用，文件已关闭）
+     * @param info 封存的分段信息
+     */
+    virtual void onSegmentSealed(const SegmentInfo &info) { (void)info; }
+
+private:
+    bool openSegment();
+    void sealSegment();
+    bool needRotate(int64_t timeMs) const;
+    std::string makeSegmentPath(int64_t timeMs) const;
+    void setActivePath(const std::string &path);
+    void runCompaction();
+
+    bool binary_;
+    std::string prefix_;        // 分段文件路径前缀
+    uint64_t maxBytes_;         // 0表示不限制
+    int64_t maxAgeMs_;          // 0表示不限制
+    bool trackIndex_;           // 是否生成航迹索引
+    bool spatialIndex_;         // 是否生成时空索引
+
+    std::ofstream out_;
+    SegmentInfo current_;
+    uint32_t nextSequence_ = 0;
+
+    CsvWriter csvWriter_;
+    TrackIndexWriter indexWriter_;
+    SpatialIndexWriter spatialWriter_;
+    std::string buffer_;        // 组提交缓冲，一批记录一次写出
+
+    // 后台航迹压缩
+    int64_t compactAfterMs_;    // 0表示不压缩
+    TrackCompactor compactor_;
+    std::thread compactThread_;
+    std::mutex compactMutex_;
+    std::condition_variable compactCv_;
+    bool compactStop_ = false;
+    std::string activePath_;    // 正在写入的分段（绝对路径），压缩时跳过（compactMutex_保护）
+};
+
+/**
+ * @brief 二进制分段顺序读取器（逐帧流式读取，不整体加载文件）
+ */
+class BinarySegmentReader
+{
+public:
+    /**
+     * @brief 打开分段并校验文件头
+     * @param path 分段文件路径
+     * @return 是受支持版本的二进制分段时返回true
+     */
+    bool open(const std::string &path);
+
+    void close();
+
+    /**
+     * @brief 读取下一帧
+     * @param timeMs [out] 接收时间
+     * @param record [out] BinaryCodec记录（不含时间前缀），下次调用前有效
+     * @param size [out] 记录长度
+     * @return 读到完整帧返回true；文件结束、尾帧不完整或记录头损坏（无法定位下一帧）时返回false
+     */
+    bool next(int64_t &timeMs, const uint8_t *&record, size_t &size);
+
+    /**
+     * @brief 分段是否已被TrackCompactor抽稀
+     */
+    bool compacted() const { return (flags_ & 1) != 0; }
+
+private:
+    std::ifstream in_;
+    uint16_t flags_ = 0;
+    uint8_t frame_[8 + BinaryCodec::MAX_RECORD_SIZE];
+};
+
+} // namespace ais
+
+#endif // AIS_SEGMENT_STORAGE_H
@@ -0,0 +1,141 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        spatial_index.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 分段文件的时空索引（QuadKey单元格 + 时间范围倒排，sidecar .qidx文件）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_SPATIAL_INDEX_H
+#define AIS_SPATIAL_INDEX_H
+
+#include "segment_index.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 单元格目录项
+ */
+struct SpatialIndexEntry
+{
+    uint64_t cell = 0;          // 整数QuadKey
+    uint32_t count = 0;         // 记录数
+    int64_t minTimeMs = 0;
+    int64_t maxTimeMs = 0;
+    uint32_t dataOffset = 0;    // 位置数据在数据区中的偏移
+    uint32_t dataSize = 0;      // 位置数据长度
+};
+
+/**
+ * @brief 时空索引构建器
+ *
+ * 分段写入时按位置所在QuadKey单元格记录偏移和时间，分段封存时写出 <分段路径>.qidx。
+ *
+ * 文件格式（小端）：
+ * - 文件头32字节：魔数"AISQ"、版本、标志(bit0=二进制分段)、单元格数、层级、最早/最晚时间
+ * - 目录：按QuadKey升序的定长项（见SpatialIndexEntry，36字节）
+ * - 数据区：每个单元格的(偏移增量varint, 时间增量zigzag varint)序列
+ */
+class SpatialIndexWriter
+{
+public:
+    static constexpr uint32_t MAGIC = 0x51534941;   // "AISQ"
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 32;
+    static constexpr size_t ENTRY_SIZE = 36;
+
+    /**
+     * @brief 构造函数
+     * @param level QuadKey层级（12级单元格约10km）
+     */
+    explicit SpatialIndexWriter(int level = 12);
+
+    int level() const { return level_; }
+
+    /**
+     * @brief 记录一条位置数据
+     */
+    void add(double lon, double lat, uint64_t offset, int64_t timeMs);
+
+    /**
+     * @brief 写出索引文件（先写临时文件再重命名）
+     */
+    bool write(const std::string &path, bool binarySegment) const;
+
+    void clear();
+    bool empty() const { return cells_.empty(); }
+
+private:
+    int level_;
+    std::unordered_map<uint64_t, PostingList> cells_;
+};
+
+/**
+ * @brief 时空索引读取器
+ */
+class SpatialIndexReader
+{
+public:
+    bool open(const std::string &path);
+
+    bool binarySegment() const { return binarySegment_; }
+    int level() const { return level_; }
+    int64_t minTimeMs() const { return minTimeMs_; }
+    int64_t maxTimeMs() const { return maxTimeMs_; }
+    const std::vector<SpatialIndexEntry> &entries() const { return entries_; }
+
+    /**
+     * @brief 查询与包围盒相交的单元格中、时间范围内的候选记录
+     *
+     * 结果为单元格粒度的候选集（可能包含盒外但同单元格的点），调用方按精确几何
+     * （如多边形）二次过滤；west > east 表示跨越180度经线
+     *
+     * @param south/west/north/east 包围盒（度）
+     * @param t0 起始时间（含）
+     * @param t1 结束时间（含）
+     * @param out [out] 候选记录位置，按偏移升序
+     * @return 候选数
+     */
+    size_t query(double south, double west, double north, double east,
+                 int64_t t0, int64_t t1, std::vector<TrackPoint> &out) const;
+
+    /**
+     * @brief 跨分段查询区域内的候选记录并读取
+     * @param prefix 分段文件路径前缀
+     * @param visitor 回调：记录位置与原始记录
+     * @return 读取的记录数
+     */
+    static size_t queryArea(const std::string &prefix, double south, double west, double north, double east,
+                            int64_t t0, int64_t t1, const SegmentRecordVisitor &visitor);
+
+private:
+    void collect(uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1,
+                 int64_t t0, int64_t t1, std::vector<TrackPoint> &out) const;
+    void collectEntry(const SpatialIndexEntry &entry, int64_t t0, int64_t t1,
+                      std::vector<TrackPoint> &out) const;
+
+    std::string data_;
+    std::vector<SpatialIndexEntry> entries_;
+    size_t dataStart_ = 0;
+    bool binarySegment_ = false;
+    int level_ = 0;
+    int64_t minTimeMs_ = 0;
+    int64_t maxTimeMs_ = 0;
+};
+
+} // namespace ais
+
+#endif // AIS_SPATIAL_INDEX_H
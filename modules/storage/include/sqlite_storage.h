@@ -0,0 +1,92 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        sqlite_storage.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: SQLite数据库存储后端
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        索引改为在初始批量阶段结束后创建
+
+*****************************************************************/
+
+#ifndef AIS_SQLITE_STORAGE_H
+#define AIS_SQLITE_STORAGE_H
+
+#include "async_storage.h"
+
+#include <cstdint>
+#include <string>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace ais
+{
+
+/**
+ * @brief SQLite存储后端
+ *
+ * 按消息类别写入规范化的表：
+ * - positions:     船舶位置报告 (1/2/3/18/19/27)
+ * - static_data:   静态航次数据 (5) 与B类静态数据 (24)
+ * - base_stations: 基站报告 (4/11)
+ * 其余消息类型不入库。
+ *
+ * 写线程使用预编译语句插入，数据库为WAL模式；事务在累计transactionRows行
+ * 或到达flushIntervalMs落盘周期时提交。数据库尚无(mmsi, time_ms)与time_ms索引时，
+ * 初始批量阶段不建索引以避免维护开销；已写入数据后某个落盘周期内没有新数据（导入结束或数据流空闲）、
+ * 或累计写入达到100万行时创建索引，启动后尚未收到数据的空闲周期不算批量阶段结束；
+ * 之后的插入由SQLite维护索引。停止时仍未建索引则在停止时创建。
+ */
+class SqliteStorage : public AsyncStorage
+{
+public:
+    explicit SqliteStorage(const AISSaveCfg &cfg);
+    ~SqliteStorage() override;
+
+protected:
+    bool openSink() override;
+    bool writeBatch(const std::vector<StorageRecord> &batch) override;
+    void flushSink() override;
+    void closeSink() override;
+
+private:
+    bool exec(const char *sql);
+    bool prepare(const char *sql, sqlite3_stmt **stmt);
+    bool beginTransaction();
+    bool commitTransaction();
+    void createIndexes();
+    bool hasIndexes();
+
+    /**
+     * @brief 释放预编译语句并关闭数据库（不建索引，打开失败时也使用）
+     */
+    void releaseDb();
+
+    bool insertPosition(const AISMessage &msg, int64_t timeMs);
+    bool insertStatic(const AISMessage &msg, int64_t timeMs);
+    bool insertBaseStation(const AISMessage &msg, int64_t timeMs);
+
+    std::string path_;
+    size_t transactionRows_;
+
+    sqlite3 *db_ = nullptr;
+    sqlite3_stmt *insertPosition_ = nullptr;
+    sqlite3_stmt *insertStatic_ = nullptr;
+    sqlite3_stmt *insertBaseStation_ = nullptr;
+
+    bool inTransaction_ = false;
+    size_t pendingRows_ = 0;    // 当前事务内的行数
+    bool indexesBuilt_ = false;
+    uint64_t bulkRows_ = 0;         // 建索引前累计写入的行数
+    size_t rowsSinceFlush_ = 0;     // 上次落盘以来写入的行数
+};
+
+} // namespace ais
+
+#endif // AIS_SQLITE_STORAGE_H
@@ -0,0 +1,100 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        track_compactor.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 已封存二进制分段的航迹压缩（按船时间同步Douglas-Peucker抽稀）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+2             2026-10-18     cjx        分段中间有无法识别的记录时不改写
+
+*****************************************************************/
+
+#ifndef AIS_TRACK_COMPACTOR_H
+#define AIS_TRACK_COMPACTOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 航迹抽稀的输入点
+ */
+struct TrackSample
+{
+    int64_t timeMs = 0;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    bool anchor = false;        // 必须保留的点（首末点、状态变化、长时间间隔两端）
+};
+
+/**
+ * @brief 单个分段的压缩结果
+ */
+struct CompactionResult
+{
+    bool skipped = false;       // 非二进制分段、已压缩过或中间有无法识别的记录，未改写
+    uint64_t recordsBefore = 0;
+    uint64_t recordsAfter = 0;
+    uint64_t bytesBefore = 0;
+    uint64_t bytesAfter = 0;
+};
+
+/**
+ * @brief 分段航迹压缩器
+ *
+ * 读取整个二进制分段，按MMSI抽取船舶位置报告(1/2/3/18/19/27)组成航迹：
+ * - 首末点、导航状态变化前后的点、时间间隔超过MAX_GAP_MS两端的点固定保留
+ * - 相邻固定点之间用时间同步的Douglas-Peucker抽稀：误差取原始点与按时间在两端点间
+ *   线性插值（即匀速推算）位置的距离，小于容差的点删除，保留航迹形状与速度变化
+ * - 静态、基站、助航设备等非位置消息全部保留
+ *
+ * 保留的帧按原顺序写入新分段（文件头标志bit0置为已压缩），并重建.idx/.qidx，
+ * 新文件先写临时文件再依次重命名覆盖。
+ */
+class TrackCompactor
+{
+public:
+    static constexpr uint16_t FLAG_COMPACTED = 0x0001;  // 二进制分段文件头标志：已压缩
+    static constexpr int64_t MAX_GAP_MS = 600000;       // 超过该间隔的相邻点不做插值抽稀
+
+    /**
+     * @brief 构造函数
+     * @param toleranceMeters 抽稀容差（米）
+     * @param trackIndex 是否重建航迹索引(.idx)
+     * @param spatialIndexLevel 时空索引层级（0表示不重建.qidx）
+     */
+    TrackCompactor(double toleranceMeters, bool trackIndex, int spatialIndexLevel);
+
+    /**
+     * @brief 压缩一个已封存的二进制分段
+     * @param path 分段文件路径
+     * @param result [out] 可选，压缩结果
+     * @return 读写失败或分段中间有无法识别的记录（不改写）返回false，压缩成功或跳过返回true
+     */
+    bool compactSegment(const std::string &path, CompactionResult *result = nullptr) const;
+
+    /**
+     * @brief 时间同步Douglas-Peucker抽稀
+     * @param samples 按时间排列的航迹点，anchor标记的点必定保留
+     * @param toleranceMeters 容差（米）
+     * @return 每个点是否保留
+     */
+    static std::vector<bool> simplify(const std::vector<TrackSample> &samples, double toleranceMeters);
+
+private:
+    double toleranceMeters_;
+    bool trackIndex_;
+    int spatialIndexLevel_;
+};
+
+} // namespace ais
+
+#endif // AIS_TRACK_COMPACTOR_H
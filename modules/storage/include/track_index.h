@@ -0,0 +1,143 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        track_index.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 分段文件的按MMSI航迹索引（sidecar .idx文件）
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_TRACK_INDEX_H
+#define AIS_TRACK_INDEX_H
+
+#include "segment_index.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief 单个MMSI的索引目录项
+ */
+struct TrackIndexEntry
+{
+    uint32_t mmsi = 0;
+    uint32_t count = 0;         // 记录数
+    int64_t minTimeMs = 0;
+    int64_t maxTimeMs = 0;
+    uint32_t dataOffset = 0;    // 位置数据在数据区中的偏移
+    uint32_t dataSize = 0;      // 位置数据长度
+};
+
+/**
+ * @brief 航迹索引构建器
+ *
+ * 分段写入时逐条调用add()增量编码，分段封存时write()写出 <分段路径>.idx。
+ *
+ * 文件格式（小端）：
+ * - 文件头32字节：魔数"AISI"、版本、标志(bit0=二进制分段)、目录项数、保留、最早/最晚时间
+ * - 目录：按MMSI升序的定长项（见TrackIndexEntry，32字节），可二分查找
+ * - 数据区：每个MMSI的(偏移增量varint, 时间增量zigzag varint)序列
+ */
+class TrackIndexWriter
+{
+public:
+    static constexpr uint32_t MAGIC = 0x49534941;   // "AISI"
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 32;
+    static constexpr size_t ENTRY_SIZE = 32;
+
+    /**
+     * @brief 记录一条数据的位置
+     */
+    void add(uint32_t mmsi, uint64_t offset, int64_t timeMs);
+
+    /**
+     * @brief 写出索引文件（先写临时文件再重命名，读方不会看到半个索引）
+     * @param path 索引文件路径
+     * @param binarySegment 分段是否为二进制格式
+     * @return 成功返回true
+     */
+    bool write(const std::string &path, bool binarySegment) const;
+
+    void clear();
+    bool empty() const { return tracks_.empty(); }
+
+private:
+    std::unordered_map<uint32_t, PostingList> tracks_;
+};
+
+/**
+ * @brief 航迹索引读取器
+ */
+class TrackIndexReader
+{
+public:
+    /**
+     * @brief 加载索引文件
+     * @param path 索引文件路径
+     * @return 成功返回true
+     */
+    bool open(const std::string &path);
+
+    bool binarySegment() const { return binarySegment_; }
+    int64_t minTimeMs() const { return minTimeMs_; }
+    int64_t maxTimeMs() const { return maxTimeMs_; }
+    const std::vector<TrackIndexEntry> &entries() const { return entries_; }
+
+    /**
+     * @brief 查找MMSI的目录项
+     * @return 不存在时返回nullptr
+     */
+    const TrackIndexEntry *find(uint32_t mmsi) const;
+
+    /**
+     * @brief 查询MMSI在时间范围内的记录位置
+     * @param mmsi 船舶MMSI
+     * @param t0 起始时间（含）
+     * @param t1 结束时间（含）
+     * @param out [out] 记录位置，按写入顺序追加
+     * @return 命中的记录数
+     */
+    size_t lookup(uint32_t mmsi, int64_t t0, int64_t t1, std::vector<TrackPoint> &out) const;
+
+    /**
+     * @brief 列出前缀下所有已建索引的分段文件（按文件名排序）
+     * @param prefix 分段文件路径前缀（即storagePath去扩展名）
+     */
+    static std::vector<std::string> listSegments(const std::string &prefix);
+
+    /**
+     * @brief 跨分段读取单船航迹，只读取命中的记录
+     * @param prefix 分段文件路径前缀
+     * @param mmsi 船舶MMSI
+     * @param t0 起始时间（含）
+     * @param t1 结束时间（含）
+     * @param visitor 回调：记录位置与原始记录（CSV为不含换行的行，二进制为含时间前缀的整帧）
+     * @return 读取的记录数
+     */
+    static size_t readTrack(const std::string &prefix, uint32_t mmsi, int64_t t0, int64_t t1,
+                            const SegmentRecordVisitor &visitor);
+
+private:
+    std::string data_;
+    std::vector<TrackIndexEntry> entries_;
+    size_t dataStart_ = 0;
+    bool binarySegment_ = false;
+    int64_t minTimeMs_ = 0;
+    int64_t maxTimeMs_ = 0;
+};
+
+} // namespace ais
+
+#endif // AIS_TRACK_INDEX_H
@@ -0,0 +1,194 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+SPDX-License-Identifier: MIT
+File:        varint_codec.h
+Version:     1.0
+Author:      cjx
+start date:
+Description: 存储格式使用的变长整数与位打包工具
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-18     cjx        create
+
+*****************************************************************/
+
+#ifndef AIS_VARINT_CODEC_H
+#define AIS_VARINT_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ais
+{
+
+/**
+ * @brief ZigZag编码，将有符号数映射为无符号数（绝对值小的数编码后也小）
+ */
+inline uint64_t zigzagEncode(int64_t v)
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t v)
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+/**
+ * @brief LEB128无符号变长整数写入
+ */
+inline void putVarint(std::string &out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+inline void putSignedVarint(std::string &out, int64_t v)
+{
+    putVarint(out, zigzagEncode(v));
+}
+
+/**
+ * @brief 小端定长整数写入
+ */
+template <class T>
+inline void putFixed(std::string &out, T v)
+{
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>((static_cast<uint64_t>(v) >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * @brief 顺序读取器，越界时抛出std::out_of_range
+ */
+class ByteCursor
+{
+public:
+    ByteCursor(const uint8_t *data, size_t size) : p_(data), end_(data + size) {}
+
+    bool atEnd() const { return p_ >= end_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+
+    uint64_t varint()
+    {
+        uint64_t v = 0;
+        int shift = 0;
+        while (true) {
+            if (p_ >= end_ || shift > 63) {
+                throw std::out_of_range("varint exceeds buffer");
+            }
+            uint8_t b = *p_++;
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) break;
+            shift += 7;
+        }
+        return v;
+    }
+
+    int64_t signedVarint() { return zigzagDecode(varint()); }
+
+    template <class T>
+    T fixed()
+    {
+        if (remaining() < sizeof(T)) {
+            throw std::out_of_range("fixed field exceeds buffer");
+        }
+        uint64_t v = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            v |= static_cast<uint64_t>(p_[i]) << (8 * i);
+        }
+        p_ += sizeof(T);
+        return static_cast<T>(v);
+    }
+
+    const uint8_t *take(size_t n)
+    {
+        if (remaining() < n) {
+            throw std::out_of_range("block exceeds buffer");
+        }
+        const uint8_t *p = p_;
+        p_ += n;
+        return p;
+    }
+
+private:
+    const uint8_t *p_;
+    const uint8_t *end_;
+};
+
+/**
+ * @brief 定宽位打包写入（低位在前）
+ */
+class BitPacker
+{
+public:
+    explicit BitPacker(std::string &out) : out_(out) {}
+    ~BitPacker() { flush(); }
+
+    void put(uint32_t value, int bits)
+    {
+        acc_ |= static_cast<uint64_t>(value & ((1u << bits) - 1)) << used_;
+        used_ += bits;
+        while (used_ >= 8) {
+            out_.push_back(static_cast<char>(acc_ & 0xFF));
+            acc_ >>= 8;
+            used_ -= 8;
+        }
+    }
+
+    void flush()
+    {
+        if (used_ > 0) {
+            out_.push_back(static_cast<char>(acc_ & 0xFF));
+            acc_ = 0;
+            used_ = 0;
+        }
+    }
+
+private:
+    std::string &out_;
+    uint64_t acc_ = 0;
+    int used_ = 0;
+};
+
+/**
+ * @brief 定宽位打包读取
+ */
+class BitUnpacker
+{
+public:
+    BitUnpacker(const uint8_t *data, size_t size) : p_(data), end_(data + size) {}
+
+    uint32_t get(int bits)
+    {
+        while (used_ < bits) {
+            if (p_ >= end_) {
+                throw std::out_of_range("bit-packed column exceeds buffer");
+            }
+            acc_ |= static_cast<uint64_t>(*p_++) << used_;
+            used_ += 8;
+        }
+        uint32_t v = static_cast<uint32_t>(acc_ & ((1u << bits) - 1));
+        acc_ >>= bits;
+        used_ -= bits;
+        return v;
+    }
+
+private:
+    const uint8_t *p_;
+    const uint8_t *end_;
+    uint64_t acc_ = 0;
+    int used_ = 0;
+};
+
+} // namespace ais
+
+#endif // AIS_VARINT_CODEC_H
@@ -0,0 +1,137 @@
+#include "async_storage.h"
+
+#include "logger_define.h"
+
+#include <algorithm>
+
+namespace ais
+{
+
+using namespace std::chrono;
+
+AsyncStorage::AsyncStorage(size_t queueCapacity, int flushIntervalMs, size_t maxBatch)
+    : queue_(queueCapacity > 0 ? queueCapacity : 65536)
+    , flushInterval_(flushIntervalMs > 0 ? flushIntervalMs : 1000)
+    , maxBatch_(maxBatch > 0 ? maxBatch : 4096)
+{
+}
+
+AsyncStorage::~AsyncStorage()
+{
+    if (worker_.joinable()) {
+        LOG_WARNING("AsyncStorage destroyed without stop(), pending records may be lost");
+        running_ = false;
+        worker_.join();
+    }
+}
+
+bool AsyncStorage::start()
+{
+    if (running_) {
+        return true;
+    }
+
+    if (!openSink()) {
+        LOG_ERROR("Failed to open storage sink");
+        return false;
+    }
+
+    running_ = true;
+    worker_ = std::thread(&AsyncStorage::run, this);
+    return true;
+}
+
+void AsyncStorage::stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    StorageStats stats = getStats();
+    LOG_INFO("Storage stopped: written={}, dropped={}, flushes={}",
+             stats.written, stats.dropped, stats.flushes);
+}
+
+bool AsyncStorage::store(std::shared_ptr<const AISMessage> msg, int64_t timeMs)
+{
+    if (!running_.load(std::memory_order_relaxed) || !msg) {
+        return false;
+    }
+
+    if (!queue_.tryPush(StorageRecord{std::move(msg), timeMs})) {
+        // 队列满时丢弃，保证接收线程不被存储拖慢
+        if (dropped_.fetch_add(1, std::memory_order_relaxed) % 10000 == 0) {
+            LOG_WARNING("Storage queue full, dropping records (dropped={})", dropped_.load());
+        }
+        return false;
+    }
+
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+StorageStats AsyncStorage::getStats() const
+{
+    StorageStats stats;
+    stats.enqueued = enqueued_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.written = written_.load(std::memory_order_relaxed);
+    stats.flushes = flushes_.load(std::memory_order_relaxed);
+    stats.queueDepth = queue_.sizeApprox();
+    return stats;
+}
+
+int64_t AsyncStorage::nowMs()
+{
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+void AsyncStorage::run()
+{
+    std::vector<StorageRecord> batch;
+    batch.reserve(maxBatch_);
+
+    // 空闲时的轮询间隔，不超过落盘周期
+    const auto idleWait = std::min<milliseconds>(flushInterval_, milliseconds(10));
+    auto lastFlush = steady_clock::now();
+
+    while (true) {
+        batch.clear();
+        StorageRecord record;
+        while (batch.size() < maxBatch_ && queue_.tryPop(record)) {
+            batch.push_back(std::move(record));
+        }
+
+        if (!batch.empty()) {
+            if (writeBatch(batch)) {
+                written_.fetch_add(batch.size(), std::memory_order_relaxed);
+            } else {
+                LOG_ERROR("Failed to write {} records to storage", batch.size());
+            }
+        }
+
+        auto now = steady_clock::now();
+        if (now - lastFlush >= flushInterval_) {
+            flushSink();
+            flushes_.fetch_add(1, std::memory_order_relaxed);
+            lastFlush = now;
+        }
+
+        if (batch.empty()) {
+            // 停止后需确保队列已取空再退出
+            if (!running_.load()) {
+                break;
+            }
+            std::this_thread::sleep_for(idleWait);
+        }
+    }
+
+    flushSink();
+    flushes_.fetch_add(1, std::memory_order_relaxed);
+    closeSink();
+}
+
+} // namespace ais
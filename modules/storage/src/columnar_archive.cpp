@@ -0,0 +1,539 @@
+#include "columnar_archive.h"
+
+#include "logger_define.h"
+#include "utils/binary_codec.h"
+#include "utils/message_fields.h"
+#include "varint_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+
+namespace ais
+{
+
+namespace
+{
+
+constexpr size_t FILE_HEADER_SIZE = 8;
+constexpr size_t COLUMN_COUNT = 8;  // runs, time, lat, lon, sog, cog, heading, packed
+constexpr size_t CHUNK_HEADER_SIZE = 4 + 4 + 4 + 8 + 8 + 16 + 4 * COLUMN_COUNT + 4;
+
+enum Column
+{
+    COL_RUNS = 0,
+    COL_TIME,
+    COL_LAT,
+    COL_LON,
+    COL_SOG,
+    COL_COG,
+    COL_HEADING,
+    COL_PACKED
+};
+
+// 经度区间相交判断，west > east 表示跨越180度经线
+bool lonOverlaps(int32_t minLon, int32_t maxLon, int32_t west, int32_t east)
+{
+    if (west <= east) {
+        return maxLon >= west && minLon <= east;
+    }
+    return maxLon >= west || minLon <= east;
+}
+
+bool lonInside(int32_t lon, int32_t west, int32_t east)
+{
+    return west <= east ? (lon >= west && lon <= east) : (lon >= west || lon <= east);
+}
+
+} // namespace
+
+/************* PositionColumns *************/
+
+void PositionColumns::clear()
+{
+    timeMs.clear();
+    mmsi.clear();
+    latitude.clear();
+    longitude.clear();
+    speed.clear();
+    course.clear();
+    heading.clear();
+    navStatus.clear();
+    msgType.clear();
+}
+
+void PositionColumns::truncate(size_t n)
+{
+    if (n >= size()) {
+        return;
+    }
+    timeMs.resize(n);
+    mmsi.resize(n);
+    latitude.resize(n);
+    longitude.resize(n);
+    speed.resize(n);
+    course.resize(n);
+    heading.resize(n);
+    navStatus.resize(n);
+    msgType.resize(n);
+}
+
+void PositionColumns::reserve(size_t n)
+{
+    timeMs.reserve(n);
+    mmsi.reserve(n);
+    latitude.reserve(n);
+    longitude.reserve(n);
+    speed.reserve(n);
+    course.reserve(n);
+    heading.reserve(n);
+    navStatus.reserve(n);
+    msgType.reserve(n);
+}
+
+void PositionColumns::push(int64_t t, uint32_t id, int32_t lat, int32_t lon, uint16_t sog,
+                           uint16_t cog, uint16_t hdg, uint8_t status, uint8_t type)
+{
+    timeMs.push_back(t);
+    mmsi.push_back(id);
+    latitude.push_back(lat);
+    longitude.push_back(lon);
+    speed.push_back(sog);
+    course.push_back(cog);
+    heading.push_back(hdg);
+    navStatus.push_back(status);
+    msgType.push_back(type);
+}
+
+void PositionColumns::pushFrom(const PositionColumns &src, size_t row)
+{
+    push(src.timeMs[row], src.mmsi[row], src.latitude[row], src.longitude[row], src.speed[row],
+         src.course[row], src.heading[row], src.navStatus[row], src.msgType[row]);
+}
+
+/************* ArchiveChunkInfo *************/
+
+bool ArchiveChunkInfo::overlaps(int64_t t0, int64_t t1, double south, double west,
+                                double north, double east) const
+{
+    if (maxTimeMs < t0 || minTimeMs > t1) {
+        return false;
+    }
+    if (maxLat < BinaryCodec::encodeCoord(south) || minLat > BinaryCodec::encodeCoord(north)) {
+        return false;
+    }
+    return lonOverlaps(minLon, maxLon, BinaryCodec::encodeCoord(west), BinaryCodec::encodeCoord(east));
+}
+
+/************* ColumnarArchiveWriter *************/
+
+ColumnarArchiveWriter::ColumnarArchiveWriter(size_t chunkRecords)
+    : chunkRecords_(chunkRecords > 0 ? chunkRecords : 65536)
+{
+    pending_.reserve(chunkRecords_);
+}
+
+ColumnarArchiveWriter::~ColumnarArchiveWriter()
+{
+    close();
+}
+
+bool ColumnarArchiveWriter::open(const std::string &path)
+{
+    close();
+
+    std::ifstream probe(path, std::ios::binary | std::ios::ate);
+    const uint64_t fileSize = probe.is_open() ? static_cast<uint64_t>(probe.tellg()) : 0;
+    // 文件头本身不完整时按新文件重写
+    const bool exists = fileSize >= FILE_HEADER_SIZE;
+    probe.close();
+
+    if (!exists && fileSize > 0) {
+        std::error_code ec;
+        std::filesystem::resize_file(path, 0, ec);
+    }
+
+    // 异常退出后文件尾部可能有不完整的块，读取方在第一个无效块处停止扫描，
+    // 追加前截断到最后一个完整块的末尾，否则之后追加的块都无法读取
+    if (exists) {
+        ColumnarArchiveReader reader;
+        if (!reader.open(path)) {
+            LOG_ERROR("Columnar archive has an invalid header, not appending: {}", path);
+            return false;
+        }
+        uint64_t validEnd = FILE_HEADER_SIZE;
+        if (!reader.chunks().empty()) {
+            const ArchiveChunkInfo &last = reader.chunks().back();
+            validEnd = last.fileOffset + CHUNK_HEADER_SIZE + last.payloadSize;
+        }
+        reader.close();
+
+        if (validEnd < fileSize) {
+            std::error_code ec;
+            std::filesystem::resize_file(path, validEnd, ec);
+            if (ec) {
+                LOG_ERROR("Failed to truncate torn chunk of {}: {}", path, ec.message());
+                return false;
+            }
+            LOG_WARNING("Truncated torn chunk of columnar archive {}: {} -> {} bytes", path, fileSize, validEnd);
+        }
+    }
+
+    out_.open(path, std::ios::binary | std::ios::app);
+    if (!out_.is_open()) {
+        return false;
+    }
+
+    if (!exists) {
+        std::string header;
+        putFixed<uint32_t>(header, FILE_MAGIC);
+        putFixed<uint16_t>(header, VERSION);
+        putFixed<uint16_t>(header, 0);
+        out_.write(header.data(), header.size());
+    }
+    return out_.good();
+}
+
+void ColumnarArchiveWriter::close()
+{
+    if (out_.is_open()) {
+        flush();
+        out_.close();
+    }
+}
+
+bool ColumnarArchiveWriter::append(const AISMessage &msg, int64_t timeMs)
+{
+    PositionFields pos;
+    if (!isVesselPositionType(msg.type) || !extractPosition(msg, pos)) {
+        return false;
+    }
+
+    pending_.push(timeMs, msg.mmsi,
+                  BinaryCodec::encodeCoord(pos.latitude),
+                  BinaryCodec::encodeCoord(pos.longitude),
+                  static_cast<uint16_t>(std::lround(pos.speedOverGround * 10.0)),
+                  static_cast<uint16_t>(std::lround(pos.courseOverGround * 10.0)),
+                  static_cast<uint16_t>(pos.trueHeading),
+                  static_cast<uint8_t>(pos.navigationStatus & 0xF),
+                  static_cast<uint8_t>(msg.type));
+
+    if (pending_.size() >= chunkRecords_) {
+        flush();
+    }
+    return true;
+}
+
+void ColumnarArchiveWriter::appendRow(const PositionColumns &src, size_t row)
+{
+    pending_.pushFrom(src, row);
+    if (pending_.size() >= chunkRecords_) {
+        flush();
+    }
+}
+
+bool ColumnarArchiveWriter::flush()
+{
+    const size_t n = pending_.size();
+    if (n == 0 || !out_.is_open()) {
+        return out_.is_open();
+    }
+
+    // 按(MMSI, 时间)排序，使同一船舶的记录相邻以便差分
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        if (pending_.mmsi[a] != pending_.mmsi[b]) return pending_.mmsi[a] < pending_.mmsi[b];
+        return pending_.timeMs[a] < pending_.timeMs[b];
+    });
+
+    ArchiveChunkInfo info;
+    info.recordCount = static_cast<uint32_t>(n);
+    info.minTimeMs = *std::min_element(pending_.timeMs.begin(), pending_.timeMs.end());
+    info.maxTimeMs = *std::max_element(pending_.timeMs.begin(), pending_.timeMs.end());
+    info.minLat = *std::min_element(pending_.latitude.begin(), pending_.latitude.end());
+    info.maxLat = *std::max_element(pending_.latitude.begin(), pending_.latitude.end());
+    info.minLon = *std::min_element(pending_.longitude.begin(), pending_.longitude.end());
+    info.maxLon = *std::max_element(pending_.longitude.begin(), pending_.longitude.end());
+
+    std::string cols[COLUMN_COUNT];
+    {
+        BitPacker packed(cols[COL_PACKED]);
+        uint32_t prevMmsi = 0;
+        size_t i = 0;
+        while (i < n) {
+            // 一个MMSI连续段
+            const uint32_t id = pending_.mmsi[order[i]];
+            size_t end = i;
+            while (end < n && pending_.mmsi[order[end]] == id) ++end;
+
+            putVarint(cols[COL_RUNS], id - prevMmsi);
+            putVarint(cols[COL_RUNS], end - i);
+            prevMmsi = id;
+            info.runCount++;
+
+            int64_t prevTime = 0, prevDelta = 0;
+            int64_t prevLat = 0, prevLon = 0, prevSog = 0, prevCog = 0, prevHdg = 0;
+            for (size_t k = i; k < end; ++k) {
+                const uint32_t r = order[k];
+                const int64_t t = pending_.timeMs[r];
+                if (k == i) {
+                    putVarint(cols[COL_TIME], static_cast<uint64_t>(t - info.minTimeMs));
+                } else if (k == i + 1) {
+                    prevDelta = t - prevTime;
+                    putSignedVarint(cols[COL_TIME], prevDelta);
+                } else {
+                    const int64_t delta = t - prevTime;
+                    putSignedVarint(cols[COL_TIME], delta - prevDelta);
+                    prevDelta = delta;
+                }
+                prevTime = t;
+
+                putSignedVarint(cols[COL_LAT], pending_.latitude[r] - prevLat);
+                putSignedVarint(cols[COL_LON], pending_.longitude[r] - prevLon);
+                putSignedVarint(cols[COL_SOG], pending_.speed[r] - prevSog);
+                putSignedVarint(cols[COL_COG], pending_.course[r] - prevCog);
+                putSignedVarint(cols[COL_HEADING], pending_.heading[r] - prevHdg);
+                prevLat = pending_.latitude[r];
+                prevLon = pending_.longitude[r];
+                prevSog = pending_.speed[r];
+                prevCog = pending_.course[r];
+                prevHdg = pending_.heading[r];
+
+                packed.put(pending_.navStatus[r], 4);
+                packed.put(pending_.msgType[r], 5);
+            }
+            i = end;
+        }
+    }
+
+    std::string header;
+    header.reserve(CHUNK_HEADER_SIZE);
+    putFixed<uint32_t>(header, CHUNK_MAGIC);
+    putFixed<uint32_t>(header, info.recordCount);
+    putFixed<uint32_t>(header, info.runCount);
+    putFixed<int64_t>(header, info.minTimeMs);
+    putFixed<int64_t>(header, info.maxTimeMs);
+    putFixed<int32_t>(header, info.minLat);
+    putFixed<int32_t>(header, info.maxLat);
+    putFixed<int32_t>(header, info.minLon);
+    putFixed<int32_t>(header, info.maxLon);
+    uint32_t payloadSize = 0;
+    for (const auto &col : cols) {
+        putFixed<uint32_t>(header, static_cast<uint32_t>(col.size()));
+        payloadSize += static_cast<uint32_t>(col.size());
+    }
+    putFixed<uint32_t>(header, payloadSize);
+
+    out_.write(header.data(), header.size());
+    for (const auto &col : cols) {
+        out_.write(col.data(), col.size());
+    }
+    out_.flush();
+
+    chunksWritten_++;
+    recordsWritten_ += n;
+    pending_.clear();
+    return out_.good();
+}
+
+/************* ColumnarArchiveReader *************/
+
+bool ColumnarArchiveReader::open(const std::string &path)
+{
+    close();
+    in_.open(path, std::ios::binary);
+    if (!in_.is_open()) {
+        return false;
+    }
+
+    uint8_t fileHeader[FILE_HEADER_SIZE];
+    if (!in_.read(reinterpret_cast<char *>(fileHeader), sizeof(fileHeader))) {
+        return false;
+    }
+    ByteCursor fh(fileHeader, sizeof(fileHeader));
+    if (fh.fixed<uint32_t>() != ColumnarArchiveWriter::FILE_MAGIC ||
+        fh.fixed<uint16_t>() > ColumnarArchiveWriter::VERSION) {
+        return false;
+    }
+
+    // 逐块读取块头，遇到不完整的尾块即停止
+    uint8_t raw[CHUNK_HEADER_SIZE];
+    while (true) {
+        const uint64_t offset = static_cast<uint64_t>(in_.tellg());
+        if (!in_.read(reinterpret_cast<char *>(raw), sizeof(raw))) {
+            break;
+        }
+        ByteCursor c(raw, sizeof(raw));
+        if (c.fixed<uint32_t>() != ColumnarArchiveWriter::CHUNK_MAGIC) {
+            break;
+        }
+
+        ArchiveChunkInfo info;
+        info.fileOffset = offset;
+        info.recordCount = c.fixed<uint32_t>();
+        info.runCount = c.fixed<uint32_t>();
+        info.minTimeMs = c.fixed<int64_t>();
+        info.maxTimeMs = c.fixed<int64_t>();
+        info.minLat = c.fixed<int32_t>();
+        info.maxLat = c.fixed<int32_t>();
+        info.minLon = c.fixed<int32_t>();
+        info.maxLon = c.fixed<int32_t>();
+        for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+            c.fixed<uint32_t>();
+        }
+        info.payloadSize = c.fixed<uint32_t>();
+
+        in_.seekg(info.payloadSize, std::ios::cur);
+        if (!in_.good()) {
+            break;
+        }
+        chunks_.push_back(info);
+    }
+
+    // 校验最后一块数据是否完整
+    in_.clear();
+    in_.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(in_.tellg());
+    while (!chunks_.empty() &&
+           chunks_.back().fileOffset + CHUNK_HEADER_SIZE + chunks_.back().payloadSize > fileSize) {
+        chunks_.pop_back();
+    }
+    return true;
+}
+
+void ColumnarArchiveReader::close()
+{
+    if (in_.is_open()) {
+        in_.close();
+    }
+    in_.clear();
+    chunks_.clear();
+}
+
+bool ColumnarArchiveReader::readChunk(size_t index, PositionColumns &out)
+{
+    if (index >= chunks_.size()) {
+        return false;
+    }
+    const ArchiveChunkInfo &info = chunks_[index];
+
+    // 重新读取列长度
+    uint8_t raw[CHUNK_HEADER_SIZE];
+    in_.clear();
+    in_.seekg(static_cast<std::streamoff>(info.fileOffset));
+    if (!in_.read(reinterpret_cast<char *>(raw), sizeof(raw))) {
+        return false;
+    }
+    uint32_t sizes[COLUMN_COUNT];
+    {
+        ByteCursor c(raw + CHUNK_HEADER_SIZE - 4 * (COLUMN_COUNT + 1), 4 * COLUMN_COUNT);
+        for (auto &size : sizes) {
+            size = c.fixed<uint32_t>();
+        }
+    }
+
+    buffer_.resize(info.payloadSize);
+    if (!in_.read(&buffer_[0], info.payloadSize)) {
+        return false;
+    }
+
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(buffer_.data());
+    const uint8_t *colStart[COLUMN_COUNT];
+    size_t offset = 0;
+    for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+        colStart[i] = base + offset;
+        offset += sizes[i];
+    }
+    if (offset != info.payloadSize) {
+        return false;
+    }
+
+    // 列数据损坏时撤销本块已追加的行，调用方不会拿到半块数据
+    const size_t before = out.size();
+    try {
+        ByteCursor runs(colStart[COL_RUNS], sizes[COL_RUNS]);
+        ByteCursor time(colStart[COL_TIME], sizes[COL_TIME]);
+        ByteCursor lat(colStart[COL_LAT], sizes[COL_LAT]);
+        ByteCursor lon(colStart[COL_LON], sizes[COL_LON]);
+        ByteCursor sog(colStart[COL_SOG], sizes[COL_SOG]);
+        ByteCursor cog(colStart[COL_COG], sizes[COL_COG]);
+        ByteCursor hdg(colStart[COL_HEADING], sizes[COL_HEADING]);
+        BitUnpacker packed(colStart[COL_PACKED], sizes[COL_PACKED]);
+
+        out.reserve(out.size() + info.recordCount);
+        uint32_t id = 0;
+        for (uint32_t run = 0; run < info.runCount; ++run) {
+            id += static_cast<uint32_t>(runs.varint());
+            const uint64_t count = runs.varint();
+
+            int64_t t = 0, delta = 0;
+            int64_t la = 0, lo = 0, s = 0, co = 0, h = 0;
+            for (uint64_t k = 0; k < count; ++k) {
+                if (k == 0) {
+                    t = info.minTimeMs + static_cast<int64_t>(time.varint());
+                } else if (k == 1) {
+                    delta = time.signedVarint();
+                    t += delta;
+                } else {
+                    delta += time.signedVarint();
+                    t += delta;
+                }
+                la += lat.signedVarint();
+                lo += lon.signedVarint();
+                s += sog.signedVarint();
+                co += cog.signedVarint();
+                h += hdg.signedVarint();
+                const uint8_t status = static_cast<uint8_t>(packed.get(4));
+                const uint8_t type = static_cast<uint8_t>(packed.get(5));
+
+                out.push(t, id, static_cast<int32_t>(la), static_cast<int32_t>(lo),
+                         static_cast<uint16_t>(s), static_cast<uint16_t>(co),
+                         static_cast<uint16_t>(h), status, type);
+            }
+        }
+    } catch (const std::out_of_range &) {
+        out.truncate(before);
+        return false;
+    }
+    if (out.size() - before != info.recordCount) {
+        out.truncate(before);
+        return false;
+    }
+    return true;
+}
+
+size_t ColumnarArchiveReader::scan(int64_t t0, int64_t t1, double south, double west,
+                                   double north, double east, PositionColumns &out)
+{
+    const int32_t s = BinaryCodec::encodeCoord(south);
+    const int32_t n = BinaryCodec::encodeCoord(north);
+    const int32_t w = BinaryCodec::encodeCoord(west);
+    const int32_t e = BinaryCodec::encodeCoord(east);
+
+    size_t decoded = 0;
+    PositionColumns chunk;
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        if (!chunks_[i].overlaps(t0, t1, south, west, north, east)) {
+            continue;
+        }
+
+        chunk.clear();
+        if (!readChunk(i, chunk)) {
+            continue;
+        }
+        decoded++;
+
+        for (size_t row = 0; row < chunk.size(); ++row) {
+            if (chunk.timeMs[row] < t0 || chunk.timeMs[row] > t1) continue;
+            if (chunk.latitude[row] < s || chunk.latitude[row] > n) continue;
+            if (!lonInside(chunk.longitude[row], w, e)) continue;
+            out.pushFrom(chunk, row);
+        }
+    }
+    return decoded;
+}
+
+} // namespace ais
@@ -0,0 +1,149 @@
+#include "memory_ring_storage.h"
+
+#include "logger_define.h"
+
+#include <cstring>
+
+namespace ais
+{
+
+std::unique_ptr<AISMessage> MemoryRecord::decode() const
+{
+    if (size == 0) {
+        return nullptr;
+    }
+    return BinaryCodec::deserialize(data, size, nullptr);
+}
+
+MemoryRingStorage::MemoryRingStorage(const AISSaveCfg &cfg)
+    : AsyncStorage(static_cast<size_t>(cfg.queueCapacity > 0 ? cfg.queueCapacity : 0), cfg.flushIntervalMs)
+    , capacity_(cfg.memoryRecords > 0 ? static_cast<size_t>(cfg.memoryRecords) : 262144)
+{
+}
+
+MemoryRingStorage::~MemoryRingStorage()
+{
+    stop();
+}
+
+bool MemoryRingStorage::openSink()
+{
+    if (!slots_) {
+        slots_.reset(new Slot[capacity_]);
+        for (size_t i = 0; i < capacity_; ++i) {
+            for (auto &word : slots_[i].words) {
+                word.store(0, std::memory_order_relaxed);
+            }
+        }
+        LOG_INFO("Memory ring storage allocated: {} slots, {} MB",
+                 capacity_, (capacity_ * sizeof(Slot)) >> 20);
+    }
+    return true;
+}
+
+bool MemoryRingStorage::writeBatch(const std::vector<StorageRecord> &batch)
+{
+    for (const auto &record : batch) {
+        writeSlot(record);
+    }
+    return true;
+}
+
+void MemoryRingStorage::writeSlot(const StorageRecord &record)
+{
+    const uint64_t index = head_.load(std::memory_order_relaxed) + 1;
+    Slot &slot = slots_[(index - 1) % capacity_];
+
+    uint8_t buffer[DATA_WORDS * 8] = {0};
+    const size_t size = BinaryCodec::serialize(*record.msg, buffer, sizeof(buffer));
+
+    // 奇数序列号表示写入中
+    const uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.words[0].store(index, std::memory_order_relaxed);
+    slot.words[1].store(static_cast<uint64_t>(record.timeMs), std::memory_order_relaxed);
+    slot.words[2].store(static_cast<uint64_t>(record.msg->mmsi) |
+                        (static_cast<uint64_t>(static_cast<uint8_t>(record.msg->type)) << 32) |
+                        (static_cast<uint64_t>(size) << 40),
+                        std::memory_order_relaxed);
+    for (size_t i = 0; i < DATA_WORDS; ++i) {
+        uint64_t word;
+        std::memcpy(&word, buffer + i * 8, 8);
+        slot.words[3 + i].store(word, std::memory_order_relaxed);
+    }
+
+    slot.seq.store(seq + 2, std::memory_order_release);
+    head_.store(index, std::memory_order_release);
+}
+
+bool MemoryRingStorage::readSlot(uint64_t index, MemoryRecord &out) const
+{
+    const Slot &slot = slots_[(index - 1) % capacity_];
+    uint64_t words[3 + DATA_WORDS];
+
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        const uint64_t seq1 = slot.seq.load(std::memory_order_acquire);
+        if (seq1 & 1) {
+            continue;
+        }
+        for (size_t i = 0; i < 3 + DATA_WORDS; ++i) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != seq1) {
+            continue;
+        }
+
+        // 槽位已被更新的记录覆盖
+        if (words[0] != index) {
+            return false;
+        }
+        out.index = index;
+        out.timeMs = static_cast<int64_t>(words[1]);
+        out.mmsi = static_cast<uint32_t>(words[2]);
+        out.type = static_cast<AISMessageType>((words[2] >> 32) & 0xFF);
+        out.size = static_cast<uint8_t>((words[2] >> 40) & 0xFF);
+        std::memcpy(out.data, &words[3], sizeof(out.data));
+        return true;
+    }
+    return false;
+}
+
+size_t MemoryRingStorage::scanTime(int64_t t0, int64_t t1, const Visitor &visitor) const
+{
+    return scanMmsi(0, t0, t1, visitor);
+}
+
+size_t MemoryRingStorage::scanMmsi(uint32_t mmsi, int64_t t0, int64_t t1, const Visitor &visitor) const
+{
+    if (!slots_) {
+        return 0;
+    }
+
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t oldest = head > capacity_ ? head - capacity_ + 1 : 1;
+
+    // 多个处理线程入队的记录接收时间不严格单调，越过t0后继续读取一个容差范围
+    const int64_t stopMs = t0 - ORDER_SLACK_MS;
+
+    size_t visited = 0;
+    MemoryRecord record;
+    for (uint64_t index = head; index >= oldest && index > 0; --index) {
+        // 由新到旧读取，某槽位已被覆盖说明更旧的也已被覆盖
+        if (!readSlot(index, record) || record.timeMs < stopMs) {
+            break;
+        }
+        if (record.timeMs < t0 || record.timeMs > t1 || (mmsi != 0 && record.mmsi != mmsi)) {
+            continue;
+        }
+        visited++;
+        if (!visitor(record)) {
+            break;
+        }
+    }
+    return visited;
+}
+
+} // namespace ais
@@ -0,0 +1,112 @@
+#include "segment_index.h"
+
+#include "utils/binary_codec.h"
+#include "varint_codec.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace ais
+{
+
+namespace fs = std::filesystem;
+
+void PostingList::add(uint64_t offset, int64_t timeMs)
+{
+    if (count == 0) {
+        minTimeMs = maxTimeMs = timeMs;
+    }
+
+    putVarint(data, offset - lastOffset);
+    putSignedVarint(data, timeMs - lastTimeMs);
+    lastOffset = offset;
+    lastTimeMs = timeMs;
+    minTimeMs = std::min(minTimeMs, timeMs);
+    maxTimeMs = std::max(maxTimeMs, timeMs);
+    count++;
+}
+
+size_t PostingList::decode(const uint8_t *data, size_t size, uint32_t count,
+                           int64_t t0, int64_t t1, std::vector<TrackPoint> &out)
+{
+    ByteCursor c(data, size);
+    size_t hits = 0;
+    TrackPoint point;
+    try {
+        for (uint32_t i = 0; i < count; ++i) {
+            point.offset += c.varint();
+            point.timeMs += c.signedVarint();
+            if (point.timeMs >= t0 && point.timeMs <= t1) {
+                out.push_back(point);
+                hits++;
+            }
+        }
+    } catch (const std::out_of_range &) {
+        // 索引损坏时返回已解出的部分
+    }
+    return hits;
+}
+
+size_t readSegmentRecords(const std::string &segmentPath, bool binary,
+                          const std::vector<TrackPoint> &points, const SegmentRecordVisitor &visitor)
+{
+    std::ifstream in(segmentPath, std::ios::binary);
+    if (!in.is_open()) {
+        return 0;
+    }
+
+    size_t total = 0;
+    std::string raw;
+    for (const auto &point : points) {
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(point.offset));
+        if (binary) {
+            // 帧 = int64时间 + BinaryCodec记录（长度由记录头中的族决定）
+            uint8_t head[8 + BinaryCodec::HEADER_SIZE];
+            if (!in.read(reinterpret_cast<char *>(head), sizeof(head))) {
+                continue;
+            }
+            size_t size = BinaryCodec::recordSize(static_cast<BinaryRecordFamily>(head[8 + 2]));
+            if (size < BinaryCodec::HEADER_SIZE) {
+                continue;
+            }
+            raw.assign(reinterpret_cast<const char *>(head), sizeof(head));
+            raw.resize(8 + size);
+            if (!in.read(&raw[sizeof(head)], raw.size() - sizeof(head))) {
+                continue;
+            }
+        } else if (!std::getline(in, raw)) {
+            continue;
+        }
+
+        visitor(point, raw);
+        total++;
+    }
+    return total;
+}
+
+std::vector<std::string> listIndexedSegments(const std::string &prefix, const std::string &indexExt)
+{
+    std::vector<std::string> segments;
+
+    fs::path base(prefix);
+    fs::path dir = base.parent_path().empty() ? fs::path(".") : base.parent_path();
+    const std::string stem = base.filename().string() + "_";
+    const size_t extSize = indexExt.size();
+
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() > stem.size() + extSize && name.compare(0, stem.size(), stem) == 0 &&
+            name.compare(name.size() - extSize, extSize, indexExt) == 0) {
+            std::string segment = it->path().string();
+            segment.resize(segment.size() - extSize);
+            segments.push_back(std::move(segment));
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+} // namespace ais
@@ -0,0 +1,354 @@
+#include "segment_storage.h"
+
+#include "logger_define.h"
+#include "utils/binary_codec.h"
+#include "utils/message_fields.h"
+#include "varint_codec.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+
+namespace ais
+{
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/**
+ * @brief 规范化为绝对路径，使"./a_1.bin"与"a_1.bin"可直接比较
+ */
+std::string normalizePath(const std::string &path)
+{
+    if (path.empty()) {
+        return path;
+    }
+    std::error_code ec;
+    const fs::path absolute = fs::absolute(path, ec);
+    return (ec ? fs::path(path) : absolute).lexically_normal().string();
+}
+
+} // namespace
+
+SegmentStorage::SegmentStorage(const AISSaveCfg &cfg)
+    : AsyncStorage(static_cast<size_t>(cfg.queueCapacity > 0 ? cfg.queueCapacity : 0), cfg.flushIntervalMs)
+    , binary_(cfg.storageType == StorageType::BINARY)
+    , maxBytes_(cfg.segmentMaxSizeMB > 0 ? static_cast<uint64_t>(cfg.segmentMaxSizeMB) << 20 : 0)
+    , maxAgeMs_(cfg.segmentMaxSeconds > 0 ? static_cast<int64_t>(cfg.segmentMaxSeconds) * 1000 : 0)
+    , trackIndex_(cfg.trackIndex)
+    , spatialIndex_(cfg.spatialIndexLevel > 0)
+    , spatialWriter_(cfg.spatialIndexLevel)
+    , compactAfterMs_(cfg.compactAfterHours > 0 ? static_cast<int64_t>(cfg.compactAfterHours) * 3600000 : 0)
+    , compactor_(cfg.compactToleranceMeters, cfg.trackIndex, cfg.spatialIndexLevel)
+{
+    fs::path path(cfg.storagePath.empty() ? "ais_data" : cfg.storagePath);
+    prefix_ = (path.parent_path() / path.stem()).string();
+}
+
+SegmentStorage::~SegmentStorage()
+{
+    stop();
+}
+
+bool SegmentStorage::openSink()
+{
+    // 分段文件在收到首条记录时才创建，这里只准备目录
+    fs::path dir = fs::path(prefix_).parent_path();
+    if (!dir.empty()) {
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        if (ec) {
+            LOG_ERROR("Failed to create storage directory {}: {}", dir.string(), ec.message());
+            return false;
+        }
+    }
+
+    if (binary_ && compactAfterMs_ > 0 && !compactThread_.joinable()) {
+        compactStop_ = false;
+        compactThread_ = std::thread(&SegmentStorage::runCompaction, this);
+    }
+    return true;
+}
+
+bool SegmentStorage::writeBatch(const std::vector<StorageRecord> &batch)
+{
+    buffer_.clear();
+
+    for (const auto &record : batch) {
+        if (out_.is_open() && needRotate(record.timeMs)) {
+            out_.write(buffer_.data(), buffer_.size());
+            buffer_.clear();
+            sealSegment();
+        }
+        if (!out_.is_open() && !openSegment()) {
+            return false;
+        }
+
+        const size_t before = buffer_.size();
+        if (binary_) {
+            putFixed<int64_t>(buffer_, record.timeMs);
+            if (!BinaryCodec::serialize(*record.msg, buffer_)) {
+                // 无定长记录格式的消息类型不落盘
+                buffer_.resize(before);
+                continue;
+            }
+        } else {
+            char digits[24];
+            auto res = std::to_chars(digits, digits + sizeof(digits), record.timeMs);
+            buffer_.append(digits, res.ptr);
+            buffer_ += ',';
+            csvWriter_.append(*record.msg, buffer_);
+            buffer_ += '\n';
+        }
+
+        if (trackIndex_) {
+            // current_.bytes即本条记录在文件中的起始偏移
+            indexWriter_.add(record.msg->mmsi, current_.bytes, record.timeMs);
+        }
+        if (spatialIndex_) {
+            PositionFields pos;
+            if (extractPosition(*record.msg, pos)) {
+                spatialWriter_.add(pos.longitude, pos.latitude, current_.bytes, record.timeMs);
+            }
+        }
+        if (current_.records == 0) {
+            current_.firstTimeMs = record.timeMs;
+        }
+        current_.lastTimeMs = record.timeMs;
+        current_.records++;
+        current_.bytes += buffer_.size() - before;
+    }
+
+    out_.write(buffer_.data(), buffer_.size());
+    return out_.good();
+}
+
+void SegmentStorage::flushSink()
+{
+    if (!out_.is_open()) {
+        return;
+    }
+    out_.flush();
+
+    // 无新数据时也按时间封存分段
+    if (needRotate(nowMs())) {
+        sealSegment();
+    }
+}
+
+void SegmentStorage::closeSink()
+{
+    if (out_.is_open()) {
+        sealSegment();
+    }
+
+    if (compactThread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(compactMutex_);
+            compactStop_ = true;
+        }
+        compactCv_.notify_all();
+        compactThread_.join();
+    }
+}
+
+bool SegmentStorage::openSegment()
+{
+    const int64_t now = nowMs();
+
+    current_ = SegmentInfo();
+    current_.path = makeSegmentPath(now);
+    while (fs::exists(current_.path)) {
+        // 同一秒内重启时避免覆盖已有分段
+        nextSequence_++;
+        current_.path = makeSegmentPath(now);
+    }
+    current_.sequence = nextSequence_++;
+    current_.openedMs = now;
+
+    out_.open(current_.path, std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) {
+        LOG_ERROR("Failed to open storage segment: {}", current_.path);
+        return false;
+    }
+
+    std::string header;
+    if (binary_) {
+        putFixed<uint32_t>(header, BINARY_MAGIC);
+        putFixed<uint16_t>(header, BINARY_VERSION);
+        putFixed<uint16_t>(header, 0);
+    } else {
+        header = csvWriter_.schemaPreamble();
+        header += "#prefix,receiveTimeMs\n";
+    }
+    out_.write(header.data(), header.size());
+    current_.bytes = header.size();
+
+    setActivePath(current_.path);
+    LOG_INFO("Opened storage segment: {}", current_.path);
+    return out_.good();
+}
+
+void SegmentStorage::sealSegment()
+{
+    out_.flush();
+    out_.close();
+    setActivePath(std::string());
+
+    if (trackIndex_) {
+        if (!indexWriter_.write(current_.path + ".idx", binary_)) {
+            LOG_ERROR("Failed to write track index for segment: {}", current_.path);
+        }
+        indexWriter_.clear();
+    }
+    if (spatialIndex_) {
+        if (!spatialWriter_.write(current_.path + ".qidx", binary_)) {
+            LOG_ERROR("Failed to write spatial index for segment: {}", current_.path);
+        }
+        spatialWriter_.clear();
+    }
+
+    LOG_INFO("Sealed storage segment: {} (records={}, bytes={})",
+             current_.path, current_.records, current_.bytes);
+    onSegmentSealed(current_);
+}
+
+bool SegmentStorage::needRotate(int64_t timeMs) const
+{
+    if (current_.records == 0) {
+        return false;
+    }
+    if (maxBytes_ > 0 && current_.bytes >= maxBytes_) {
+        return true;
+    }
+    return maxAgeMs_ > 0 && timeMs - current_.openedMs >= maxAgeMs_;
+}
+
+std::string SegmentStorage::makeSegmentPath(int64_t timeMs) const
+{
+    std::time_t seconds = static_cast<std::time_t>(timeMs / 1000);
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &seconds);
+#else
+    gmtime_r(&seconds, &tm);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "_%s_%04u%s", stamp, nextSequence_, binary_ ? ".bin" : ".csv");
+    return prefix_ + name;
+}
+
+void SegmentStorage::setActivePath(const std::string &path)
+{
+    const std::string normalized = normalizePath(path);
+    std::lock_guard<std::mutex> lock(compactMutex_);
+    activePath_ = normalized;
+}
+
+size_t SegmentStorage::compactSealedSegments()
+{
+    if (!binary_ || compactAfterMs_ <= 0) {
+        return 0;
+    }
+
+    const auto deadline = fs::file_time_type::clock::now() - std::chrono::milliseconds(compactAfterMs_);
+    size_t compacted = 0;
+
+    // 列出 <前缀>_*.bin（返回值不含扩展名）
+    for (const auto &stem : listIndexedSegments(prefix_, ".bin")) {
+        const std::string path = stem + ".bin";
+        const std::string normalized = normalizePath(path);
+        {
+            std::lock_guard<std::mutex> lock(compactMutex_);
+            if (compactStop_ || normalized == activePath_) {
+                continue;
+            }
+        }
+
+        std::error_code ec;
+        const auto modified = fs::last_write_time(path, ec);
+        if (ec || modified > deadline) {
+            continue;
+        }
+
+        CompactionResult result;
+        if (compactor_.compactSegment(path, &result) && !result.skipped) {
+            compacted++;
+            LOG_INFO("Compacted storage segment: {} (records {} -> {}, bytes {} -> {})",
+                     path, result.recordsBefore, result.recordsAfter, result.bytesBefore, result.bytesAfter);
+        }
+    }
+    return compacted;
+}
+
+void SegmentStorage::runCompaction()
+{
+    std::unique_lock<std::mutex> lock(compactMutex_);
+    while (!compactStop_) {
+        lock.unlock();
+        compactSealedSegments();
+        lock.lock();
+        compactCv_.wait_for(lock, std::chrono::milliseconds(COMPACT_CHECK_INTERVAL_MS),
+                            [this] { return compactStop_; });
+    }
+}
+
+/************* BinarySegmentReader *************/
+
+bool BinarySegmentReader::open(const std::string &path)
+{
+    close();
+    in_.open(path, std::ios::binary);
+    if (!in_.is_open()) {
+        return false;
+    }
+
+    uint8_t header[SegmentStorage::BINARY_HEADER_SIZE];
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    if (in_.read(reinterpret_cast<char *>(header), sizeof(header))) {
+        std::memcpy(&magic, header, sizeof(magic));
+        std::memcpy(&version, header + 4, sizeof(version));
+        std::memcpy(&flags_, header + 6, sizeof(flags_));
+    }
+    if (magic != SegmentStorage::BINARY_MAGIC || version > SegmentStorage::BINARY_VERSION) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void BinarySegmentReader::close()
+{
+    if (in_.is_open()) {
+        in_.close();
+    }
+    in_.clear();
+    flags_ = 0;
+}
+
+bool BinarySegmentReader::next(int64_t &timeMs, const uint8_t *&record, size_t &size)
+{
+    // 帧 = int64接收时间 + BinaryCodec记录（长度由记录头中的族决定）
+    if (!in_.is_open() || !in_.read(reinterpret_cast<char *>(frame_), 8 + BinaryCodec::HEADER_SIZE)) {
+        return false;
+    }
+    size = BinaryCodec::recordSize(static_cast<BinaryRecordFamily>(frame_[8 + 2]));
+    if (size < BinaryCodec::HEADER_SIZE || size > BinaryCodec::MAX_RECORD_SIZE ||
+        !in_.read(reinterpret_cast<char *>(frame_) + 8 + BinaryCodec::HEADER_SIZE,
+                  static_cast<std::streamsize>(size - BinaryCodec::HEADER_SIZE))) {
+        return false;
+    }
+    std::memcpy(&timeMs, frame_, sizeof(timeMs));
+    record = frame_ + 8;
+    return true;
+}
+
+} // namespace ais
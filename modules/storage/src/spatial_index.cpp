@@ -0,0 +1,243 @@
+#include "spatial_index.h"
+
+#include "quadkey.h"
+#include "varint_codec.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace ais
+{
+
+namespace fs = std::filesystem;
+
+/************* SpatialIndexWriter *************/
+
+SpatialIndexWriter::SpatialIndexWriter(int level)
+    : level_(std::min(std::max(level, 1), quadkey::MAX_LEVEL))
+{
+}
+
+void SpatialIndexWriter::add(double lon, double lat, uint64_t offset, int64_t timeMs)
+{
+    uint32_t x, y;
+    quadkey::latLonToTile(lon, lat, level_, x, y);
+    cells_[quadkey::tileToKey(x, y, level_)].add(offset, timeMs);
+}
+
+void SpatialIndexWriter::clear()
+{
+    cells_.clear();
+}
+
+bool SpatialIndexWriter::write(const std::string &path, bool binarySegment) const
+{
+    std::vector<uint64_t> keys;
+    keys.reserve(cells_.size());
+    int64_t minTime = std::numeric_limits<int64_t>::max();
+    int64_t maxTime = std::numeric_limits<int64_t>::min();
+    for (const auto &kv : cells_) {
+        keys.push_back(kv.first);
+        minTime = std::min(minTime, kv.second.minTimeMs);
+        maxTime = std::max(maxTime, kv.second.maxTimeMs);
+    }
+    std::sort(keys.begin(), keys.end());
+    if (keys.empty()) {
+        minTime = maxTime = 0;
+    }
+
+    std::string header;
+    putFixed<uint32_t>(header, MAGIC);
+    putFixed<uint16_t>(header, VERSION);
+    putFixed<uint16_t>(header, binarySegment ? 1 : 0);
+    putFixed<uint32_t>(header, static_cast<uint32_t>(keys.size()));
+    putFixed<uint32_t>(header, static_cast<uint32_t>(level_));
+    putFixed<int64_t>(header, minTime);
+    putFixed<int64_t>(header, maxTime);
+
+    std::string directory;
+    directory.reserve(keys.size() * ENTRY_SIZE);
+    uint32_t dataOffset = 0;
+    for (uint64_t key : keys) {
+        const PostingList &cell = cells_.at(key);
+        putFixed<uint64_t>(directory, key);
+        putFixed<uint32_t>(directory, cell.count);
+        putFixed<int64_t>(directory, cell.minTimeMs);
+        putFixed<int64_t>(directory, cell.maxTimeMs);
+        putFixed<uint32_t>(directory, dataOffset);
+        putFixed<uint32_t>(directory, static_cast<uint32_t>(cell.data.size()));
+        dataOffset += static_cast<uint32_t>(cell.data.size());
+    }
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(header.data(), header.size());
+        out.write(directory.data(), directory.size());
+        for (uint64_t key : keys) {
+            const std::string &data = cells_.at(key).data;
+            out.write(data.data(), data.size());
+        }
+        if (!out.good()) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec);
+    return !ec;
+}
+
+/************* SpatialIndexReader *************/
+
+bool SpatialIndexReader::open(const std::string &path)
+{
+    entries_.clear();
+    data_.clear();
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return false;
+    }
+    data_.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (data_.empty() || !in.read(&data_[0], data_.size())) {
+        return false;
+    }
+
+    try {
+        ByteCursor c(reinterpret_cast<const uint8_t *>(data_.data()), data_.size());
+        if (c.fixed<uint32_t>() != SpatialIndexWriter::MAGIC ||
+            c.fixed<uint16_t>() > SpatialIndexWriter::VERSION) {
+            return false;
+        }
+        binarySegment_ = (c.fixed<uint16_t>() & 1) != 0;
+        const uint32_t count = c.fixed<uint32_t>();
+        level_ = static_cast<int>(c.fixed<uint32_t>());
+        minTimeMs_ = c.fixed<int64_t>();
+        maxTimeMs_ = c.fixed<int64_t>();
+        if (level_ < 1 || level_ > quadkey::MAX_LEVEL) {
+            return false;
+        }
+
+        entries_.resize(count);
+        for (auto &entry : entries_) {
+            entry.cell = c.fixed<uint64_t>();
+            entry.count = c.fixed<uint32_t>();
+            entry.minTimeMs = c.fixed<int64_t>();
+            entry.maxTimeMs = c.fixed<int64_t>();
+            entry.dataOffset = c.fixed<uint32_t>();
+            entry.dataSize = c.fixed<uint32_t>();
+        }
+        dataStart_ = data_.size() - c.remaining();
+
+        for (const auto &entry : entries_) {
+            if (static_cast<uint64_t>(entry.dataOffset) + entry.dataSize > c.remaining()) {
+                entries_.clear();
+                return false;
+            }
+        }
+    } catch (const std::out_of_range &) {
+        entries_.clear();
+        return false;
+    }
+    return true;
+}
+
+size_t SpatialIndexReader::query(double south, double west, double north, double east,
+                                 int64_t t0, int64_t t1, std::vector<TrackPoint> &out) const
+{
+    if (entries_.empty() || maxTimeMs_ < t0 || minTimeMs_ > t1 || south > north) {
+        return 0;
+    }
+
+    const size_t before = out.size();
+
+    // 瓦片Y向南递增，北边界对应较小的Y
+    uint32_t xw, xe, yn, ys, unused;
+    quadkey::latLonToTile(west, north, level_, xw, yn);
+    quadkey::latLonToTile(east, south, level_, xe, ys);
+
+    if (west <= east) {
+        collect(xw, xe, yn, ys, t0, t1, out);
+    } else {
+        // 跨越180度经线时拆为两段
+        uint32_t xMax, xMin;
+        quadkey::latLonToTile(180.0, north, level_, xMax, unused);
+        quadkey::latLonToTile(-180.0, north, level_, xMin, unused);
+        collect(xw, xMax, yn, ys, t0, t1, out);
+        collect(xMin, xe, yn, ys, t0, t1, out);
+    }
+
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(before), out.end(),
+              [](const TrackPoint &a, const TrackPoint &b) { return a.offset < b.offset; });
+    return out.size() - before;
+}
+
+void SpatialIndexReader::collect(uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1,
+                                 int64_t t0, int64_t t1, std::vector<TrackPoint> &out) const
+{
+    const uint64_t tiles = static_cast<uint64_t>(x1 - x0 + 1) * (y1 - y0 + 1);
+
+    if (tiles <= entries_.size()) {
+        // 查询范围较小：逐个单元格二分查找
+        for (uint32_t y = y0; y <= y1; ++y) {
+            for (uint32_t x = x0; x <= x1; ++x) {
+                const uint64_t key = quadkey::tileToKey(x, y, level_);
+                auto it = std::lower_bound(entries_.begin(), entries_.end(), key,
+                    [](const SpatialIndexEntry &entry, uint64_t k) { return entry.cell < k; });
+                if (it != entries_.end() && it->cell == key) {
+                    collectEntry(*it, t0, t1, out);
+                }
+            }
+        }
+        return;
+    }
+
+    // 查询范围较大：遍历目录判断单元格是否落在范围内
+    for (const auto &entry : entries_) {
+        uint32_t x, y;
+        quadkey::keyToTile(entry.cell, level_, x, y);
+        if (x >= x0 && x <= x1 && y >= y0 && y <= y1) {
+            collectEntry(entry, t0, t1, out);
+        }
+    }
+}
+
+void SpatialIndexReader::collectEntry(const SpatialIndexEntry &entry, int64_t t0, int64_t t1,
+                                      std::vector<TrackPoint> &out) const
+{
+    if (entry.maxTimeMs < t0 || entry.minTimeMs > t1) {
+        return;
+    }
+    PostingList::decode(reinterpret_cast<const uint8_t *>(data_.data()) + dataStart_ + entry.dataOffset,
+                        entry.dataSize, entry.count, t0, t1, out);
+}
+
+size_t SpatialIndexReader::queryArea(const std::string &prefix, double south, double west, double north,
+                                     double east, int64_t t0, int64_t t1, const SegmentRecordVisitor &visitor)
+{
+    size_t total = 0;
+    SpatialIndexReader index;
+    std::vector<TrackPoint> points;
+
+    for (const auto &segment : listIndexedSegments(prefix, ".qidx")) {
+        if (!index.open(segment + ".qidx") ||
+            index.maxTimeMs() < t0 || index.minTimeMs() > t1) {
+            continue;
+        }
+
+        points.clear();
+        if (index.query(south, west, north, east, t0, t1, points) > 0) {
+            total += readSegmentRecords(segment, index.binarySegment(), points, visitor);
+        }
+    }
+    return total;
+}
+
+} // namespace ais
@@ -0,0 +1,331 @@
+#ifdef AIS_WITH_SQLITE
+
+#include "sqlite_storage.h"
+
+#include "logger_define.h"
+#include "messages/type_definitions.h"
+#include "utils/message_fields.h"
+
+#include <sqlite3.h>
+
+namespace ais
+{
+
+namespace
+{
+
+const char *const SCHEMA_SQL =
+    "CREATE TABLE IF NOT EXISTS positions ("
+    " mmsi INTEGER NOT NULL, time_ms INTEGER NOT NULL, msg_type INTEGER NOT NULL,"
+    " latitude REAL, longitude REAL, sog REAL, cog REAL, heading INTEGER,"
+    " rot INTEGER, nav_status INTEGER, accuracy INTEGER);"
+    "CREATE TABLE IF NOT EXISTS static_data ("
+    " mmsi INTEGER NOT NULL, time_ms INTEGER NOT NULL, msg_type INTEGER NOT NULL,"
+    " part INTEGER, imo INTEGER, call_sign TEXT, name TEXT, ship_type INTEGER,"
+    " to_bow INTEGER, to_stern INTEGER, to_port INTEGER, to_starboard INTEGER,"
+    " eta_month INTEGER, eta_day INTEGER, eta_hour INTEGER, eta_minute INTEGER,"
+    " draught REAL, destination TEXT);"
+    "CREATE TABLE IF NOT EXISTS base_stations ("
+    " mmsi INTEGER NOT NULL, time_ms INTEGER NOT NULL, msg_type INTEGER NOT NULL,"
+    " latitude REAL, longitude REAL, utc_year INTEGER, utc_month INTEGER, utc_day INTEGER,"
+    " utc_hour INTEGER, utc_minute INTEGER, utc_second INTEGER, epfd_type INTEGER);";
+
+const char *const INDEX_SQL =
+    "CREATE INDEX IF NOT EXISTS idx_positions_mmsi_time ON positions(mmsi, time_ms);"
+    "CREATE INDEX IF NOT EXISTS idx_positions_time ON positions(time_ms);"
+    "CREATE INDEX IF NOT EXISTS idx_static_mmsi_time ON static_data(mmsi, time_ms);"
+    "CREATE INDEX IF NOT EXISTS idx_static_time ON static_data(time_ms);"
+    "CREATE INDEX IF NOT EXISTS idx_base_mmsi_time ON base_stations(mmsi, time_ms);"
+    "CREATE INDEX IF NOT EXISTS idx_base_time ON base_stations(time_ms);";
+
+// 未建索引时累计写入超过该行数即结束初始批量阶段
+constexpr uint64_t BULK_PHASE_ROWS = 1000000;
+
+// 按列序号绑定，空字符串写为NULL
+void bindText(sqlite3_stmt *stmt, int col, const std::string &text)
+{
+    if (text.empty()) {
+        sqlite3_bind_null(stmt, col);
+    } else {
+        sqlite3_bind_text(stmt, col, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+    }
+}
+
+bool stepAndReset(sqlite3_stmt *stmt)
+{
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return rc == SQLITE_DONE;
+}
+
+} // namespace
+
+SqliteStorage::SqliteStorage(const AISSaveCfg &cfg)
+    : AsyncStorage(static_cast<size_t>(cfg.queueCapacity > 0 ? cfg.queueCapacity : 0), cfg.flushIntervalMs)
+    , path_(cfg.storagePath.empty() ? "ais_data.db" : cfg.storagePath)
+    , transactionRows_(cfg.transactionRows > 0 ? static_cast<size_t>(cfg.transactionRows) : 50000)
+{
+}
+
+SqliteStorage::~SqliteStorage()
+{
+    stop();
+}
+
+bool SqliteStorage::openSink()
+{
+    if (sqlite3_open(path_.c_str(), &db_) != SQLITE_OK) {
+        LOG_ERROR("Failed to open SQLite database {}: {}", path_, db_ ? sqlite3_errmsg(db_) : "out of memory");
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return false;
+    }
+
+    // WAL模式下写入不阻塞读取方；NORMAL同步在WAL下仅在检查点fsync
+    if (!exec("PRAGMA journal_mode=WAL;") ||
+        !exec("PRAGMA synchronous=NORMAL;") ||
+        !exec("PRAGMA temp_store=MEMORY;") ||
+        !exec("PRAGMA cache_size=-65536;") ||
+        !exec(SCHEMA_SQL)) {
+        releaseDb();
+        return false;
+    }
+
+    if (!prepare("INSERT INTO positions VALUES (?,?,?,?,?,?,?,?,?,?,?)", &insertPosition_) ||
+        !prepare("INSERT INTO static_data VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)", &insertStatic_) ||
+        !prepare("INSERT INTO base_stations VALUES (?,?,?,?,?,?,?,?,?,?,?,?)", &insertBaseStation_)) {
+        releaseDb();
+        return false;
+    }
+
+    indexesBuilt_ = hasIndexes();
+    bulkRows_ = 0;
+    rowsSinceFlush_ = 0;
+    LOG_INFO("SQLite storage opened: {}, Indexed={}", path_, indexesBuilt_);
+    return true;
+}
+
+bool SqliteStorage::writeBatch(const std::vector<StorageRecord> &batch)
+{
+    if (!inTransaction_ && !beginTransaction()) {
+        return false;
+    }
+
+    bool ok = true;
+    for (const auto &record : batch) {
+        const AISMessage &msg = *record.msg;
+        switch (msg.type)
+        {
+        case AISMessageType::STATIC_VOYAGE_DATA:
+        case AISMessageType::STATIC_DATA_REPORT:
+            ok &= insertStatic(msg, record.timeMs);
+            break;
+        case AISMessageType::BASE_STATION_REPORT:
+        case AISMessageType::UTC_DATE_RESPONSE:
+            ok &= insertBaseStation(msg, record.timeMs);
+            break;
+        default:
+            if (isVesselPositionType(msg.type)) {
+                ok &= insertPosition(msg, record.timeMs);
+            }
+            continue;
+        }
+    }
+    pendingRows_ += batch.size();
+    rowsSinceFlush_ += batch.size();
+
+    if (pendingRows_ >= transactionRows_) {
+        ok &= commitTransaction();
+    }
+    return ok;
+}
+
+void SqliteStorage::flushSink()
+{
+    if (inTransaction_) {
+        commitTransaction();
+    }
+
+    // 初始批量阶段结束（已写入数据后一个落盘周期内无新数据，或累计写入达到BULK_PHASE_ROWS）后建索引，
+    // 之后的插入由SQLite维护索引；运行中异常退出时已建的索引保留。
+    // 启动后数据尚未到达时的空闲周期不算结束，否则会在空表上建索引，随后的批量写入仍要逐行维护索引
+    if (!indexesBuilt_) {
+        bulkRows_ += rowsSinceFlush_;
+        if ((rowsSinceFlush_ == 0 && bulkRows_ > 0) || bulkRows_ >= BULK_PHASE_ROWS) {
+            createIndexes();
+        }
+    }
+    rowsSinceFlush_ = 0;
+}
+
+void SqliteStorage::closeSink()
+{
+    if (!db_) {
+        return;
+    }
+    if (inTransaction_) {
+        commitTransaction();
+    }
+    if (!indexesBuilt_) {
+        createIndexes();
+    }
+    exec("PRAGMA wal_checkpoint(TRUNCATE);");
+    releaseDb();
+}
+
+void SqliteStorage::releaseDb()
+{
+    sqlite3_finalize(insertPosition_);
+    sqlite3_finalize(insertStatic_);
+    sqlite3_finalize(insertBaseStation_);
+    insertPosition_ = insertStatic_ = insertBaseStation_ = nullptr;
+
+    sqlite3_close(db_);
+    db_ = nullptr;
+    inTransaction_ = false;
+}
+
+bool SqliteStorage::exec(const char *sql)
+{
+    char *error = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &error) != SQLITE_OK) {
+        LOG_ERROR("SQLite exec failed: {} ({})", error ? error : "unknown", sql);
+        sqlite3_free(error);
+        return false;
+    }
+    return true;
+}
+
+bool SqliteStorage::prepare(const char *sql, sqlite3_stmt **stmt)
+{
+    if (sqlite3_prepare_v2(db_, sql, -1, stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("SQLite prepare failed: {} ({})", sqlite3_errmsg(db_), sql);
+        return false;
+    }
+    return true;
+}
+
+bool SqliteStorage::beginTransaction()
+{
+    inTransaction_ = exec("BEGIN;");
+    pendingRows_ = 0;
+    return inTransaction_;
+}
+
+bool SqliteStorage::commitTransaction()
+{
+    inTransaction_ = false;
+    pendingRows_ = 0;
+    return exec("COMMIT;");
+}
+
+void SqliteStorage::createIndexes()
+{
+    LOG_INFO("Creating SQLite indexes: {}, Rows={}", path_, bulkRows_);
+    indexesBuilt_ = exec(INDEX_SQL);
+}
+
+bool SqliteStorage::hasIndexes()
+{
+    sqlite3_stmt *stmt = nullptr;
+    if (!prepare("SELECT count(*) FROM sqlite_master WHERE type='index' AND name LIKE 'idx_%'", &stmt)) {
+        return false;
+    }
+    const bool found = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) >= 6;
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+bool SqliteStorage::insertPosition(const AISMessage &msg, int64_t timeMs)
+{
+    PositionFields pos;
+    extractPosition(msg, pos);
+
+    sqlite3_stmt *stmt = insertPosition_;
+    sqlite3_bind_int64(stmt, 1, msg.mmsi);
+    sqlite3_bind_int64(stmt, 2, timeMs);
+    sqlite3_bind_int(stmt, 3, static_cast<int>(msg.type));
+    if (pos.latitude <= 90.0 && pos.longitude <= 180.0) {
+        sqlite3_bind_double(stmt, 4, pos.latitude);
+        sqlite3_bind_double(stmt, 5, pos.longitude);
+    }
+    sqlite3_bind_double(stmt, 6, pos.speedOverGround);
+    sqlite3_bind_double(stmt, 7, pos.courseOverGround);
+    sqlite3_bind_int(stmt, 8, pos.trueHeading);
+    sqlite3_bind_int(stmt, 9, pos.rateOfTurn);
+    sqlite3_bind_int(stmt, 10, pos.navigationStatus);
+    sqlite3_bind_int(stmt, 11, pos.positionAccuracy ? 1 : 0);
+    return stepAndReset(stmt);
+}
+
+bool SqliteStorage::insertStatic(const AISMessage &msg, int64_t timeMs)
+{
+    sqlite3_stmt *stmt = insertStatic_;
+    sqlite3_bind_int64(stmt, 1, msg.mmsi);
+    sqlite3_bind_int64(stmt, 2, timeMs);
+    sqlite3_bind_int(stmt, 3, static_cast<int>(msg.type));
+
+    if (msg.type == AISMessageType::STATIC_VOYAGE_DATA) {
+        const auto &m = static_cast<const StaticVoyageData &>(msg);
+        sqlite3_bind_int(stmt, 5, m.imoNumber);
+        bindText(stmt, 6, m.callSign);
+        bindText(stmt, 7, m.vesselName);
+        sqlite3_bind_int(stmt, 8, m.shipType);
+        sqlite3_bind_int(stmt, 9, m.dimensionToBow);
+        sqlite3_bind_int(stmt, 10, m.dimensionToStern);
+        sqlite3_bind_int(stmt, 11, m.dimensionToPort);
+        sqlite3_bind_int(stmt, 12, m.dimensionToStarboard);
+        sqlite3_bind_int(stmt, 13, m.month);
+        sqlite3_bind_int(stmt, 14, m.day);
+        sqlite3_bind_int(stmt, 15, m.hour);
+        sqlite3_bind_int(stmt, 16, m.minute);
+        sqlite3_bind_double(stmt, 17, m.draught);
+        bindText(stmt, 18, m.destination);
+    } else {
+        // 类型24分A/B两部分，仅绑定该部分携带的字段
+        const auto &m = static_cast<const StaticDataReport &>(msg);
+        sqlite3_bind_int(stmt, 4, m.partNumber);
+        if (m.partNumber == 0) {
+            bindText(stmt, 7, m.vesselName);
+        } else {
+            bindText(stmt, 6, m.callSign);
+            sqlite3_bind_int(stmt, 8, m.shipType);
+            sqlite3_bind_int(stmt, 9, m.dimensionToBow);
+            sqlite3_bind_int(stmt, 10, m.dimensionToStern);
+            sqlite3_bind_int(stmt, 11, m.dimensionToPort);
+            sqlite3_bind_int(stmt, 12, m.dimensionToStarboard);
+        }
+    }
+    return stepAndReset(stmt);
+}
+
+bool SqliteStorage::insertBaseStation(const AISMessage &msg, int64_t timeMs)
+{
+    // 类型4与类型11字段布局相同
+    auto bind = [&](const auto &m) {
+        sqlite3_stmt *stmt = insertBaseStation_;
+        sqlite3_bind_int64(stmt, 1, msg.mmsi);
+        sqlite3_bind_int64(stmt, 2, timeMs);
+        sqlite3_bind_int(stmt, 3, static_cast<int>(msg.type));
+        sqlite3_bind_double(stmt, 4, m.latitude);
+        sqlite3_bind_double(stmt, 5, m.longitude);
+        sqlite3_bind_int(stmt, 6, m.year);
+        sqlite3_bind_int(stmt, 7, m.month);
+        sqlite3_bind_int(stmt, 8, m.day);
+        sqlite3_bind_int(stmt, 9, m.hour);
+        sqlite3_bind_int(stmt, 10, m.minute);
+        sqlite3_bind_int(stmt, 11, m.second);
+        sqlite3_bind_int(stmt, 12, m.epfdType);
+        return stepAndReset(stmt);
+    };
+
+    if (msg.type == AISMessageType::BASE_STATION_REPORT) {
+        return bind(static_cast<const BaseStationReport &>(msg));
+    }
+    return bind(static_cast<const UTCDateResponse &>(msg));
+}
+
+} // namespace ais
+
+#endif // AIS_WITH_SQLITE
@@ -0,0 +1,39 @@
+#include "ais_storage.h"
+
+#include "logger_define.h"
+#include "memory_ring_storage.h"
+#include "segment_storage.h"
+#include "sqlite_storage.h"
+
+namespace ais
+{
+
+std::shared_ptr<AISStorage> createStorage(const AISSaveCfg &cfg)
+{
+    if (!cfg.saveSwitch) {
+        return nullptr;
+    }
+
+    switch (cfg.storageType)
+    {
+    case StorageType::CSV:
+    case StorageType::BINARY:
+        return std::make_shared<SegmentStorage>(cfg);
+    case StorageType::MEMORY:
+        return std::make_shared<MemoryRingStorage>(cfg);
+    case StorageType::DATABASE:
+#ifdef AIS_WITH_SQLITE
+        return std::make_shared<SqliteStorage>(cfg);
+#else
+        LOG_ERROR("Storage module was built without SQLite support");
+        return nullptr;
+#endif
+    case StorageType::NONE:
+        return nullptr;
+    default:
+        LOG_WARNING("Storage type {} is not supported yet", static_cast<int>(cfg.storageType));
+        return nullptr;
+    }
+}
+
+} // namespace ais
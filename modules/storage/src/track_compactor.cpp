@@ -0,0 +1,322 @@
+#include "track_compactor.h"
+
+#include "logger_define.h"
+#include "segment_storage.h"
+#include "utils/binary_codec.h"
+#include "utils/geo_math.h"
+#include "utils/message_fields.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <utility>
+
+namespace ais
+{
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using geo::DEG_TO_RAD;
+using geo::EARTH_RADIUS_M;
+
+double wrapLongitude(double degrees)
+{
+    if (degrees > 180.0) {
+        return degrees - 360.0;
+    }
+    if (degrees < -180.0) {
+        return degrees + 360.0;
+    }
+    return degrees;
+}
+
+/**
+ * @brief 点p与a、b之间按时间线性插值位置的距离（米，局部等距投影）
+ */
+double syncDistance(const TrackSample &a, const TrackSample &b, const TrackSample &p)
+{
+    double ratio = 0.0;
+    if (b.timeMs > a.timeMs) {
+        ratio = static_cast<double>(p.timeMs - a.timeMs) / static_cast<double>(b.timeMs - a.timeMs);
+        ratio = std::min(std::max(ratio, 0.0), 1.0);
+    }
+    const double lat = a.latitude + (b.latitude - a.latitude) * ratio;
+    const double lon = a.longitude + wrapLongitude(b.longitude - a.longitude) * ratio;
+
+    const double dx = wrapLongitude(p.longitude - lon) * std::cos((p.latitude + lat) * 0.5 * DEG_TO_RAD);
+    const double dy = p.latitude - lat;
+    return std::sqrt(dx * dx + dy * dy) * DEG_TO_RAD * EARTH_RADIUS_M;
+}
+
+/**
+ * @brief 分段中的一帧
+ */
+struct Frame
+{
+    size_t offset = 0;          // 帧在原文件中的偏移
+    size_t size = 0;            // 帧长度（含时间前缀）
+    int64_t timeMs = 0;
+    uint32_t mmsi = 0;
+    bool keep = true;
+    bool hasPosition = false;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    int navigationStatus = 15;
+};
+
+} // namespace
+
+TrackCompactor::TrackCompactor(double toleranceMeters, bool trackIndex, int spatialIndexLevel)
+    : toleranceMeters_(std::max(toleranceMeters, 0.0))
+    , trackIndex_(trackIndex)
+    , spatialIndexLevel_(spatialIndexLevel)
+{
+}
+
+std::vector<bool> TrackCompactor::simplify(const std::vector<TrackSample> &samples, double toleranceMeters)
+{
+    const size_t n = samples.size();
+    std::vector<bool> keep(n, false);
+    if (n == 0) {
+        return keep;
+    }
+
+    keep[0] = keep[n - 1] = true;
+    for (size_t i = 0; i < n; ++i) {
+        if (samples[i].anchor) {
+            keep[i] = true;
+        }
+    }
+
+    // 相邻固定点之间迭代抽稀（显式栈，避免长航迹递归过深）
+    std::vector<std::pair<size_t, size_t>> stack;
+    size_t start = 0;
+    for (size_t end = 1; end < n; ++end) {
+        if (!keep[end]) {
+            continue;
+        }
+        stack.emplace_back(start, end);
+        while (!stack.empty()) {
+            const auto [first, last] = stack.back();
+            stack.pop_back();
+            if (last - first < 2) {
+                continue;
+            }
+
+            double maxDistance = -1.0;
+            size_t farthest = first;
+            for (size_t i = first + 1; i < last; ++i) {
+                const double distance = syncDistance(samples[first], samples[last], samples[i]);
+                if (distance > maxDistance) {
+                    maxDistance = distance;
+                    farthest = i;
+                }
+            }
+            if (maxDistance > toleranceMeters) {
+                keep[farthest] = true;
+                stack.emplace_back(first, farthest);
+                stack.emplace_back(farthest, last);
+            }
+        }
+        start = end;
+    }
+    return keep;
+}
+
+bool TrackCompactor::compactSegment(const std::string &path, CompactionResult *result) const
+{
+    CompactionResult local;
+    CompactionResult &res = result ? *result : local;
+    res = CompactionResult();
+
+    std::string data;
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) {
+            LOG_ERROR("Failed to open segment for compaction: {}", path);
+            return false;
+        }
+        data.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        if (!data.empty() && !in.read(&data[0], data.size())) {
+            LOG_ERROR("Failed to read segment for compaction: {}", path);
+            return false;
+        }
+    }
+    res.bytesBefore = data.size();
+
+    // 只处理未压缩过的二进制分段
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    uint16_t flags = 0;
+    if (data.size() >= SegmentStorage::BINARY_HEADER_SIZE) {
+        std::memcpy(&magic, data.data(), sizeof(magic));
+        std::memcpy(&version, data.data() + 4, sizeof(version));
+        std::memcpy(&flags, data.data() + 6, sizeof(flags));
+    }
+    if (magic != SegmentStorage::BINARY_MAGIC || version > SegmentStorage::BINARY_VERSION ||
+        (flags & FLAG_COMPACTED)) {
+        res.skipped = true;
+        return true;
+    }
+
+    // 拆帧并按船归集航迹
+    std::vector<Frame> frames;
+    std::unordered_map<uint32_t, std::vector<size_t>> tracks;
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(data.data());
+    size_t pos = SegmentStorage::BINARY_HEADER_SIZE;
+    while (pos + 8 + BinaryCodec::HEADER_SIZE <= data.size()) {
+        const size_t recordSize = BinaryCodec::recordSize(static_cast<BinaryRecordFamily>(base[pos + 8 + 2]));
+        if (recordSize < BinaryCodec::HEADER_SIZE) {
+            // 分段中间的记录无法识别时无法确定后续帧边界，改写会丢弃其后的全部记录，保留原文件
+            LOG_ERROR("Segment {} has an unrecognized record at offset {} ({} bytes follow), not compacted",
+                      path, pos, data.size() - pos);
+            res.skipped = true;
+            return false;
+        }
+        if (pos + 8 + recordSize > data.size()) {
+            break;
+        }
+
+        Frame frame;
+        frame.offset = pos;
+        frame.size = 8 + recordSize;
+        std::memcpy(&frame.timeMs, base + pos, sizeof(frame.timeMs));
+        pos += frame.size;
+
+        auto msg = BinaryCodec::deserialize(base + frame.offset + 8, recordSize);
+        if (msg) {
+            PositionFields fields;
+            frame.mmsi = msg->mmsi;
+            frame.hasPosition = extractPosition(*msg, fields);
+            frame.latitude = fields.latitude;
+            frame.longitude = fields.longitude;
+            frame.navigationStatus = fields.navigationStatus;
+            if (frame.hasPosition && isVesselPositionType(msg->type)) {
+                frame.keep = false;
+                tracks[frame.mmsi].push_back(frames.size());
+            }
+        }
+        frames.push_back(frame);
+    }
+    if (pos != data.size()) {
+        // 只有写入中断留下的不完整尾帧会走到这里
+        LOG_WARNING("Segment {} has a torn trailing record ({} bytes), dropped",
+                    path, data.size() - pos);
+    }
+
+    // 逐船抽稀
+    std::vector<TrackSample> samples;
+    for (const auto &track : tracks) {
+        const std::vector<size_t> &indices = track.second;
+        samples.resize(indices.size());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            const Frame &frame = frames[indices[i]];
+            TrackSample &sample = samples[i];
+            sample.timeMs = frame.timeMs;
+            sample.latitude = frame.latitude;
+            sample.longitude = frame.longitude;
+            sample.anchor = false;
+            if (i > 0) {
+                // 导航状态变化、长时间无报告时保留前后两点
+                const bool statusChanged = frame.navigationStatus != frames[indices[i - 1]].navigationStatus;
+                const bool gap = frame.timeMs - frames[indices[i - 1]].timeMs > MAX_GAP_MS;
+                if (statusChanged || gap) {
+                    sample.anchor = true;
+                    samples[i - 1].anchor = true;
+                }
+            }
+        }
+
+        const std::vector<bool> keep = simplify(samples, toleranceMeters_);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            frames[indices[i]].keep = keep[i];
+        }
+    }
+
+    // 写出保留的帧并重建索引
+    std::string output;
+    output.reserve(data.size());
+    output.append(data, 0, SegmentStorage::BINARY_HEADER_SIZE);
+    flags |= FLAG_COMPACTED;
+    std::memcpy(&output[6], &flags, sizeof(flags));
+
+    TrackIndexWriter trackWriter;
+    SpatialIndexWriter spatialWriter(spatialIndexLevel_);
+    for (const auto &frame : frames) {
+        res.recordsBefore++;
+        if (!frame.keep) {
+            continue;
+        }
+        if (trackIndex_) {
+            trackWriter.add(frame.mmsi, output.size(), frame.timeMs);
+        }
+        if (spatialIndexLevel_ > 0 && frame.hasPosition) {
+            spatialWriter.add(frame.longitude, frame.latitude, output.size(), frame.timeMs);
+        }
+        output.append(data, frame.offset, frame.size);
+        res.recordsAfter++;
+    }
+    res.bytesAfter = output.size();
+
+    // 分段和索引都先写到临时文件，全部成功后再一起替换，避免新分段配旧索引
+    std::vector<std::pair<std::string, std::string>> replaces;
+    auto discard = [&replaces]() {
+        std::error_code ec;
+        for (const auto &item : replaces) {
+            fs::remove(item.first, ec);
+        }
+    };
+
+    const std::string tmpPath = path + ".tmp";
+    replaces.emplace_back(tmpPath, path);
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open() || !out.write(output.data(), output.size()) || !out.flush()) {
+            LOG_ERROR("Failed to write compacted segment: {}", tmpPath);
+            discard();
+            return false;
+        }
+    }
+    if (trackIndex_) {
+        replaces.emplace_back(path + ".idx.tmp", path + ".idx");
+        if (!trackWriter.write(replaces.back().first, true)) {
+            LOG_ERROR("Failed to rebuild track index for compacted segment: {}", path);
+            discard();
+            return false;
+        }
+    }
+    if (spatialIndexLevel_ > 0) {
+        replaces.emplace_back(path + ".qidx.tmp", path + ".qidx");
+        if (!spatialWriter.write(replaces.back().first, true)) {
+            LOG_ERROR("Failed to rebuild spatial index for compacted segment: {}", path);
+            discard();
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < replaces.size(); ++i) {
+        std::error_code ec;
+        fs::rename(replaces[i].first, replaces[i].second, ec);
+        if (ec) {
+            LOG_ERROR("Failed to replace {}: {}", replaces[i].second, ec.message());
+            // 分段已替换时删除未能更新的旧索引，查询退化为顺序扫描
+            for (size_t j = i; j < replaces.size(); ++j) {
+                fs::remove(replaces[j].first, ec);
+                if (i > 0) {
+                    fs::remove(replaces[j].second, ec);
+                }
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace ais
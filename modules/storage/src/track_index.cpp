@@ -0,0 +1,185 @@
+#include "track_index.h"
+
+#include "varint_codec.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace ais
+{
+
+namespace fs = std::filesystem;
+
+/************* TrackIndexWriter *************/
+
+void TrackIndexWriter::add(uint32_t mmsi, uint64_t offset, int64_t timeMs)
+{
+    tracks_[mmsi].add(offset, timeMs);
+}
+
+void TrackIndexWriter::clear()
+{
+    tracks_.clear();
+}
+
+bool TrackIndexWriter::write(const std::string &path, bool binarySegment) const
+{
+    std::vector<uint32_t> ids;
+    ids.reserve(tracks_.size());
+    int64_t minTime = std::numeric_limits<int64_t>::max();
+    int64_t maxTime = std::numeric_limits<int64_t>::min();
+    for (const auto &kv : tracks_) {
+        ids.push_back(kv.first);
+        minTime = std::min(minTime, kv.second.minTimeMs);
+        maxTime = std::max(maxTime, kv.second.maxTimeMs);
+    }
+    std::sort(ids.begin(), ids.end());
+    if (ids.empty()) {
+        minTime = maxTime = 0;
+    }
+
+    std::string header;
+    putFixed<uint32_t>(header, MAGIC);
+    putFixed<uint16_t>(header, VERSION);
+    putFixed<uint16_t>(header, binarySegment ? 1 : 0);
+    putFixed<uint32_t>(header, static_cast<uint32_t>(ids.size()));
+    putFixed<uint32_t>(header, 0);
+    putFixed<int64_t>(header, minTime);
+    putFixed<int64_t>(header, maxTime);
+
+    std::string directory;
+    directory.reserve(ids.size() * ENTRY_SIZE);
+    uint32_t dataOffset = 0;
+    for (uint32_t id : ids) {
+        const PostingList &track = tracks_.at(id);
+        putFixed<uint32_t>(directory, id);
+        putFixed<uint32_t>(directory, track.count);
+        putFixed<int64_t>(directory, track.minTimeMs);
+        putFixed<int64_t>(directory, track.maxTimeMs);
+        putFixed<uint32_t>(directory, dataOffset);
+        putFixed<uint32_t>(directory, static_cast<uint32_t>(track.data.size()));
+        dataOffset += static_cast<uint32_t>(track.data.size());
+    }
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(header.data(), header.size());
+        out.write(directory.data(), directory.size());
+        for (uint32_t id : ids) {
+            const std::string &data = tracks_.at(id).data;
+            out.write(data.data(), data.size());
+        }
+        if (!out.good()) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec);
+    return !ec;
+}
+
+/************* TrackIndexReader *************/
+
+bool TrackIndexReader::open(const std::string &path)
+{
+    entries_.clear();
+    data_.clear();
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return false;
+    }
+    data_.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (data_.empty() || !in.read(&data_[0], data_.size())) {
+        return false;
+    }
+
+    try {
+        ByteCursor c(reinterpret_cast<const uint8_t *>(data_.data()), data_.size());
+        if (c.fixed<uint32_t>() != TrackIndexWriter::MAGIC ||
+            c.fixed<uint16_t>() > TrackIndexWriter::VERSION) {
+            return false;
+        }
+        binarySegment_ = (c.fixed<uint16_t>() & 1) != 0;
+        const uint32_t count = c.fixed<uint32_t>();
+        c.fixed<uint32_t>();
+        minTimeMs_ = c.fixed<int64_t>();
+        maxTimeMs_ = c.fixed<int64_t>();
+
+        entries_.resize(count);
+        for (auto &entry : entries_) {
+            entry.mmsi = c.fixed<uint32_t>();
+            entry.count = c.fixed<uint32_t>();
+            entry.minTimeMs = c.fixed<int64_t>();
+            entry.maxTimeMs = c.fixed<int64_t>();
+            entry.dataOffset = c.fixed<uint32_t>();
+            entry.dataSize = c.fixed<uint32_t>();
+        }
+        dataStart_ = data_.size() - c.remaining();
+
+        for (const auto &entry : entries_) {
+            if (static_cast<uint64_t>(entry.dataOffset) + entry.dataSize > c.remaining()) {
+                entries_.clear();
+                return false;
+            }
+        }
+    } catch (const std::out_of_range &) {
+        entries_.clear();
+        return false;
+    }
+    return true;
+}
+
+const TrackIndexEntry *TrackIndexReader::find(uint32_t mmsi) const
+{
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), mmsi,
+        [](const TrackIndexEntry &entry, uint32_t id) { return entry.mmsi < id; });
+    return (it != entries_.end() && it->mmsi == mmsi) ? &*it : nullptr;
+}
+
+size_t TrackIndexReader::lookup(uint32_t mmsi, int64_t t0, int64_t t1, std::vector<TrackPoint> &out) const
+{
+    const TrackIndexEntry *entry = find(mmsi);
+    if (!entry || entry->maxTimeMs < t0 || entry->minTimeMs > t1) {
+        return 0;
+    }
+
+    return PostingList::decode(reinterpret_cast<const uint8_t *>(data_.data()) + dataStart_ + entry->dataOffset,
+                               entry->dataSize, entry->count, t0, t1, out);
+}
+
+std::vector<std::string> TrackIndexReader::listSegments(const std::string &prefix)
+{
+    return listIndexedSegments(prefix, ".idx");
+}
+
+size_t TrackIndexReader::readTrack(const std::string &prefix, uint32_t mmsi, int64_t t0, int64_t t1,
+                                   const SegmentRecordVisitor &visitor)
+{
+    size_t total = 0;
+    TrackIndexReader index;
+    std::vector<TrackPoint> points;
+
+    for (const auto &segment : listSegments(prefix)) {
+        if (!index.open(segment + ".idx") ||
+            index.maxTimeMs() < t0 || index.minTimeMs() > t1) {
+            continue;
+        }
+
+        points.clear();
+        if (index.lookup(mmsi, t0, t1, points) > 0) {
+            total += readSegmentRecords(segment, index.binarySegment(), points, visitor);
+        }
+    }
+    return total;
+}
+
+} // namespace ais
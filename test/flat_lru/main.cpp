@@ -0,0 +1,79 @@
+#include "flat_lru.h"
+#include "lru.h"
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+// CFlatLRU与CLRU的等价性校验：同一随机操作序列下，两者的返回值、LRU顺序和淘汰计数应完全一致
+int main(int argc, char* argv[])
+{
+    const int operations = argc > 1 ? std::atoi(argv[1]) : 2000000;
+
+    // 容量500、淘汰步长50，键空间2000，保证持续发生容量淘汰
+    CLRU<uint32_t, int> reference(500, 50, 0);
+    CFlatLRU<uint32_t, int> flat(500, 50, 0);
+
+    std::mt19937 rng(1);
+    int mismatches = 0;
+    for (int i = 0; i < operations; ++i) {
+        const uint32_t key = rng() % 2000;
+        switch (rng() % 6) {
+        case 0:
+            reference.Insert(key, i);
+            flat.Insert(key, i);
+            break;
+        case 1:
+            if (reference.Erase(key) != flat.Erase(key)) {
+                mismatches++;
+            }
+            break;
+        case 2: {
+            auto a = reference.Find(key);
+            auto b = flat.Find(key);
+            if (a.first != b.first || (a.first && a.second != b.second)) {
+                mismatches++;
+            }
+            break;
+        }
+        case 3: {
+            auto a = reference.Peek(key);
+            auto b = flat.Peek(key);
+            if (a.first != b.first || (a.first && a.second != b.second)) {
+                mismatches++;
+            }
+            break;
+        }
+        default: {
+            bool a = reference.Upsert(key, [i](int& value) { value += i; });
+            bool b = flat.Upsert(key, [i](int& value) { value += i; });
+            if (a != b) {
+                mismatches++;
+            }
+            break;
+        }
+        }
+
+        if (i % 100000 == 0 && reference.GetKeysByAccessTime() != flat.GetKeysByAccessTime()) {
+            mismatches++;
+        }
+    }
+
+    if (reference.GetKeysByAccessTime() != flat.GetKeysByAccessTime()) {
+        mismatches++;
+    }
+    const auto refStats = reference.GetStats();
+    const auto flatStats = flat.GetStats();
+    if (reference.GetSize() != flat.GetSize() ||
+        refStats.evicted_by_capacity != flatStats.evicted_by_capacity) {
+        mismatches++;
+    }
+
+    std::cout << "Operations: " << operations << std::endl;
+    std::cout << "Size: " << reference.GetSize() << " / " << flat.GetSize() << std::endl;
+    std::cout << "Evicted by capacity: " << refStats.evicted_by_capacity << " / "
+              << flatStats.evicted_by_capacity << std::endl;
+    std::cout << "Mismatches: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}